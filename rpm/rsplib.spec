@@ -160,6 +160,7 @@ to develop your own RSerPool-based clients and servers.
 # NOTE: These files are library-internal files, not to be packaged in the RPM:
 %ghost %{_includedir}/rserpool/asapinstance.h
 %ghost %{_includedir}/rserpool/asapinterthreadmessage.h
+%ghost %{_includedir}/rserpool/bplustree.h
 %ghost %{_includedir}/rserpool/breakdetector.h
 %ghost %{_includedir}/rserpool/componentstatuspackets.h
 %ghost %{_includedir}/rserpool/componentstatusreporter.h
@@ -214,6 +215,7 @@ to develop your own RSerPool-based clients and servers.
 %ghost %{_includedir}/rserpool/sessioncontrol.h
 %ghost %{_includedir}/rserpool/sessionstorage.h
 %ghost %{_includedir}/rserpool/simpleredblacktree.h
+%ghost %{_includedir}/rserpool/slaballocator.h
 %ghost %{_includedir}/rserpool/sockaddrunion.h
 %ghost %{_includedir}/rserpool/stringutilities.h
 %ghost %{_includedir}/rserpool/tdtypes.h
@@ -222,6 +224,7 @@ to develop your own RSerPool-based clients and servers.
 %ghost %{_includedir}/rserpool/timer.h
 %ghost %{_includedir}/rserpool/timestamphashtable.h
 %ghost %{_includedir}/rserpool/timeutilities.h
+%ghost %{_includedir}/rserpool/timingwheel.h
 %ghost %{_includedir}/rserpool/transportaddressblock.h
 
 
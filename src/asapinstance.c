@@ -42,6 +42,7 @@
 #include "asapinterthreadmessage.h"
 #include "timeutilities.h"
 #include "netutilities.h"
+#include "randomizer.h"
 
 #include <ext_socket.h>
 
@@ -65,6 +66,13 @@ static void asapInstanceDisconnectFromRegistrar(
 static void asapInstanceHandleRegistrarTimeout(struct Dispatcher* dispatcher,
                                                struct Timer*      timer,
                                                void*              userData);
+static void asapInstanceScheduleCacheRefresh(
+               struct ASAPInstance*                     asapInstance,
+               struct PoolHandle*                       poolHandle,
+               struct ST_CLASS(PoolElementNode)* const* poolElementNodeArray,
+               const size_t                             poolElementNodes);
+static void asapInstanceReleaseCacheSnapshot(struct ASAPInstance*      asapInstance,
+                                             struct ASAPCacheSnapshot* snapshot);
 
 
 /* ###### Constructor #################################################### */
@@ -76,6 +84,7 @@ struct ASAPInstance* asapInstanceNew(struct Dispatcher*          dispatcher,
    struct ASAPInstance*        asapInstance = NULL;
    struct sctp_event_subscribe sctpEvents;
    int                         autoCloseTimeout;
+   size_t                      i;
 
    if(dispatcher != NULL) {
       asapInstance = (struct ASAPInstance*)malloc(sizeof(struct ASAPInstance));
@@ -88,6 +97,18 @@ struct ASAPInstance* asapInstanceNew(struct Dispatcher*          dispatcher,
          asapInstance->MainLoopThread               = 0;
          asapInstance->MainLoopShutdown             = false;
          asapInstance->LastAITM                     = NULL;
+         asapInstance->RegistrarOutstandingRequests = 0;
+         memset(&asapInstance->Statistics, 0, sizeof(asapInstance->Statistics));
+         threadSignalNew(&asapInstance->PendingHandleResolutionSignal);
+         asapInstance->PendingHandleResolutions     = NULL;
+         asapInstance->NextCacheRefreshTimeStamp    = 0;
+         for(i = 0;i < ASAP_CACHE_SNAPSHOT_SLOTS;i++) {
+            pthread_mutex_init(&asapInstance->CacheSnapshotTable[i].Mutex, NULL);
+            asapInstance->CacheSnapshotTable[i].InUse     = false;
+            asapInstance->CacheSnapshotTable[i].Reclaimed = false;
+            asapInstance->CacheSnapshotTable[i].Snapshot  = NULL;
+            atomic_init(&asapInstance->CacheSnapshotTable[i].Rotation, 0);
+         }
          asapInstance->RegistrarMessageBuffer       = NULL;
          asapInstance->RegistrarHuntMessageBuffer   = NULL;
          asapInstance->RegistrarSet                 = NULL;
@@ -222,6 +243,7 @@ bool asapInstanceStartThread(struct ASAPInstance* asapInstance)
 void asapInstanceDelete(struct ASAPInstance* asapInstance)
 {
    struct ASAPInterThreadMessage* aitm;
+   size_t                         i;
 
    if(asapInstance) {
       if(asapInstance->MainLoopThread != 0) {
@@ -244,21 +266,67 @@ void asapInstanceDelete(struct ASAPInstance* asapInstance)
          fdCallbackDelete(&asapInstance->RegistrarHuntFDCallback);
          ext_close(asapInstance->RegistrarHuntSocket);
       }
+      LOG_VERBOSE2
+      fprintf(stdlog, "Registrar requests: sent=%llu, responses=%llu, mismatched=%llu\n",
+              asapInstance->Statistics.RequestCount,
+              asapInstance->Statistics.ResponseCount,
+              asapInstance->Statistics.MismatchedResponseCount);
+      fprintf(stdlog, "Registrar request window: size=%u, max. outstanding=%u, stalls=%llu\n",
+              (unsigned int)asapInstance->RegistrarMaxOutstandingRequests,
+              (unsigned int)asapInstance->Statistics.MaxOutstandingRequests,
+              asapInstance->Statistics.WindowFullCount);
+      fprintf(stdlog, "Registrar request delays: queuing avg=%lluus max=%lluus, response avg=%lluus max=%lluus\n",
+              asapInstance->Statistics.TotalQueuingDelay / max(1, asapInstance->Statistics.RequestCount),
+              asapInstance->Statistics.MaxQueuingDelay,
+              asapInstance->Statistics.TotalResponseDelay / max(1, asapInstance->Statistics.ResponseCount),
+              asapInstance->Statistics.MaxResponseDelay);
+      fprintf(stdlog, "Handle resolutions at registrar: requested=%llu, coalesced=%llu\n",
+              asapInstance->Statistics.HandleResolutionCount,
+              asapInstance->Statistics.CoalescedResolutionCount);
+      fprintf(stdlog, "Cache refreshes: scheduled=%llu, rate-limited=%llu\n",
+              asapInstance->Statistics.CacheRefreshCount,
+              asapInstance->Statistics.RateLimitedCacheRefreshCount);
+      fprintf(stdlog, "Main loop messages: heap=%llu, pool=%llu, returned by other threads=%llu\n",
+              asapInstance->Statistics.MainLoopMessagePool.HeapAllocations,
+              asapInstance->Statistics.MainLoopMessagePool.PoolAllocations,
+              asapInstance->Statistics.MainLoopMessagePool.RemoteReturns);
+      LOG_END
+      LOG_VERBOSE3
+      fputs("Pool user cache allocations:\n", stdlog);
+      ST_CLASS(poolHandlespaceManagementPrintAllocatorStatistics)(&asapInstance->Cache, stdlog);
+      LOG_END
       ST_CLASS(poolHandlespaceManagementDelete)(&asapInstance->OwnPoolElements);
       ST_CLASS(poolHandlespaceManagementDelete)(&asapInstance->Cache);
+      for(i = 0;i < ASAP_CACHE_SNAPSHOT_SLOTS;i++) {
+         if(asapInstance->CacheSnapshotTable[i].Snapshot) {
+            CHECK(asapInstance->CacheSnapshotTable[i].Snapshot->ReferenceCount == 1);
+            asapInstanceReleaseCacheSnapshot(asapInstance,
+                                             asapInstance->CacheSnapshotTable[i].Snapshot);
+         }
+         pthread_mutex_destroy(&asapInstance->CacheSnapshotTable[i].Mutex);
+      }
       if(asapInstance->RegistrarSet) {
          registrarTableDelete(asapInstance->RegistrarSet);
          asapInstance->RegistrarSet = NULL;
       }
       timerDelete(&asapInstance->RegistrarTimeoutTimer);
 
-      /* There may still be AITM messages queued. Remove them first. */
+      /* There may still be AITM messages queued. Remove them first.
+         Asynchronous requests still get their completion callback. */
       aitm = (struct ASAPInterThreadMessage*)interThreadMessagePortDequeue(&asapInstance->MainLoopPort);
       while(aitm) {
-         asapInterThreadMessageDelete(aitm);
+         if(aitm->CompletionCallback) {
+            aitm->Error = RSPERR_NO_REGISTRAR;
+            aitm->CompletionCallback(aitm);
+         }
+         else {
+            asapInterThreadMessageDelete(aitm);
+         }
          aitm = (struct ASAPInterThreadMessage*)interThreadMessagePortDequeue(&asapInstance->MainLoopPort);
       }
       interThreadMessagePortDelete(&asapInstance->MainLoopPort);
+      CHECK(asapInstance->PendingHandleResolutions == NULL);
+      threadSignalDelete(&asapInstance->PendingHandleResolutionSignal);
 
       if(asapInstance->RegistrarMessageBuffer) {
          messageBufferDelete(asapInstance->RegistrarMessageBuffer);
@@ -285,6 +353,12 @@ static void asapInstanceConfigure(struct ASAPInstance* asapInstance,
                                                                               ASAP_DEFAULT_REGISTRAR_REQUEST_TIMEOUT);
    asapInstance->RegistrarResponseTimeout = (unsigned long long)tagListGetData(tags, TAG_RspLib_RegistrarResponseTimeout,
                                                                                ASAP_DEFAULT_REGISTRAR_RESPONSE_TIMEOUT);
+   asapInstance->RegistrarMaxOutstandingRequests = max(1, tagListGetData(tags, TAG_RspLib_RegistrarMaxOutstandingRequests,
+                                                                         ASAP_DEFAULT_REGISTRAR_MAX_OUTSTANDING_REQUESTS));
+   asapInstance->CacheRefreshThreshold = min(100, tagListGetData(tags, TAG_RspLib_CacheRefreshThreshold,
+                                                                 ASAP_DEFAULT_CACHE_REFRESH_THRESHOLD));
+   asapInstance->CacheRefreshRate = max(1, tagListGetData(tags, TAG_RspLib_CacheRefreshRate,
+                                                          ASAP_DEFAULT_CACHE_REFRESH_RATE));
 
 
    /* ====== Show results =================================================== */
@@ -293,6 +367,9 @@ static void asapInstanceConfigure(struct ASAPInstance* asapInstance,
    fprintf(stdlog, "registrar.request.timeout     = %lluus\n", asapInstance->RegistrarRequestTimeout);
    fprintf(stdlog, "registrar.response.timeout    = %lluus\n", asapInstance->RegistrarResponseTimeout);
    fprintf(stdlog, "registrar.request.maxtrials   = %u\n",     (unsigned int)asapInstance->RegistrarRequestMaxTrials);
+   fprintf(stdlog, "registrar.max.outstanding     = %u\n",     (unsigned int)asapInstance->RegistrarMaxOutstandingRequests);
+   fprintf(stdlog, "cache.refresh.threshold       = %u%%\n",   asapInstance->CacheRefreshThreshold);
+   fprintf(stdlog, "cache.refresh.rate            = %u/s\n",   asapInstance->CacheRefreshRate);
    LOG_END
 }
 
@@ -338,7 +415,8 @@ static bool asapInstanceConnectToRegistrar(struct ASAPInstance* asapInstance,
                     FDCE_Read|FDCE_Exception,
                     asapInstanceHandleRegistrarConnectionEvent,
                     (void*)asapInstance);
-      asapInstance->LastAITM = NULL; /* Send requests again! */
+      asapInstance->LastAITM                     = NULL; /* Send requests again! */
+      asapInstance->RegistrarOutstandingRequests = 0;
 
       LOG_NOTE
       fprintf(stdlog, "Connected to registrar $%08x\n", asapInstance->RegistrarIdentifier);
@@ -381,6 +459,7 @@ static void asapInstanceDisconnectFromRegistrar(struct ASAPInstance* asapInstanc
       asapInstance->RegistrarConnectionTimeStamp = 0;
       asapInstance->RegistrarIdentifier          = UNDEFINED_REGISTRAR_IDENTIFIER;
       asapInstance->LastAITM                     = NULL; /* Send requests again! */
+      asapInstance->RegistrarOutstandingRequests = 0;
 
       LOG_ACTION
       fputs("Disconnected from registrar\n", stdlog);
@@ -467,6 +546,25 @@ static unsigned int asapInstanceDoIO(struct ASAPInstance*     asapInstance,
 }
 
 
+/* ###### Complete request ############################################### */
+static void asapInstanceCompleteAITM(struct ASAPInstance*           asapInstance,
+                                     struct ASAPInterThreadMessage* aitm)
+{
+   if(aitm->Node.ReplyPort) {
+       /* Reply to requesting thread, if reply is desired. */
+      interThreadMessageReply(&aitm->Node);
+   }
+   else if(aitm->CompletionCallback) {
+      /* Asynchronous request: the callback takes over the message. */
+      aitm->CompletionCallback(aitm);
+   }
+   else {
+      /* Sender is not interested in result, throw it away. */
+      asapInterThreadMessageDelete(aitm);
+   }
+}
+
+
 /* ###### Register pool element ########################################## */
 unsigned int asapInstanceRegister(struct ASAPInstance*              asapInstance,
                                   struct PoolHandle*                poolHandle,
@@ -646,7 +744,7 @@ unsigned int asapInstanceDeregister(struct ASAPInstance*            asapInstance
       LOG_END
    }
    else {
-      message = rserpoolMessageNew(NULL, ASAP_BUFFER_SIZE);
+      message = rserpoolMessageNew(NULL, RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE);
       if(message != NULL) {
          message->Type       = AHT_DEREGISTRATION;
          message->Flags      = 0x00;
@@ -688,6 +786,530 @@ unsigned int asapInstanceDeregister(struct ASAPInstance*            asapInstance
 }
 
 
+/* ###### Complete load update ########################################### */
+static void asapInstanceLoadUpdateCompleted(struct ASAPInterThreadMessage* aitm)
+{
+   struct ASAPInstance*              asapInstance = (struct ASAPInstance*)aitm->CompletionUserData;
+   struct ST_CLASS(PoolElementNode)* poolElementNode;
+   unsigned int                      result       = aitm->Error;
+
+   /* ====== Check registrar's answer ==================================== */
+   if(result == RSPERR_OKAY) {
+      if( (aitm->Response == NULL) ||
+          (aitm->Response->Type != AHT_REGISTRATION_RESPONSE) ) {
+         /* The registrar does not support Load Update */
+         result = RSPERR_UNRECOGNIZED_MESSAGE;
+      }
+      else if( (aitm->Response->Error != RSPERR_OKAY) ||
+               (aitm->Response->Flags & AHF_REGISTRATION_REJECT) ) {
+         result = (aitm->Response->Error != RSPERR_OKAY) ?
+                     (unsigned int)aitm->Response->Error : RSPERR_NOT_FOUND;
+      }
+   }
+
+   /* ====== Fall back to reregistration ================================= */
+   /* Without any registrar, a reregistration cannot succeed either. The
+      next regular reregistration will then carry the new settings. */
+   if( (result != RSPERR_OKAY) && (result != RSPERR_NO_REGISTRAR) ) {
+      LOG_WARNING
+      fprintf(stdlog, "Load update for pool element $%08x of pool ",
+              aitm->Request->Identifier);
+      poolHandlePrint(&aitm->Request->Handle, stdlog);
+      fputs(" failed: ", stdlog);
+      rserpoolErrorPrint(result, stdlog);
+      fputs(" -> reregistering it\n", stdlog);
+      LOG_END
+
+      dispatcherLock(asapInstance->StateMachine);
+      poolElementNode = ST_CLASS(poolHandlespaceManagementFindPoolElement)(
+                           &asapInstance->OwnPoolElements,
+                           &aitm->Request->Handle,
+                           aitm->Request->Identifier);
+      if(poolElementNode != NULL) {
+         asapInstanceRegister(asapInstance, &aitm->Request->Handle,
+                              poolElementNode, false, false);
+      }
+      dispatcherUnlock(asapInstance->StateMachine);
+   }
+
+   asapInterThreadMessageDelete(aitm);
+}
+
+
+/* ###### Update pool element's policy information ####################### */
+unsigned int asapInstanceUpdateLoad(struct ASAPInstance*             asapInstance,
+                                    struct PoolHandle*               poolHandle,
+                                    const PoolElementIdentifierType  identifier,
+                                    const struct PoolPolicySettings* policySettings)
+{
+   struct ASAPInterThreadMessage*    aitm;
+   struct RSerPoolMessage*           message;
+   struct ST_CLASS(PoolElementNode)* poolElementNode;
+   unsigned int                      result;
+
+   LOG_VERBOSE2
+   fprintf(stdlog, "Updating load of pool element $%08x of pool ", identifier);
+   poolHandlePrint(poolHandle, stdlog);
+   fputs(": ", stdlog);
+   poolPolicySettingsPrint(policySettings, stdlog);
+   fputs("\n", stdlog);
+   LOG_END
+
+   /* ====== Update own pool element ===================================== */
+   /* A later reregistration, e.g. after failover to another registrar,
+      has to use the updated settings. */
+   dispatcherLock(asapInstance->StateMachine);
+   poolElementNode = ST_CLASS(poolHandlespaceManagementFindPoolElement)(
+                        &asapInstance->OwnPoolElements,
+                        poolHandle,
+                        identifier);
+   if(poolElementNode != NULL) {
+      result = ST_CLASS(poolHandlespaceManagementUpdatePoolElementPolicySettings)(
+                  &asapInstance->OwnPoolElements,
+                  poolElementNode,
+                  policySettings,
+                  getMicroTime());
+   }
+   else {
+      result = RSPERR_NOT_FOUND;
+   }
+   dispatcherUnlock(asapInstance->StateMachine);
+
+   /* ====== Send load update ============================================ */
+   if(result == RSPERR_OKAY) {
+      message = rserpoolMessageNew(NULL, RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE);
+      if(message != NULL) {
+         message->Type           = AHT_LOAD_UPDATE;
+         message->Flags          = 0x00;
+         message->Handle         = *poolHandle;
+         message->Identifier     = identifier;
+         message->PolicySettings = *policySettings;
+         aitm = asapInterThreadMessageNew(message, true);
+         if(aitm != NULL) {
+            aitm->CompletionCallback = asapInstanceLoadUpdateCompleted;
+            aitm->CompletionUserData = asapInstance;
+            interThreadMessagePortEnqueue(&asapInstance->MainLoopPort, &aitm->Node, NULL);
+            asapInstanceNotifyMainLoop(asapInstance);
+         }
+         else {
+            rserpoolMessageDelete(message);
+            result = RSPERR_OUT_OF_MEMORY;
+         }
+      }
+      else {
+         result = RSPERR_OUT_OF_MEMORY;
+      }
+   }
+
+   LOG_VERBOSE2
+   fputs("Load update result is: ", stdlog);
+   rserpoolErrorPrint(result, stdlog);
+   fputs("\n", stdlog);
+   LOG_END
+   return(result);
+}
+
+
+/* ###### Find slot of a pool's cache snapshot ########################### */
+/* Creating a slot requires the StateMachine lock! */
+static struct ASAPCacheSnapshotSlot* asapInstanceFindCacheSnapshotSlot(
+                                        struct ASAPInstance*     asapInstance,
+                                        const struct PoolHandle* poolHandle,
+                                        const bool               create)
+{
+   const size_t                  start         = poolHandleHash(poolHandle) % ASAP_CACHE_SNAPSHOT_SLOTS;
+   struct ASAPCacheSnapshotSlot* reclaimedSlot = NULL;
+   struct ASAPCacheSnapshotSlot* slot;
+   bool                          found;
+   size_t                        i;
+
+   for(i = 0;i < ASAP_CACHE_SNAPSHOT_SLOTS;i++) {
+      slot = &asapInstance->CacheSnapshotTable[(start + i) % ASAP_CACHE_SNAPSHOT_SLOTS];
+      pthread_mutex_lock(&slot->Mutex);
+      if(!slot->InUse) {
+         if((create) && (reclaimedSlot == NULL)) {
+            slot->InUse  = true;
+            slot->Handle = *poolHandle;
+         }
+         pthread_mutex_unlock(&slot->Mutex);
+         if(!create) {
+            return(NULL);
+         }
+         break;
+      }
+      if(slot->Reclaimed) {
+         /* Reclaimed slots continue the probe sequence */
+         if(reclaimedSlot == NULL) {
+            reclaimedSlot = slot;
+         }
+         found = false;
+      }
+      else {
+         found = (poolHandleComparison(&slot->Handle, poolHandle) == 0);
+      }
+      pthread_mutex_unlock(&slot->Mutex);
+      if(found) {
+         return(slot);
+      }
+   }
+   if(!create) {
+      return(NULL);
+   }
+
+   /* ====== Reuse the first reclaimed slot of the probe sequence ======== */
+   if(reclaimedSlot != NULL) {
+      pthread_mutex_lock(&reclaimedSlot->Mutex);
+      reclaimedSlot->Reclaimed = false;
+      reclaimedSlot->Handle    = *poolHandle;
+      pthread_mutex_unlock(&reclaimedSlot->Mutex);
+      return(reclaimedSlot);
+   }
+   return((i < ASAP_CACHE_SNAPSHOT_SLOTS) ? slot : NULL);
+}
+
+
+/* ###### Reclaim slot of a pool which has left the cache ################ */
+static void asapInstanceReclaimCacheSnapshotSlot(struct ASAPInstance*          asapInstance,
+                                                 struct ASAPCacheSnapshotSlot* slot)
+{
+   struct ASAPCacheSnapshot* oldSnapshot;
+
+   pthread_mutex_lock(&slot->Mutex);
+   oldSnapshot     = slot->Snapshot;
+   slot->Snapshot  = NULL;
+   slot->Reclaimed = true;
+   pthread_mutex_unlock(&slot->Mutex);
+   if(oldSnapshot != NULL) {
+      asapInstanceReleaseCacheSnapshot(asapInstance, oldSnapshot);
+   }
+}
+
+
+/* ###### Reclaim slots of all pools which have left the cache ########### */
+/* The caller has to hold the StateMachine lock! */
+static void asapInstanceReclaimCacheSnapshotSlots(struct ASAPInstance* asapInstance)
+{
+   struct ASAPCacheSnapshotSlot* slot;
+   bool                          inCache;
+   size_t                        i;
+
+   for(i = 0;i < ASAP_CACHE_SNAPSHOT_SLOTS;i++) {
+      slot = &asapInstance->CacheSnapshotTable[i];
+      /* Only the StateMachine lock holder modifies InUse, Reclaimed and
+         Handle, so they may be read here without the slot's mutex. */
+      if((slot->InUse) && (!slot->Reclaimed)) {
+         inCache = (ST_CLASS(poolHandlespaceNodeFindPoolNode)(
+                       &asapInstance->Cache.Handlespace, &slot->Handle) != NULL);
+         if(!inCache) {
+            asapInstanceReclaimCacheSnapshotSlot(asapInstance, slot);
+         }
+      }
+   }
+}
+
+
+/* ###### Get reference to a pool's cache snapshot ####################### */
+static struct ASAPCacheSnapshot* asapInstanceAcquireCacheSnapshot(
+                                    struct ASAPInstance*     asapInstance,
+                                    const struct PoolHandle* poolHandle)
+{
+   struct ASAPCacheSnapshotSlot* slot;
+   struct ASAPCacheSnapshot*     snapshot = NULL;
+
+   slot = asapInstanceFindCacheSnapshotSlot(asapInstance, poolHandle, false);
+   if(slot != NULL) {
+      pthread_mutex_lock(&slot->Mutex);
+      /* The slot may have been reclaimed and reused for another pool
+         since it has been found */
+      if( (slot->InUse) && (!slot->Reclaimed) &&
+          (poolHandleComparison(&slot->Handle, poolHandle) == 0) ) {
+         snapshot = slot->Snapshot;
+         if(snapshot != NULL) {
+            snapshot->ReferenceCount++;
+         }
+      }
+      pthread_mutex_unlock(&slot->Mutex);
+   }
+   return(snapshot);
+}
+
+
+/* ###### Release reference to a cache snapshot ########################## */
+static void asapInstanceReleaseCacheSnapshot(struct ASAPInstance*      asapInstance,
+                                             struct ASAPCacheSnapshot* snapshot)
+{
+   struct ASAPCacheSnapshotSlot* slot = &asapInstance->CacheSnapshotTable[snapshot->Slot];
+   bool                          unused;
+   size_t                        i;
+
+   pthread_mutex_lock(&slot->Mutex);
+   CHECK(snapshot->ReferenceCount > 0);
+   snapshot->ReferenceCount--;
+   unused = (snapshot->ReferenceCount == 0);
+   if((unused) && (slot->Snapshot == snapshot)) {
+      slot->Snapshot = NULL;
+   }
+   pthread_mutex_unlock(&slot->Mutex);
+
+   if(unused) {
+      for(i = 0;i < snapshot->Entries;i++) {
+         transportAddressBlockDelete(snapshot->EntryArray[i].UserTransport);
+         free(snapshot->EntryArray[i].UserTransport);
+      }
+      free(snapshot);
+   }
+}
+
+
+/* ###### Create snapshot of a pool's cache entries ###################### */
+static struct ASAPCacheSnapshot* asapInstanceNewCacheSnapshot(
+                                    struct ASAPInstance*     asapInstance,
+                                    const struct PoolHandle* poolHandle,
+                                    const size_t             slot)
+{
+   struct ST_CLASS(PoolNode)*        poolNode;
+   struct ST_CLASS(PoolElementNode)* poolElementNode;
+   struct ST_CLASS(PoolElementNode)  candidate;
+   struct ASAPCacheSnapshot*         snapshot;
+   size_t                            entries;
+
+   poolNode = ST_CLASS(poolHandlespaceNodeFindPoolNode)(
+                 &asapInstance->Cache.Handlespace, poolHandle);
+   if(poolNode == NULL) {
+      return(NULL);
+   }
+
+   /* ====== Check, whether selections keep the pool's order ============= */
+   /* Selections on a snapshot are not written back to the Cache. Sorting
+      order policies updating the PEs on selection (e.g. the stride pass of
+      WeightedRoundRobin or the degradation of the LeastUsedDegradation
+      variants) therefore have to use the Cache itself. */
+   if( (poolNode->Policy->SelectionFunction == ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder)) &&
+       ( (poolNode->Policy->UpdatePoolElementNodeFunction != NULL) ||
+         (poolNode->Policy->PrepareSelectionFunction != NULL) ) ) {
+      return(NULL);
+   }
+
+   entries  = ST_CLASS(poolNodeGetPoolElementNodes)(poolNode);
+   snapshot = (struct ASAPCacheSnapshot*)malloc(sizeof(struct ASAPCacheSnapshot) +
+                                                entries * sizeof(struct ST_CLASS(PoolElementNode)));
+   if(snapshot == NULL) {
+      return(NULL);
+   }
+   snapshot->Slot           = slot;
+   snapshot->ReferenceCount = 1;
+   snapshot->Policy         = poolNode->Policy;
+   snapshot->RotationSize   = 0;
+   snapshot->Entries        = 0;
+
+   /* ====== Copy entries in selection order ============================= */
+   poolElementNode = ST_CLASS(poolNodeGetFirstPoolElementNodeFromSelection)(poolNode);
+   while(poolElementNode != NULL) {
+      snapshot->EntryArray[snapshot->Entries]                      = *poolElementNode;
+      snapshot->EntryArray[snapshot->Entries].OwnerPoolNode        = NULL;
+      snapshot->EntryArray[snapshot->Entries].RegistratorTransport = NULL;
+      snapshot->EntryArray[snapshot->Entries].UserData             = NULL;
+      snapshot->EntryArray[snapshot->Entries].EncodedParameter     = NULL;
+      snapshot->EntryArray[snapshot->Entries].EncodedParameterSize = 0;
+      snapshot->EntryArray[snapshot->Entries].UserTransport        =
+         transportAddressBlockDuplicate(poolElementNode->UserTransport);
+      if(snapshot->EntryArray[snapshot->Entries].UserTransport == NULL) {
+         asapInstanceReleaseCacheSnapshot(asapInstance, snapshot);
+         return(NULL);
+      }
+      snapshot->Entries++;
+      poolElementNode = ST_CLASS(poolNodeGetNextPoolElementNodeFromSelection)(poolNode, poolElementNode);
+   }
+   CHECK(snapshot->Entries == entries);
+
+   /* ====== Find leading entries the policy considers equivalent ======== */
+   /* Their order only depends on the sequence number, i.e. it would be
+      rotated by the selections. */
+   if(snapshot->Entries > 0) {
+      snapshot->RotationSize = 1;
+      while(snapshot->RotationSize < snapshot->Entries) {
+         candidate           = snapshot->EntryArray[snapshot->RotationSize];
+         candidate.SeqNumber = snapshot->EntryArray[0].SeqNumber;
+         if(snapshot->Policy->ComparisonFunction(&snapshot->EntryArray[0], &candidate) != 0) {
+            break;
+         }
+         snapshot->RotationSize++;
+      }
+   }
+   return(snapshot);
+}
+
+
+/* ###### Replace snapshot of a pool's cache entries ##################### */
+static void asapInstancePublishCacheSnapshot(struct ASAPInstance*     asapInstance,
+                                             const struct PoolHandle* poolHandle)
+{
+   struct ASAPCacheSnapshotSlot* slot;
+   struct ASAPCacheSnapshot*     snapshot;
+   struct ASAPCacheSnapshot*     oldSnapshot;
+
+   /* ====== Pool has left the cache -> reclaim its slot ================= */
+   if(ST_CLASS(poolHandlespaceNodeFindPoolNode)(&asapInstance->Cache.Handlespace,
+                                                poolHandle) == NULL) {
+      slot = asapInstanceFindCacheSnapshotSlot(asapInstance, poolHandle, false);
+      if(slot != NULL) {
+         asapInstanceReclaimCacheSnapshotSlot(asapInstance, slot);
+      }
+      return;
+   }
+
+   slot = asapInstanceFindCacheSnapshotSlot(asapInstance, poolHandle, true);
+   if(slot == NULL) {
+      /* The table is full: lookups for this pool use the Cache itself. */
+      return;
+   }
+
+   /* Without snapshot (pool gone, policy not suitable or out of memory),
+      lookups fall back to the Cache itself. */
+   snapshot = asapInstanceNewCacheSnapshot(asapInstance, poolHandle,
+                                           slot - asapInstance->CacheSnapshotTable);
+
+   pthread_mutex_lock(&slot->Mutex);
+   oldSnapshot    = slot->Snapshot;
+   slot->Snapshot = snapshot;
+   pthread_mutex_unlock(&slot->Mutex);
+   if(oldSnapshot != NULL) {
+      asapInstanceReleaseCacheSnapshot(asapInstance, oldSnapshot);
+   }
+}
+
+
+/* ###### Select pool elements from cache snapshot ####################### */
+static size_t asapInstanceSelectFromCacheSnapshot(
+                 struct ASAPCacheSnapshotSlot*      slot,
+                 const struct ASAPCacheSnapshot*    snapshot,
+                 struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+                 const size_t                       maxPoolElementNodes)
+{
+   struct ST_CLASS(PoolElementNode)* candidateArray[ASAP_CACHE_SNAPSHOT_MAX_CANDIDATES];
+   const unsigned long long          now        = getMicroTime();
+   size_t                            candidates = 0;
+   size_t                            leading    = 0;
+   size_t                            selected   = 0;
+   unsigned long long                valueSum;
+   unsigned long long                value;
+   size_t                            start;
+   size_t                            i, j;
+
+   /* ====== Get entries which have not expired yet ====================== */
+   for(i = 0;(i < snapshot->Entries) && (candidates < ASAP_CACHE_SNAPSHOT_MAX_CANDIDATES);i++) {
+      if( (snapshot->EntryArray[i].TimerCode == PENT_EXPIRY) &&
+          (snapshot->EntryArray[i].TimerTimeStamp <= now) ) {
+         continue;
+      }
+      candidateArray[candidates++] = (struct ST_CLASS(PoolElementNode)*)&snapshot->EntryArray[i];
+      if(i < snapshot->RotationSize) {
+         leading++;
+      }
+   }
+
+   /* ====== Random policies ============================================= */
+   if( (snapshot->Policy->SelectionFunction == ST_CLASS(poolPolicySelectPoolElementNodesByValueTree)) ||
+       (snapshot->Policy->SelectionFunction == ST_CLASS(poolPolicySelectPoolElementNodesByWeightTree)) ) {
+      while((selected < maxPoolElementNodes) && (candidates > 0)) {
+         valueSum = 0;
+         for(i = 0;i < candidates;i++) {
+            valueSum += candidateArray[i]->PoolElementSelectionStorageNode.Value;
+         }
+         if(valueSum < 1) {
+            break;
+         }
+         value = random64() % valueSum;
+         for(j = 0;j < candidates - 1;j++) {
+            if(value < candidateArray[j]->PoolElementSelectionStorageNode.Value) {
+               break;
+            }
+            value -= candidateArray[j]->PoolElementSelectionStorageNode.Value;
+         }
+         poolElementNodeArray[selected++] = candidateArray[j];
+         candidateArray[j] = candidateArray[--candidates];
+      }
+   }
+
+   /* ====== Power of choices ============================================ */
+   else if(snapshot->Policy->SelectionFunction == ST_CLASS(poolPolicySelectPoolElementNodesByPowerOfChoices)) {
+      while((selected < maxPoolElementNodes) && (candidates > 0)) {
+         i = random64() % candidates;
+         j = random64() % candidates;
+         if(snapshot->Policy->ComparisonFunction(candidateArray[j], candidateArray[i]) < 0) {
+            i = j;
+         }
+         poolElementNodeArray[selected++] = candidateArray[i];
+         candidateArray[i] = candidateArray[--candidates];
+      }
+   }
+
+   /* ====== Sorting order policies ====================================== */
+   /* The selections rotate the leading equivalent entries of the pool,
+      like the selection updates of the Cache would do. */
+   else {
+      start = (leading > 0) ?
+                 (atomic_fetch_add_explicit(&slot->Rotation, 1, memory_order_relaxed) % leading) : 0;
+      for(i = 0;(i < candidates) && (selected < maxPoolElementNodes);i++) {
+         j = (i < leading) ? ((start + i) % leading) : i;
+         poolElementNodeArray[selected++] = candidateArray[j];
+      }
+   }
+
+   return(selected);
+}
+
+
+/* ###### Do name lookup from cache snapshot ############################# */
+static unsigned int asapInstanceHandleResolutionFromCacheSnapshot(
+                       struct ASAPInstance*               asapInstance,
+                       struct PoolHandle*                 poolHandle,
+                       void**                             nodePtrArray,
+                       struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+                       size_t*                            poolElementNodes,
+                       unsigned int                       (*convertFunction)(const struct ST_CLASS(PoolElementNode)* poolElementNode,
+                                                                             void*                                   ptr))
+{
+   struct ASAPCacheSnapshot* snapshot;
+   unsigned int              result;
+   size_t                    i;
+
+   snapshot = asapInstanceAcquireCacheSnapshot(asapInstance, poolHandle);
+   if(snapshot == NULL) {
+      return(RSPERR_NOT_FOUND);
+   }
+
+   *poolElementNodes = asapInstanceSelectFromCacheSnapshot(&asapInstance->CacheSnapshotTable[snapshot->Slot],
+                                                           snapshot, poolElementNodeArray,
+                                                           *poolElementNodes);
+   if(*poolElementNodes > 0) {
+      result = RSPERR_OKAY;
+      for(i = 0;i < *poolElementNodes;i++) {
+          if(convertFunction(poolElementNodeArray[i], &nodePtrArray[i]) != 0) {
+             result = RSPERR_OUT_OF_MEMORY;
+          }
+      }
+      if(result != RSPERR_OKAY) {
+         for(i = 0;i < *poolElementNodes;i++) {
+            free(nodePtrArray[i]);
+            nodePtrArray[i] = 0;
+         }
+         *poolElementNodes = 0;
+      }
+      else if(asapInstance->CacheRefreshThreshold > 0) {
+         asapInstanceScheduleCacheRefresh(asapInstance, poolHandle,
+                                          poolElementNodeArray, *poolElementNodes);
+      }
+   }
+   else {
+      result = RSPERR_NOT_FOUND;
+   }
+
+   asapInstanceReleaseCacheSnapshot(asapInstance, snapshot);
+   return(result);
+}
+
+
 /* ###### Do name lookup from cache ###################################### */
 static unsigned int asapInstanceHandleResolutionFromCache(
                        struct ASAPInstance*               asapInstance,
@@ -702,6 +1324,19 @@ static unsigned int asapInstanceHandleResolutionFromCache(
    unsigned int result;
    size_t       i;
 
+   /* ====== Application lookups try the cache snapshot first ============ */
+   if(purgeOutOfDateElements) {
+      const size_t originalPoolElementNodes = *poolElementNodes;
+      result = asapInstanceHandleResolutionFromCacheSnapshot(
+                  asapInstance, poolHandle,
+                  nodePtrArray, poolElementNodeArray,
+                  poolElementNodes, convertFunction);
+      if(result != RSPERR_NOT_FOUND) {
+         return(result);
+      }
+      *poolElementNodes = originalPoolElementNodes;
+   }
+
    dispatcherLock(asapInstance->StateMachine);
 
    LOG_VERBOSE
@@ -719,6 +1354,9 @@ static unsigned int asapInstanceHandleResolutionFromCache(
       LOG_VERBOSE
       fprintf(stdlog, "Purged %u out-of-date elements\n", (unsigned int)i);
       LOG_END
+      if(i > 0) {
+         asapInstanceReclaimCacheSnapshotSlots(asapInstance);
+      }
    }
 
    if(ST_CLASS(poolHandlespaceManagementHandleResolution)(
@@ -752,6 +1390,13 @@ static unsigned int asapInstanceHandleResolutionFromCache(
          }
          *poolElementNodes = 0;
       }
+
+      /* ====== Refresh-ahead for application lookups ==================== */
+      else if( (purgeOutOfDateElements) &&
+               (asapInstance->CacheRefreshThreshold > 0) ) {
+         asapInstanceScheduleCacheRefresh(asapInstance, poolHandle,
+                                          poolElementNodeArray, *poolElementNodes);
+      }
    }
    else {
       result = RSPERR_NOT_FOUND;
@@ -762,6 +1407,124 @@ static unsigned int asapInstanceHandleResolutionFromCache(
 }
 
 
+/* ###### Propagate handle resolution response into cache ################ */
+static void asapInstanceUpdateCache(struct ASAPInstance*     asapInstance,
+                                    struct PoolHandle*       poolHandle,
+                                    struct RSerPoolMessage*  response,
+                                    const unsigned long long cacheElementTimeout)
+{
+   struct ST_CLASS(PoolElementNode)* newPoolElementNode;
+   unsigned int                      result;
+   size_t                            i;
+
+   dispatcherLock(asapInstance->StateMachine);
+   for(i = 0;i < response->PoolElementPtrArraySize;i++) {
+      LOG_VERBOSE2
+      fputs("Adding pool element to cache: ", stdlog);
+      ST_CLASS(poolElementNodePrint)(response->PoolElementPtrArray[i], stdlog, PENPO_FULL);
+      fputs("\n", stdlog);
+      LOG_END
+      result = ST_CLASS(poolHandlespaceManagementRegisterPoolElement)(
+                  &asapInstance->Cache,
+                  poolHandle,
+                  response->PoolElementPtrArray[i]->HomeRegistrarIdentifier,
+                  response->PoolElementPtrArray[i]->Identifier,
+                  response->PoolElementPtrArray[i]->RegistrationLife,
+                  &response->PoolElementPtrArray[i]->PolicySettings,
+                  response->PoolElementPtrArray[i]->UserTransport,
+                  NULL,
+                  -1, 0,
+                  getMicroTime(),
+                  &newPoolElementNode);
+      if(result != RSPERR_OKAY) {
+         LOG_WARNING
+         fputs("Failed to add pool element to cache: ", stdlog);
+         ST_CLASS(poolElementNodePrint)(response->PoolElementPtrArray[i], stdlog, PENPO_FULL);
+         fputs(": ", stdlog);
+         rserpoolErrorPrint(result, stdlog);
+         fputs("\n", stdlog);
+         LOG_END
+      }
+      ST_CLASS(poolHandlespaceManagementRestartPoolElementExpiryTimer)(
+         &asapInstance->Cache,
+         newPoolElementNode,
+         cacheElementTimeout);
+   }
+   asapInstancePublishCacheSnapshot(asapInstance, poolHandle);
+   dispatcherUnlock(asapInstance->StateMachine);
+}
+
+
+/* ###### Handle handle resolution response ############################## */
+static unsigned int asapInstanceHandleResolutionResponse(
+                       struct ASAPInstance*               asapInstance,
+                       struct PoolHandle*                 poolHandle,
+                       struct RSerPoolMessage*            response,
+                       void**                             nodePtrArray,
+                       struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+                       size_t*                            poolElementNodes,
+                       unsigned int                       (*convertFunction)(const struct ST_CLASS(PoolElementNode)* poolElementNode,
+                                                                             void*                                   ptr),
+                       const unsigned long long           cacheElementTimeout)
+{
+   unsigned int result;
+
+   if(response->Error == RSPERR_OKAY) {
+      LOG_VERBOSE
+      fprintf(stdlog, "Got %u elements in handle resolution response\n",
+              (unsigned int)response->PoolElementPtrArraySize);
+      LOG_END
+
+      dispatcherLock(asapInstance->StateMachine);
+
+      /* ====== Propagate results into PU-side cache ===================== */
+      asapInstanceUpdateCache(asapInstance, poolHandle, response,
+                              cacheElementTimeout);
+
+      /* ====== Select PEs from cache ==================================== */
+      result = asapInstanceHandleResolutionFromCache(
+                  asapInstance, poolHandle,
+                  nodePtrArray,
+                  poolElementNodeArray,
+                  poolElementNodes, convertFunction, false);
+
+      dispatcherUnlock(asapInstance->StateMachine);
+      /* ================================================================= */
+
+   }
+   else {
+      LOG_VERBOSE2
+      fprintf(stdlog, "Handle Resolution at registrar for pool ");
+      poolHandlePrint(poolHandle, stdlog);
+      fputs(" failed: ", stdlog);
+      rserpoolErrorPrint(response->Error, stdlog);
+      fputs("\n", stdlog);
+      LOG_END
+      result = response->Error;
+   }
+   return(result);
+}
+
+
+/* ###### Create handle resolution request ############################### */
+static struct RSerPoolMessage* asapInstanceNewHandleResolutionRequest(
+                                  struct PoolHandle*       poolHandle,
+                                  const size_t             poolElementNodes,
+                                  const unsigned long long cacheElementTimeout)
+{
+   struct RSerPoolMessage* message;
+
+   message = rserpoolMessageNew(NULL, RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE);
+   if(message != NULL) {
+      message->Type      = AHT_HANDLE_RESOLUTION;
+      message->Flags     = 0x00;
+      message->Handle    = *poolHandle;
+      message->Addresses = ((poolElementNodes != RSPGETADDRS_MAX) && (cacheElementTimeout > 0)) ? 0 : poolElementNodes;
+   }
+   return(message);
+}
+
+
 /* ###### Do name lookup ################################################# */
 static unsigned int asapInstanceHandleResolutionAtRegistrar(struct ASAPInstance*               asapInstance,
                                                             struct PoolHandle*                 poolHandle,
@@ -772,84 +1535,19 @@ static unsigned int asapInstanceHandleResolutionAtRegistrar(struct ASAPInstance*
                                                                                                                   void*                                   ptr),
                                                             const unsigned long long           cacheElementTimeout)
 {
-   struct ST_CLASS(PoolElementNode)* newPoolElementNode;
-   struct RSerPoolMessage*           message;
-   struct RSerPoolMessage*           response;
-   unsigned int                      result;
-   size_t                            i;
+   struct RSerPoolMessage* message;
+   struct RSerPoolMessage* response;
+   unsigned int            result;
 
-   message = rserpoolMessageNew(NULL, ASAP_BUFFER_SIZE);
+   message = asapInstanceNewHandleResolutionRequest(poolHandle, *poolElementNodes,
+                                                    cacheElementTimeout);
    if(message != NULL) {
-      message->Type      = AHT_HANDLE_RESOLUTION;
-      message->Flags     = 0x00;
-      message->Handle    = *poolHandle;
-      message->Addresses = ((*poolElementNodes != RSPGETADDRS_MAX) && (cacheElementTimeout > 0)) ? 0 : *poolElementNodes;
-
       result = asapInstanceDoIO(asapInstance, message, &response);
       if(result == RSPERR_OKAY) {
-         if(response->Error == RSPERR_OKAY) {
-            LOG_VERBOSE
-            fprintf(stdlog, "Got %u elements in handle resolution response\n",
-                    (unsigned int)response->PoolElementPtrArraySize);
-            LOG_END
-
-            dispatcherLock(asapInstance->StateMachine);
-
-            /* ====== Propagate results into PU-side cache =============== */
-            for(i = 0;i < response->PoolElementPtrArraySize;i++) {
-               LOG_VERBOSE2
-               fputs("Adding pool element to cache: ", stdlog);
-               ST_CLASS(poolElementNodePrint)(response->PoolElementPtrArray[i], stdlog, PENPO_FULL);
-               fputs("\n", stdlog);
-               LOG_END
-               result = ST_CLASS(poolHandlespaceManagementRegisterPoolElement)(
-                           &asapInstance->Cache,
-                           poolHandle,
-                           response->PoolElementPtrArray[i]->HomeRegistrarIdentifier,
-                           response->PoolElementPtrArray[i]->Identifier,
-                           response->PoolElementPtrArray[i]->RegistrationLife,
-                           &response->PoolElementPtrArray[i]->PolicySettings,
-                           response->PoolElementPtrArray[i]->UserTransport,
-                           NULL,
-                           -1, 0,
-                           getMicroTime(),
-                           &newPoolElementNode);
-               if(result != RSPERR_OKAY) {
-                  LOG_WARNING
-                  fputs("Failed to add pool element to cache: ", stdlog);
-                  ST_CLASS(poolElementNodePrint)(response->PoolElementPtrArray[i], stdlog, PENPO_FULL);
-                  fputs(": ", stdlog);
-                  rserpoolErrorPrint(result, stdlog);
-                  fputs("\n", stdlog);
-                  LOG_END
-               }
-               ST_CLASS(poolHandlespaceManagementRestartPoolElementExpiryTimer)(
-                  &asapInstance->Cache,
-                  newPoolElementNode,
-                  cacheElementTimeout);
-            }
-
-            /* ====== Select PEs from cache ============================== */
-            result = asapInstanceHandleResolutionFromCache(
-                        asapInstance, poolHandle,
-                        nodePtrArray,
-                        poolElementNodeArray,
-                        poolElementNodes, convertFunction, false);
-
-            dispatcherUnlock(asapInstance->StateMachine);
-            /* =========================================================== */
-
-         }
-         else {
-            LOG_VERBOSE2
-            fprintf(stdlog, "Handle Resolution at registrar for pool ");
-            poolHandlePrint(poolHandle, stdlog);
-            fputs(" failed: ", stdlog);
-            rserpoolErrorPrint(response->Error, stdlog);
-            fputs("\n", stdlog);
-            LOG_END
-            result = response->Error;
-         }
+         result = asapInstanceHandleResolutionResponse(
+                     asapInstance, poolHandle, response,
+                     nodePtrArray, poolElementNodeArray, poolElementNodes,
+                     convertFunction, cacheElementTimeout);
          rserpoolMessageDelete(response);
       }
       else {
@@ -871,6 +1569,268 @@ static unsigned int asapInstanceHandleResolutionAtRegistrar(struct ASAPInstance*
 }
 
 
+/* ###### Find handle resolution in progress ############################# */
+static struct ASAPPendingHandleResolution* asapInstanceFindPendingHandleResolution(
+                                              struct ASAPInstance*     asapInstance,
+                                              const struct PoolHandle* poolHandle)
+{
+   struct ASAPPendingHandleResolution* pending = asapInstance->PendingHandleResolutions;
+
+   while(pending != NULL) {
+      if(poolHandleComparison(&pending->Handle, poolHandle) == 0) {
+         break;
+      }
+      pending = pending->Next;
+   }
+   return(pending);
+}
+
+
+/* ###### Add handle resolution in progress ############################## */
+static struct ASAPPendingHandleResolution* asapInstanceAddPendingHandleResolution(
+                                              struct ASAPInstance*     asapInstance,
+                                              const struct PoolHandle* poolHandle)
+{
+   struct ASAPPendingHandleResolution* pending;
+
+   pending = (struct ASAPPendingHandleResolution*)malloc(sizeof(struct ASAPPendingHandleResolution));
+   if(pending != NULL) {
+      pending->Handle                        = *poolHandle;
+      pending->Waiters                       = 0;
+      pending->Completed                     = false;
+      pending->Result                        = RSPERR_OKAY;
+      pending->Next                          = asapInstance->PendingHandleResolutions;
+      asapInstance->PendingHandleResolutions = pending;
+   }
+   return(pending);
+}
+
+
+/* ###### Complete handle resolution in progress ######################### */
+static void asapInstanceCompletePendingHandleResolution(
+               struct ASAPInstance*                asapInstance,
+               struct ASAPPendingHandleResolution* pending,
+               const unsigned int                  result)
+{
+   struct ASAPPendingHandleResolution** pendingPtr;
+
+   threadSignalLock(&asapInstance->PendingHandleResolutionSignal);
+   pendingPtr = &asapInstance->PendingHandleResolutions;
+   while(*pendingPtr != pending) {
+      pendingPtr = &(*pendingPtr)->Next;
+   }
+   *pendingPtr        = pending->Next;
+   pending->Completed = true;
+   pending->Result    = result;
+   if(pending->Waiters > 0) {
+      /* The last waiter frees the entry */
+      threadSignalFireAll(&asapInstance->PendingHandleResolutionSignal);
+   }
+   else {
+      free(pending);
+   }
+   threadSignalUnlock(&asapInstance->PendingHandleResolutionSignal);
+}
+
+
+/* Context of a background cache refresh */
+struct ASAPCacheRefresh
+{
+   struct ASAPInstance*                AsapInstance;
+   struct ASAPPendingHandleResolution* Pending;
+   unsigned long long                  CacheElementTimeout;
+};
+
+
+/* ###### Complete background cache refresh ############################## */
+static void asapInstanceCacheRefreshCompleted(struct ASAPInterThreadMessage* aitm)
+{
+   struct ASAPCacheRefresh* refresh = (struct ASAPCacheRefresh*)aitm->CompletionUserData;
+   unsigned int             result  = aitm->Error;
+
+   if(result == RSPERR_OKAY) {
+      result = aitm->Response->Error;
+      if(result == RSPERR_OKAY) {
+         asapInstanceUpdateCache(refresh->AsapInstance, &refresh->Pending->Handle,
+                                 aitm->Response, refresh->CacheElementTimeout);
+      }
+   }
+   LOG_VERBOSE2
+   fprintf(stdlog, "Background refresh of cache entries for pool ");
+   poolHandlePrint(&refresh->Pending->Handle, stdlog);
+   fputs(": ", stdlog);
+   rserpoolErrorPrint(result, stdlog);
+   fputs("\n", stdlog);
+   LOG_END
+
+   asapInstanceCompletePendingHandleResolution(refresh->AsapInstance,
+                                               refresh->Pending, result);
+   asapInterThreadMessageDelete(aitm);
+   free(refresh);
+}
+
+
+/* ###### Refresh cache entries ahead of their expiry #################### */
+static void asapInstanceScheduleCacheRefresh(
+               struct ASAPInstance*                     asapInstance,
+               struct PoolHandle*                       poolHandle,
+               struct ST_CLASS(PoolElementNode)* const* poolElementNodeArray,
+               const size_t                             poolElementNodes)
+{
+   const unsigned long long       now = getMicroTime();
+   unsigned long long             lifetime;
+   struct ASAPCacheRefresh*       refresh;
+   struct ASAPInterThreadMessage* aitm;
+   struct RSerPoolMessage*        message;
+   size_t                         i;
+
+   /* ====== Check, whether an entry has passed the refresh threshold ==== */
+   lifetime = 0;
+   for(i = 0;i < poolElementNodes;i++) {
+      if( (poolElementNodeArray[i]->TimerCode == PENT_EXPIRY) &&
+          (poolElementNodeArray[i]->TimerTimeStamp > poolElementNodeArray[i]->LastUpdateTimeStamp) &&
+          ((now - poolElementNodeArray[i]->LastUpdateTimeStamp) * 100 >=
+              (poolElementNodeArray[i]->TimerTimeStamp - poolElementNodeArray[i]->LastUpdateTimeStamp) *
+                 asapInstance->CacheRefreshThreshold) ) {
+         lifetime = poolElementNodeArray[i]->TimerTimeStamp - poolElementNodeArray[i]->LastUpdateTimeStamp;
+         break;
+      }
+   }
+   if(lifetime == 0) {
+      return;
+   }
+
+   /* ====== Rate limit ================================================== */
+   threadSignalLock(&asapInstance->PendingHandleResolutionSignal);
+   if(asapInstanceFindPendingHandleResolution(asapInstance, poolHandle) != NULL) {
+      /* A refresh or handle resolution is already in progress */
+      threadSignalUnlock(&asapInstance->PendingHandleResolutionSignal);
+      return;
+   }
+   if(now < asapInstance->NextCacheRefreshTimeStamp) {
+      asapInstance->Statistics.RateLimitedCacheRefreshCount++;
+      threadSignalUnlock(&asapInstance->PendingHandleResolutionSignal);
+      return;
+   }
+   asapInstance->NextCacheRefreshTimeStamp = now + (1000000ULL / asapInstance->CacheRefreshRate);
+
+   /* ====== Let the main loop thread ask the registrar ================== */
+   refresh = (struct ASAPCacheRefresh*)malloc(sizeof(struct ASAPCacheRefresh));
+   if(refresh != NULL) {
+      refresh->AsapInstance        = asapInstance;
+      refresh->CacheElementTimeout = lifetime;
+      refresh->Pending             = asapInstanceAddPendingHandleResolution(asapInstance, poolHandle);
+      if(refresh->Pending != NULL) {
+         message = asapInstanceNewHandleResolutionRequest(poolHandle, RSPGETADDRS_MAX, lifetime);
+         if(message != NULL) {
+            aitm = asapInterThreadMessageNew(message, true);
+            if(aitm != NULL) {
+               aitm->CompletionCallback = asapInstanceCacheRefreshCompleted;
+               aitm->CompletionUserData = refresh;
+               asapInstance->Statistics.CacheRefreshCount++;
+               threadSignalUnlock(&asapInstance->PendingHandleResolutionSignal);
+
+               LOG_VERBOSE
+               fprintf(stdlog, "Scheduling background refresh of cache entries for pool ");
+               poolHandlePrint(poolHandle, stdlog);
+               fputs("\n", stdlog);
+               LOG_END
+               interThreadMessagePortEnqueue(&asapInstance->MainLoopPort, &aitm->Node, NULL);
+               asapInstanceNotifyMainLoop(asapInstance);
+               return;
+            }
+            rserpoolMessageDelete(message);
+         }
+         asapInstance->PendingHandleResolutions = refresh->Pending->Next;
+         free(refresh->Pending);
+      }
+      free(refresh);
+   }
+   threadSignalUnlock(&asapInstance->PendingHandleResolutionSignal);
+}
+
+
+/* ###### Do name lookup, coalescing concurrent requests ################# */
+static unsigned int asapInstanceHandleResolutionCoalesced(struct ASAPInstance*               asapInstance,
+                                                          struct PoolHandle*                 poolHandle,
+                                                          void**                             nodePtrArray,
+                                                          struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+                                                          size_t*                            poolElementNodes,
+                                                          unsigned int                       (*convertFunction)(const struct ST_CLASS(PoolElementNode)* poolElementNode,
+                                                                                                                void*                                   ptr),
+                                                          const unsigned long long           cacheElementTimeout)
+{
+   struct ASAPPendingHandleResolution* pending;
+   const size_t                        originalPoolElementNodes = *poolElementNodes;
+   unsigned int                        result;
+
+   threadSignalLock(&asapInstance->PendingHandleResolutionSignal);
+
+   /* ====== Is there already a request for this pool handle? ============ */
+   pending = asapInstanceFindPendingHandleResolution(asapInstance, poolHandle);
+   if(pending != NULL) {
+      /* ====== Wait for the request in progress ========================= */
+      LOG_VERBOSE
+      fprintf(stdlog, "Joining handle resolution in progress for pool ");
+      poolHandlePrint(poolHandle, stdlog);
+      fputs("\n", stdlog);
+      LOG_END
+      asapInstance->Statistics.CoalescedResolutionCount++;
+      pending->Waiters++;
+      while(!pending->Completed) {
+         threadSignalWait(&asapInstance->PendingHandleResolutionSignal);
+      }
+      result = pending->Result;
+      pending->Waiters--;
+      if(pending->Waiters == 0) {
+         free(pending);
+      }
+      threadSignalUnlock(&asapInstance->PendingHandleResolutionSignal);
+
+      /* ====== Serve the result from the refreshed cache ================ */
+      if(result == RSPERR_OKAY) {
+         *poolElementNodes = originalPoolElementNodes;
+         result = asapInstanceHandleResolutionFromCache(
+                     asapInstance, poolHandle,
+                     nodePtrArray, poolElementNodeArray,
+                     poolElementNodes, convertFunction, false);
+         if(result != RSPERR_OKAY) {
+            /* The leader's results are not in the cache (any more), e.g.
+               due to cacheElementTimeout 0 or expiry in the meantime.
+               Ask the registrar directly instead. */
+            LOG_VERBOSE
+            fputs("Results of joined handle resolution have already expired -> asking registrar\n", stdlog);
+            LOG_END
+            *poolElementNodes = originalPoolElementNodes;
+            result = asapInstanceHandleResolutionAtRegistrar(
+                        asapInstance, poolHandle,
+                        nodePtrArray, poolElementNodeArray,
+                        poolElementNodes, convertFunction,
+                        cacheElementTimeout);
+         }
+      }
+      return(result);
+   }
+
+   /* ====== Become the request in progress ============================== */
+   pending = asapInstanceAddPendingHandleResolution(asapInstance, poolHandle);
+   asapInstance->Statistics.HandleResolutionCount++;
+   threadSignalUnlock(&asapInstance->PendingHandleResolutionSignal);
+
+   result = asapInstanceHandleResolutionAtRegistrar(
+               asapInstance, poolHandle,
+               nodePtrArray, poolElementNodeArray,
+               poolElementNodes, convertFunction,
+               cacheElementTimeout);
+
+   /* ====== Wake up the waiting threads ================================= */
+   if(pending != NULL) {
+      asapInstanceCompletePendingHandleResolution(asapInstance, pending, result);
+   }
+   return(result);
+}
+
+
 /* ###### Do handle resolution for given pool handle ##################### */
 #define HRES_POOL_ELEMENT_NODE_ARRAY_SIZE 1024
 unsigned int asapInstanceHandleResolution(
@@ -905,7 +1865,7 @@ unsigned int asapInstanceHandleResolution(
          Set it to its original value. */
       *nodePtrs = originalPoolElementNodes;
 
-      result = asapInstanceHandleResolutionAtRegistrar(
+      result = asapInstanceHandleResolutionCoalesced(
                   asapInstance, poolHandle,
                   nodePtrArray,
                   (struct ST_CLASS(PoolElementNode)**)&poolElementNodeArray,
@@ -922,6 +1882,132 @@ unsigned int asapInstanceHandleResolution(
 }
 
 
+/* Context of an asynchronous handle resolution */
+struct ASAPHandleResolutionRequest
+{
+   struct ASAPInstance* AsapInstance;
+   struct PoolHandle    Handle;
+   size_t               NodePtrs;
+   unsigned int         (*ConvertFunction)(const struct ST_CLASS(PoolElementNode)* poolElementNode,
+                                           void*                                   ptr);
+   unsigned long long   CacheElementTimeout;
+   void                 (*Callback)(unsigned int result,
+                                    void**       nodePtrArray,
+                                    size_t       nodePtrs,
+                                    void*        userData);
+   void*                UserData;
+   void*                NodePtrArray[0];
+};
+
+
+/* ###### Complete asynchronous handle resolution ######################## */
+static void asapInstanceHandleResolutionAsyncCompleted(struct ASAPInterThreadMessage* aitm)
+{
+   struct ASAPHandleResolutionRequest* request = (struct ASAPHandleResolutionRequest*)aitm->CompletionUserData;
+   struct ST_CLASS(PoolElementNode)*   poolElementNodeArray[HRES_POOL_ELEMENT_NODE_ARRAY_SIZE];
+   size_t                              nodePtrs = 0;
+   unsigned int                        result   = aitm->Error;
+
+   if(result == RSPERR_OKAY) {
+      nodePtrs = request->NodePtrs;
+      result   = asapInstanceHandleResolutionResponse(
+                    request->AsapInstance, &request->Handle, aitm->Response,
+                    (void**)&request->NodePtrArray,
+                    (struct ST_CLASS(PoolElementNode)**)&poolElementNodeArray,
+                    &nodePtrs, request->ConvertFunction,
+                    request->CacheElementTimeout);
+      if(result != RSPERR_OKAY) {
+         nodePtrs = 0;
+      }
+   }
+   else {
+      LOG_VERBOSE2
+      fprintf(stdlog, "Handle Resolution at registrar for pool ");
+      poolHandlePrint(&request->Handle, stdlog);
+      fputs(" failed: ", stdlog);
+      rserpoolErrorPrint(result, stdlog);
+      fputs("\n", stdlog);
+      LOG_END
+   }
+
+   asapInterThreadMessageDelete(aitm);
+   request->Callback(result, (void**)&request->NodePtrArray, nodePtrs, request->UserData);
+   free(request);
+}
+
+
+/* ###### Do asynchronous handle resolution for given pool handle ######## */
+unsigned int asapInstanceHandleResolutionAsync(
+                struct ASAPInstance*     asapInstance,
+                struct PoolHandle*       poolHandle,
+                const size_t             nodePtrs,
+                unsigned int             (*convertFunction)(const struct ST_CLASS(PoolElementNode)* poolElementNode,
+                                                            void*                                   ptr),
+                const unsigned long long cacheElementTimeout,
+                void                     (*callback)(unsigned int result,
+                                                     void**       nodePtrArray,
+                                                     size_t       nodePtrs,
+                                                     void*        userData),
+                void*                    userData)
+{
+   struct ST_CLASS(PoolElementNode)*   poolElementNodeArray[HRES_POOL_ELEMENT_NODE_ARRAY_SIZE];
+   struct ASAPHandleResolutionRequest* request;
+   struct ASAPInterThreadMessage*      aitm;
+   struct RSerPoolMessage*             message;
+   size_t                              cacheNodePtrs;
+   unsigned int                        result;
+
+   request = (struct ASAPHandleResolutionRequest*)malloc(
+                sizeof(struct ASAPHandleResolutionRequest) +
+                min(HRES_POOL_ELEMENT_NODE_ARRAY_SIZE, nodePtrs) * sizeof(void*));
+   if(request == NULL) {
+      return(RSPERR_OUT_OF_MEMORY);
+   }
+   request->AsapInstance        = asapInstance;
+   request->Handle              = *poolHandle;
+   request->NodePtrs            = min(HRES_POOL_ELEMENT_NODE_ARRAY_SIZE, nodePtrs);
+   request->ConvertFunction     = convertFunction;
+   request->CacheElementTimeout = cacheElementTimeout;
+   request->Callback            = callback;
+   request->UserData            = userData;
+
+   /* ====== Try cache first ============================================= */
+   cacheNodePtrs = request->NodePtrs;
+   result = asapInstanceHandleResolutionFromCache(
+               asapInstance, poolHandle,
+               (void**)&request->NodePtrArray,
+               (struct ST_CLASS(PoolElementNode)**)&poolElementNodeArray,
+               &cacheNodePtrs, convertFunction, true);
+   if(result == RSPERR_OKAY) {
+      callback(result, (void**)&request->NodePtrArray, cacheNodePtrs, userData);
+      free(request);
+      return(RSPERR_OKAY);
+   }
+
+   /* ====== Ask registrar =============================================== */
+   LOG_VERBOSE
+   fputs("No results in cache. Trying asynchronous handle resolution at registrar...\n", stdlog);
+   LOG_END
+   message = asapInstanceNewHandleResolutionRequest(poolHandle, request->NodePtrs,
+                                                    cacheElementTimeout);
+   if(message == NULL) {
+      free(request);
+      return(RSPERR_OUT_OF_MEMORY);
+   }
+   aitm = asapInterThreadMessageNew(message, true);
+   if(aitm == NULL) {
+      rserpoolMessageDelete(message);
+      free(request);
+      return(RSPERR_OUT_OF_MEMORY);
+   }
+   aitm->CompletionCallback = asapInstanceHandleResolutionAsyncCompleted;
+   aitm->CompletionUserData = request;
+   interThreadMessagePortEnqueue(&asapInstance->MainLoopPort, &aitm->Node, NULL);
+   asapInstanceNotifyMainLoop(asapInstance);
+   return(RSPERR_OKAY);
+}
+
+
 /* ###### Report pool element failure ####################################### */
 unsigned int asapInstanceReportFailure(struct ASAPInstance*            asapInstance,
                                        struct PoolHandle*              poolHandle,
@@ -950,6 +2036,7 @@ unsigned int asapInstanceReportFailure(struct ASAPInstance*            asapInsta
                           poolHandle,
                           identifier);
       CHECK(result == RSPERR_OKAY);
+      asapInstancePublishCacheSnapshot(asapInstance, poolHandle);
    }
    else {
       LOG_VERBOSE
@@ -959,7 +2046,7 @@ unsigned int asapInstanceReportFailure(struct ASAPInstance*            asapInsta
    dispatcherUnlock(asapInstance->StateMachine);
 
    /* ====== Report unreachability ========================================== */
-   message = rserpoolMessageNew(NULL, ASAP_BUFFER_SIZE);
+   message = rserpoolMessageNew(NULL, RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE);
    if(message != NULL) {
       message->Type       = AHT_ENDPOINT_UNREACHABLE;
       message->Flags      = 0x00;
@@ -1105,6 +2192,34 @@ static void asapInstanceHandleEndpointKeepAlive(
 }
 
 
+/* ###### Check, whether response belongs to request ################### */
+static bool asapInstanceResponseMatchesRequest(const struct RSerPoolMessage* request,
+                                               const struct RSerPoolMessage* response)
+{
+   switch(response->Type) {
+      case AHT_REGISTRATION_RESPONSE:
+         if(request->Type == AHT_LOAD_UPDATE) {
+            return( (poolHandleComparison(&request->Handle, &response->Handle) == 0) &&
+                    (request->Identifier == response->Identifier) );
+         }
+         return( (request->Type == AHT_REGISTRATION) &&
+                 (poolHandleComparison(&request->Handle, &response->Handle) == 0) &&
+                 (request->PoolElementPtr->Identifier == response->Identifier) );
+       break;
+      case AHT_DEREGISTRATION_RESPONSE:
+         return( (request->Type == AHT_DEREGISTRATION) &&
+                 (poolHandleComparison(&request->Handle, &response->Handle) == 0) &&
+                 (request->Identifier == response->Identifier) );
+       break;
+      case AHT_HANDLE_RESOLUTION_RESPONSE:
+         return( (request->Type == AHT_HANDLE_RESOLUTION) &&
+                 (poolHandleComparison(&request->Handle, &response->Handle) == 0) );
+       break;
+   }
+   return(false);
+}
+
+
 /* ###### Handle response from registrar ################################# */
 static void asapInstanceHandleResponseFromRegistrar(
                struct ASAPInstance*    asapInstance,
@@ -1113,14 +2228,22 @@ static void asapInstanceHandleResponseFromRegistrar(
    struct ASAPInterThreadMessage* aitm;
    struct ASAPInterThreadMessage* nextAITM;
 
-   aitm = (struct ASAPInterThreadMessage*)interThreadMessagePortDequeue(&asapInstance->MainLoopPort);
+   /* The registrar answers in order: the response belongs to the first
+      outstanding request. */
+   aitm = NULL;
+   if(asapInstance->RegistrarOutstandingRequests > 0) {
+      aitm = (struct ASAPInterThreadMessage*)interThreadMessagePortDequeue(&asapInstance->MainLoopPort);
+   }
    if(aitm != NULL) {
       /* No timeout occurred -> stop timeout timer */
       timerStop(&asapInstance->RegistrarTimeoutTimer);
+      asapInstance->RegistrarOutstandingRequests--;
 
-      if( ((response->Type == AHT_REGISTRATION_RESPONSE)      && (aitm->Request->Type == AHT_REGISTRATION))   ||
-          ((response->Type == AHT_DEREGISTRATION_RESPONSE)    && (aitm->Request->Type == AHT_DEREGISTRATION)) ||
-          ((response->Type == AHT_HANDLE_RESOLUTION_RESPONSE) && (aitm->Request->Type == AHT_HANDLE_RESOLUTION)) ) {
+      if(asapInstanceResponseMatchesRequest(aitm->Request, response)) {
+         asapInstance->Statistics.ResponseCount++;
+         asapInstance->Statistics.TotalResponseDelay += getMicroTime() - aitm->TransmissionTimeStamp;
+         asapInstance->Statistics.MaxResponseDelay    = max(asapInstance->Statistics.MaxResponseDelay,
+                                                            getMicroTime() - aitm->TransmissionTimeStamp);
 
          LOG_VERBOSE
          fprintf(stdlog, "Successfully got response ($%04x) for request ($%04x) from registrar\n"
@@ -1133,6 +2256,7 @@ static void asapInstanceHandleResponseFromRegistrar(
          /* Asynchronous message: print errors here! */
          if(aitm->Node.ReplyPort == NULL) {
             if( (response->Type == AHT_REGISTRATION_RESPONSE) &&
+                (aitm->Request->Type == AHT_REGISTRATION) &&
                 ((response->Error != RSPERR_OKAY) || (response->Flags & AHF_REGISTRATION_REJECT)) ) {
                LOG_ERROR
                fprintf(stdlog, "Unable to register pool element $%08x of pool ",
@@ -1170,6 +2294,7 @@ static void asapInstanceHandleResponseFromRegistrar(
                     response->Type, aitm->Request->Type);
             LOG_END
          }
+         asapInstance->Statistics.MismatchedResponseCount++;
          asapInstanceDisconnectFromRegistrar(asapInstance, true);
       }
 
@@ -1178,14 +2303,7 @@ static void asapInstanceHandleResponseFromRegistrar(
          /* No more responses are expected. */
          asapInstance->LastAITM = NULL;
       }
-      if(aitm->Node.ReplyPort) {
-          /* Reply to requesting thread, if reply is desired. */
-         interThreadMessageReply(&aitm->Node);
-      }
-      else {
-         /* Sender is not interested in result, throw it away. */
-         asapInterThreadMessageDelete(aitm);
-      }
+      asapInstanceCompleteAITM(asapInstance, aitm);
 
       /* Schedule next response's timeout */
       dispatcherLock(asapInstance->StateMachine);
@@ -1361,6 +2479,7 @@ static void asapInstanceHandleQueuedAITMs(struct ASAPInstance* asapInstance)
 {
    struct ASAPInterThreadMessage* aitm;
    struct ASAPInterThreadMessage* nextAITM;
+   struct ASAPInterThreadMessage* failedAITMs = NULL;
    unsigned int                   result;
 
    /* ====== Get next AITM =============================================== */
@@ -1393,22 +2512,29 @@ static void asapInstanceHandleQueuedAITMs(struct ASAPInstance* asapInstance)
          fputs("Maximum number of transmission trials reached\n", stdlog);
          LOG_END
          interThreadMessagePortRemoveMessage(&asapInstance->MainLoopPort, &aitm->Node);
-         if(aitm->Node.ReplyPort) {
-            if(asapInstance->RegistrarSocket < 0) {
-               aitm->Error = RSPERR_NO_REGISTRAR;
-            }
-            else {
-               aitm->Error = RSPERR_TIMEOUT;
-            }
-            interThreadMessageReply(&aitm->Node);
+         if(asapInstance->RegistrarSocket < 0) {
+            aitm->Error = RSPERR_NO_REGISTRAR;
          }
          else {
-            asapInterThreadMessageDelete(aitm);
+            aitm->Error = RSPERR_TIMEOUT;
          }
+         /* Completion callbacks may use the MainLoopPort and the
+            StateMachine. Therefore, complete after unlocking the port. */
+         aitm->NextCompletion = failedAITMs;
+         failedAITMs          = aitm;
       }
 
       /* ====== Send to registrar ======================================== */
       else {
+         /* ====== Window of outstanding requests is full ================ */
+         if( (aitm->ResponseExpected) &&
+             (asapInstance->RegistrarOutstandingRequests >= asapInstance->RegistrarMaxOutstandingRequests) ) {
+            /* The trial was not used */
+            aitm->TransmissionTrials--;
+            asapInstance->Statistics.WindowFullCount++;
+            break;
+         }
+
          if(asapInstance->RegistrarSocket >= 0) {
             LOG_VERBOSE
             fputs("Sending message to registrar ...\n", stdlog);
@@ -1428,6 +2554,10 @@ static void asapInstanceHandleQueuedAITMs(struct ASAPInstance* asapInstance)
                break;
             }
             aitm->TransmissionTimeStamp = getMicroTime();
+            asapInstance->Statistics.RequestCount++;
+            asapInstance->Statistics.TotalQueuingDelay += aitm->TransmissionTimeStamp - aitm->CreationTimeStamp;
+            asapInstance->Statistics.MaxQueuingDelay    = max(asapInstance->Statistics.MaxQueuingDelay,
+                                                              aitm->TransmissionTimeStamp - aitm->CreationTimeStamp);
 
             if(!aitm->ResponseExpected) {
                /* No response from registrar expected. */
@@ -1436,6 +2566,9 @@ static void asapInstanceHandleQueuedAITMs(struct ASAPInstance* asapInstance)
             }
             else  {
                asapInstance->LastAITM = aitm;
+               asapInstance->RegistrarOutstandingRequests++;
+               asapInstance->Statistics.MaxOutstandingRequests = max(asapInstance->Statistics.MaxOutstandingRequests,
+                                                                     asapInstance->RegistrarOutstandingRequests);
 
                /* Schedule timeout */
                aitm->ResponseTimeoutTimeStamp       = getMicroTime() + asapInstance->RegistrarResponseTimeout;
@@ -1455,6 +2588,13 @@ static void asapInstanceHandleQueuedAITMs(struct ASAPInstance* asapInstance)
    }
    interThreadMessagePortUnlock(&asapInstance->MainLoopPort);
 
+   /* ====== Complete failed requests ==================================== */
+   while(failedAITMs != NULL) {
+      aitm        = failedAITMs;
+      failedAITMs = aitm->NextCompletion;
+      asapInstanceCompleteAITM(asapInstance, aitm);
+   }
+
 
    /* ====== Set timeout ================================================= */
    dispatcherLock(asapInstance->StateMachine);
@@ -1499,21 +2639,87 @@ static bool asapInstanceIsShuttingDown(struct ASAPInstance* asapInstance)
 }
 
 
+/* ###### Check, whether there are AITMs to be sent ###################### */
+static bool asapInstanceHasSendableAITMs(struct ASAPInstance* asapInstance)
+{
+   struct InterThreadMessageNode* nextNode;
+
+   interThreadMessagePortLock(&asapInstance->MainLoopPort);
+   if(asapInstance->LastAITM) {
+      nextNode = interThreadMessagePortGetNextMessage(&asapInstance->MainLoopPort,
+                                                      &asapInstance->LastAITM->Node);
+   }
+   else {
+      nextNode = interThreadMessagePortGetFirstMessage(&asapInstance->MainLoopPort);
+   }
+   interThreadMessagePortUnlock(&asapInstance->MainLoopPort);
+
+   return( (nextNode != NULL) &&
+           (asapInstance->RegistrarOutstandingRequests < asapInstance->RegistrarMaxOutstandingRequests) );
+}
+
+
+/* ###### Read wakeup notifications from main loop pipe ################# */
+static void asapInstanceReadMainLoopPipe(struct ASAPInstance* asapInstance)
+{
+   char    buffer[128];
+   ssize_t r;
+
+   r = ext_read(asapInstance->MainLoopPipe[0], (char*)&buffer, sizeof(buffer));
+   if(r <= 0) {
+      LOG_ERROR
+      logerror("Reading from main loop pipe failed");
+      LOG_END
+   }
+}
+
+
+/* ###### Handle main loop pipe event in epoll() mode #################### */
+static void asapInstanceHandleMainLoopPipeEvent(struct Dispatcher* dispatcher,
+                                                int                fd,
+                                                unsigned int       eventMask,
+                                                void*              userData)
+{
+   asapInstanceReadMainLoopPipe((struct ASAPInstance*)userData);
+}
+
+
 /* ###### ASAP Instance main loop thread ################################# */
 static void* asapInstanceMainLoop(void* args)
 {
    struct ASAPInstance* asapInstance = (struct ASAPInstance*)args;
-   char                 buffer[128];
+   struct FDCallback    pipeCallback;
    unsigned long long   pollTimeStamp;
    struct pollfd        ufds[FD_SETSIZE];
    unsigned int         nfds;
    int                  timeout;
    unsigned int         pipeIndex;
    int                  result;
-   ssize_t              r;
 
    asapInstanceConnectToRegistrar(asapInstance, -1);
 
+   /* ====== epoll() mode: the dispatcher also watches the pipe ========== */
+   if(dispatcherIsInEPollMode(asapInstance->StateMachine)) {
+      fdCallbackNew(&pipeCallback, asapInstance->StateMachine,
+                    asapInstance->MainLoopPipe[0], FDCE_Read,
+                    asapInstanceHandleMainLoopPipeEvent, (void*)asapInstance);
+      while(!asapInstanceIsShuttingDown(asapInstance)) {
+         /* Do not block if there are new AITM messages to be handled */
+         result = dispatcherEPollEventLoop(asapInstance->StateMachine,
+                                           asapInstanceHasSendableAITMs(asapInstance) ? 0 : -1);
+         if((result < 0) && (errno != EINTR)) {
+            LOG_ERROR
+            logerror("epoll_wait() failed");
+            LOG_END
+         }
+         asapInstanceHandleQueuedAITMs(asapInstance);
+      }
+      fdCallbackDelete(&pipeCallback);
+      asapInstanceDisconnectFromRegistrar(asapInstance, false);
+      rserpoolMessageGetPoolStatistics(&asapInstance->Statistics.MainLoopMessagePool);
+      return(NULL);
+   }
+
    while(!asapInstanceIsShuttingDown(asapInstance)) {
       /* ====== Collect data for ext_select() call ======================= */
       dispatcherGetPollParameters(asapInstance->StateMachine,
@@ -1523,10 +2729,8 @@ static void* asapInstanceMainLoop(void* args)
       ufds[pipeIndex].fd      = asapInstance->MainLoopPipe[0];
       ufds[pipeIndex].events  = POLLIN;
       ufds[pipeIndex].revents = 0;
-      if(!interThreadMessagePortIsFirstMessage(&asapInstance->MainLoopPort,
-                                               &asapInstance->LastAITM->Node)) {
-         /* First message in AITM queue is not LastAITM:
-            There are new AITM messages to be handled.
+      if(asapInstanceHasSendableAITMs(asapInstance)) {
+         /* There are new AITM messages to be handled.
             Do not block if there are no socket events! */
          timeout = 0;
       }
@@ -1538,12 +2742,7 @@ static void* asapInstanceMainLoop(void* args)
       dispatcherHandlePollResult(asapInstance->StateMachine, result,
                                  (struct pollfd*)&ufds, nfds, timeout, pollTimeStamp);
       if(ufds[pipeIndex].revents & POLLIN) {
-         r = ext_read(asapInstance->MainLoopPipe[0], (char*)&buffer, sizeof(buffer));
-         if(r <= 0) {
-            LOG_ERROR
-            logerror("Reading from main loop pipe failed");
-            LOG_END
-         }
+         asapInstanceReadMainLoopPipe(asapInstance);
       }
 
       /* ====== Handle inter-thread messages ============================= */
@@ -1551,5 +2750,6 @@ static void* asapInstanceMainLoop(void* args)
    }
 
    asapInstanceDisconnectFromRegistrar(asapInstance, false);
+   rserpoolMessageGetPoolStatistics(&asapInstance->Statistics.MainLoopMessagePool);
    return(NULL);
 }
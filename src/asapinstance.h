@@ -45,6 +45,9 @@
 #include "poolhandlespacemanagement.h"
 #include "registrartable.h"
 #include "interthreadmessageport.h"
+#include "threadsignal.h"
+
+#include <stdatomic.h>
 
 
 #ifdef __cplusplus
@@ -54,6 +57,61 @@ extern "C" {
 
 struct ASAPInterThreadMessage;
 
+#define ASAP_CACHE_SNAPSHOT_SLOTS          256
+#define ASAP_CACHE_SNAPSHOT_MAX_CANDIDATES 1024
+
+struct ASAPInstanceStatistics
+{
+   unsigned long long                         RequestCount;             /* Requests sent to registrar     */
+   unsigned long long                         ResponseCount;            /* Matched responses              */
+   unsigned long long                         MismatchedResponseCount;  /* Responses not matching request */
+   unsigned long long                         WindowFullCount;          /* Sending stalled by full window */
+   size_t                                     MaxOutstandingRequests;   /* Peak of outstanding requests   */
+   unsigned long long                         TotalQueuingDelay;        /* Creation until transmission    */
+   unsigned long long                         MaxQueuingDelay;
+   unsigned long long                         TotalResponseDelay;       /* Transmission until response    */
+   unsigned long long                         MaxResponseDelay;
+   unsigned long long                         HandleResolutionCount;    /* Cache misses sent to registrar */
+   unsigned long long                         CoalescedResolutionCount; /* Cache misses joining these     */
+   unsigned long long                         CacheRefreshCount;        /* Background cache refreshes     */
+   unsigned long long                         RateLimitedCacheRefreshCount;
+   struct RSerPoolMessagePoolStatistics       MainLoopMessagePool;      /* Saved by main loop thread      */
+};
+
+/* Immutable copy of the cache entries of one pool. The copied pool
+   element nodes are not linked into any storage; only their attributes
+   (identifier, policy settings, user transport, expiry) are valid. */
+struct ASAPCacheSnapshot
+{
+   size_t                                     Slot;
+   size_t                                     ReferenceCount;  /* Protected by slot's mutex */
+   const struct ST_CLASS(PoolPolicy)*         Policy;
+   size_t                                     RotationSize;    /* Leading equivalent entries */
+   size_t                                     Entries;
+   struct ST_CLASS(PoolElementNode)           EntryArray[0];
+};
+
+struct ASAPCacheSnapshotSlot
+{
+   pthread_mutex_t                            Mutex;
+   bool                                       InUse;
+   bool                                       Reclaimed;   /* Pool has left the Cache */
+   struct PoolHandle                          Handle;
+   struct ASAPCacheSnapshot*                  Snapshot;
+   atomic_uint                                Rotation;    /* Selections of RoundRobin-like policies */
+};
+
+/* In-flight handle resolution at the registrar, shared by all threads
+   missing the cache for the same pool handle */
+struct ASAPPendingHandleResolution
+{
+   struct ASAPPendingHandleResolution*        Next;
+   struct PoolHandle                          Handle;
+   size_t                                     Waiters;
+   bool                                       Completed;
+   unsigned int                               Result;
+};
+
 struct ASAPInstance
 {
    struct Dispatcher*                         StateMachine;
@@ -82,6 +140,35 @@ struct ASAPInstance
    size_t                                     RegistrarRequestMaxTrials;
    unsigned long long                         RegistrarRequestTimeout;
    unsigned long long                         RegistrarResponseTimeout;
+
+   /* Requests are pipelined: up to RegistrarMaxOutstandingRequests requests
+      may await their responses. The registrar answers in order, i.e. the
+      first queued AITM always belongs to the next response. */
+   size_t                                     RegistrarMaxOutstandingRequests;
+   size_t                                     RegistrarOutstandingRequests;
+   struct ASAPInstanceStatistics              Statistics;
+
+   /* Concurrent cache misses for the same pool handle are coalesced:
+      only the first one asks the registrar, the others wait for its
+      completion and are then served from the Cache. */
+   struct ThreadSignal                        PendingHandleResolutionSignal;
+   struct ASAPPendingHandleResolution*        PendingHandleResolutions;
+
+   /* Refresh-ahead: when a lookup is served from cache entries which have
+      passed CacheRefreshThreshold percent of their lifetime, the main loop
+      thread refreshes them at the registrar in the background. At most
+      CacheRefreshRate refreshes per second are made. */
+   unsigned int                               CacheRefreshThreshold;
+   unsigned int                               CacheRefreshRate;
+   unsigned long long                         NextCacheRefreshTimeStamp;
+
+   /* Lookups are served from per-pool snapshots of the Cache without the
+      StateMachine lock. Snapshots are replaced whenever the Cache entries
+      of a pool change (RCU-style); the last reference frees the old one.
+      Slots are assigned by open addressing on the pool handle hash. When
+      a pool leaves the Cache, its slot is only marked as reclaimed, so a
+      reader's probe sequence stays valid; the slot may then be reused. */
+   struct ASAPCacheSnapshotSlot               CacheSnapshotTable[ASAP_CACHE_SNAPSHOT_SLOTS];
 };
 
 
@@ -93,6 +180,9 @@ struct ASAPInstance
 #define ASAP_DEFAULT_REGISTRAR_REQUEST_MAXTRIALS               1
 #define ASAP_DEFAULT_REGISTRAR_REQUEST_TIMEOUT           3000000
 #define ASAP_DEFAULT_REGISTRAR_RESPONSE_TIMEOUT          3000000
+#define ASAP_DEFAULT_REGISTRAR_MAX_OUTSTANDING_REQUESTS       16
+#define ASAP_DEFAULT_CACHE_REFRESH_THRESHOLD                   0
+#define ASAP_DEFAULT_CACHE_REFRESH_RATE                       10
 
 #define ASAP_BUFFER_SIZE                                   65536
 
@@ -155,6 +245,24 @@ unsigned int asapInstanceDeregister(
                 const PoolElementIdentifierType identifier,
                 const bool                      waitForResponse);
 
+/**
+  * Update the policy information (e.g. load) of a registered pool element.
+  * Unlike a reregistration, only pool handle, identifier and policy
+  * information are sent to the home registrar. The registrar answers with
+  * a Registration Response. If the update is rejected or not understood
+  * (e.g. by an RFC 5352 registrar), a full reregistration is sent instead.
+  *
+  * @param asapInstance ASAPInstance.
+  * @param poolHandle Pool handle.
+  * @param identifier Pool element identifier.
+  * @param policySettings New policy settings.
+  * @return RSPERR_OKAY in case of success; error code otherwise.
+  */
+unsigned int asapInstanceUpdateLoad(struct ASAPInstance*             asapInstance,
+                                    struct PoolHandle*               poolHandle,
+                                    const PoolElementIdentifierType  identifier,
+                                    const struct PoolPolicySettings* policySettings);
+
 /**
   * Report failure of pool element.
   *
@@ -190,6 +298,36 @@ unsigned int asapInstanceHandleResolution(
                                                             void*                                   ptr),
                 const unsigned long long cacheElementTimeout);
 
+/**
+  * Do asynchronous handle resolution of given pool handle. If the cache
+  * contains the pool, the callback is invoked before this function returns.
+  * Otherwise, the request is sent to the registrar and the callback is
+  * invoked from the ASAP main loop thread. The callback must not block,
+  * i.e. it must not call any synchronous ASAP function. It gets the result
+  * code and the converted PoolElementNodes (see
+  * asapInstanceHandleResolution()).
+  *
+  * @param asapInstance ASAPInstance.
+  * @param poolHandle Pool handle.
+  * @param nodePtrs Maximum amount of pool element nodes to obtain.
+  * @param cacheElementTimeout Stale cache value for newly received PE entries.
+  * @param callback Completion callback.
+  * @param userData User data for completion callback.
+  * @return RSPERR_OKAY in case of success (i.e. callback will be invoked); error code otherwise.
+  */
+unsigned int asapInstanceHandleResolutionAsync(
+                struct ASAPInstance*     asapInstance,
+                struct PoolHandle*       poolHandle,
+                const size_t             nodePtrs,
+                unsigned int             (*convertFunction)(const struct ST_CLASS(PoolElementNode)* poolElementNode,
+                                                            void*                                   ptr),
+                const unsigned long long cacheElementTimeout,
+                void                     (*callback)(unsigned int result,
+                                                     void**       nodePtrArray,
+                                                     size_t       nodePtrs,
+                                                     void*        userData),
+                void*                    userData);
+
 
 #ifdef __cplusplus
 }
@@ -52,6 +52,9 @@ struct ASAPInterThreadMessage* asapInterThreadMessageNew(
    aitm->ResponseTimeoutNeedsScheduling = false;
    aitm->CreationTimeStamp              = getMicroTime();
    aitm->TransmissionTimeStamp          = 0;
+   aitm->CompletionCallback             = NULL;
+   aitm->CompletionUserData             = NULL;
+   aitm->NextCompletion                 = NULL;
    return(aitm);
 }
 
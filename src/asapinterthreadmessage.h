@@ -53,6 +53,12 @@ struct ASAPInterThreadMessage
    unsigned long long            ResponseTimeoutTimeStamp;
    bool                          ResponseExpected;
    bool                          ResponseTimeoutNeedsScheduling;
+
+   /* Asynchronous completion in the ASAP main loop thread, used instead of
+      a reply port. The callback takes over the message. */
+   void                          (*CompletionCallback)(struct ASAPInterThreadMessage* aitm);
+   void*                         CompletionUserData;
+   struct ASAPInterThreadMessage* NextCompletion;
 };
 
 
@@ -0,0 +1,858 @@
+/* --------------------------------------------------------------------------
+ *
+ *              //===//   //=====   //===//   //=====  //   //      //
+ *             //    //  //        //    //  //       //   //=/  /=//
+ *            //===//   //=====   //===//   //====   //   //  //  //
+ *           //   \\         //  //             //  //   //  //  //
+ *          //     \\  =====//  //        =====//  //   //      //  Version V
+ *
+ * ------------- An Open Source RSerPool Simulation for OMNeT++ -------------
+ *
+ * Copyright (C) 2003-2026 by Thomas Dreibholz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: thomas.dreibholz@gmail.com
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "bplustree.h"
+#include "debug.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* ###### Initialize ##################################################### */
+void bPlusTreeNodeNew(struct BPlusTreeNode* node)
+{
+   node->Page  = NULL;
+   node->Value = 0;
+}
+
+
+/* ###### Invalidate ##################################################### */
+void bPlusTreeNodeDelete(struct BPlusTreeNode* node)
+{
+   node->Page  = NULL;
+   node->Value = 0;
+}
+
+
+/* ###### Is node linked? ################################################ */
+int bPlusTreeNodeIsLinked(const struct BPlusTreeNode* node)
+{
+   return(node->Page != NULL);
+}
+
+
+/* ###### Allocate page ################################################## */
+static struct BPlusTreePage* bPlusTreePageNew(const int isLeaf)
+{
+   /* Leaf pages do not need the child arrays at the end of the structure */
+   const size_t          size = (isLeaf) ? offsetof(struct BPlusTreePage, Child) :
+                                           sizeof(struct BPlusTreePage);
+   struct BPlusTreePage* page = (struct BPlusTreePage*)malloc(size);
+
+   if(page == NULL) {
+      return(NULL);
+   }
+   page->Parent   = NULL;
+   page->PrevLeaf = NULL;
+   page->NextLeaf = NULL;
+   page->ValueSum = 0;
+   page->Entries  = 0;
+   page->IsLeaf   = isLeaf;
+   return(page);
+}
+
+
+/* ###### Free page and all its children ################################# */
+static void bPlusTreePageDelete(struct BPlusTreePage* page)
+{
+   unsigned int i;
+
+   if(!page->IsLeaf) {
+      for(i = 0;i < page->Entries;i++) {
+         bPlusTreePageDelete(page->Child[i]);
+      }
+   }
+   free(page);
+}
+
+
+/* ###### Get value of a page entry ###################################### */
+inline static BPlusTreeNodeValueType bPlusTreePageGetEntryValue(
+                                        const struct BPlusTreePage* page,
+                                        const unsigned int          index)
+{
+   return((page->IsLeaf) ? page->Key[index]->Value : page->ChildValueSum[index]);
+}
+
+
+/* ###### Insert entry into page ######################################### */
+static void bPlusTreePageInsertEntry(struct BPlusTreePage*        page,
+                                     const unsigned int           index,
+                                     struct BPlusTreeNode*        key,
+                                     struct BPlusTreePage*        child,
+                                     const BPlusTreeNodeValueType value)
+{
+   const size_t moved = page->Entries - index;
+
+   CHECK(page->Entries <= BPLUSTREE_MAX_ENTRIES);
+   CHECK(index <= page->Entries);
+   memmove(&page->Key[index + 1], &page->Key[index], moved * sizeof(page->Key[0]));
+   page->Key[index] = key;
+   if(page->IsLeaf) {
+      key->Page = page;
+   }
+   else {
+      memmove(&page->Child[index + 1], &page->Child[index],
+              moved * sizeof(page->Child[0]));
+      memmove(&page->ChildValueSum[index + 1], &page->ChildValueSum[index],
+              moved * sizeof(page->ChildValueSum[0]));
+      page->Child[index]         = child;
+      page->ChildValueSum[index] = value;
+      child->Parent              = page;
+   }
+   page->ValueSum += value;
+   page->Entries++;
+}
+
+
+/* ###### Remove entry from page ######################################### */
+static void bPlusTreePageRemoveEntry(struct BPlusTreePage* page,
+                                     const unsigned int    index)
+{
+   const size_t moved = page->Entries - index - 1;
+
+   CHECK(index < page->Entries);
+   page->ValueSum -= bPlusTreePageGetEntryValue(page, index);
+   memmove(&page->Key[index], &page->Key[index + 1], moved * sizeof(page->Key[0]));
+   if(!page->IsLeaf) {
+      memmove(&page->Child[index], &page->Child[index + 1],
+              moved * sizeof(page->Child[0]));
+      memmove(&page->ChildValueSum[index], &page->ChildValueSum[index + 1],
+              moved * sizeof(page->ChildValueSum[0]));
+   }
+   page->Entries--;
+}
+
+
+/* ###### Move entry from one page to another ############################ */
+static void bPlusTreePageMoveEntry(struct BPlusTreePage* source,
+                                   const unsigned int    sourceIndex,
+                                   struct BPlusTreePage* destination,
+                                   const unsigned int    destinationIndex)
+{
+   struct BPlusTreeNode*        key   = source->Key[sourceIndex];
+   struct BPlusTreePage*        child = (source->IsLeaf) ? NULL : source->Child[sourceIndex];
+   const BPlusTreeNodeValueType value = bPlusTreePageGetEntryValue(source, sourceIndex);
+
+   bPlusTreePageRemoveEntry(source, sourceIndex);
+   bPlusTreePageInsertEntry(destination, destinationIndex, key, child, value);
+}
+
+
+/* ###### Get index of node within its leaf page ######################### */
+inline static unsigned int bPlusTreePageIndexOfNode(const struct BPlusTreePage* page,
+                                                    const struct BPlusTreeNode* node)
+{
+   unsigned int i;
+   for(i = 0;i < page->Entries;i++) {
+      if(page->Key[i] == node) {
+         return(i);
+      }
+   }
+   CHECK(0);
+   return(0);
+}
+
+
+/* ###### Get index of child within its parent page ###################### */
+inline static unsigned int bPlusTreePageIndexOfChild(const struct BPlusTreePage* page,
+                                                     const struct BPlusTreePage* child)
+{
+   unsigned int i;
+   for(i = 0;i < page->Entries;i++) {
+      if(page->Child[i] == child) {
+         return(i);
+      }
+   }
+   CHECK(0);
+   return(0);
+}
+
+
+/* ###### Update parent's first key and value sum of a child ############# */
+static void bPlusTreePageUpdateChildSummary(struct BPlusTreePage* page,
+                                            const unsigned int    index)
+{
+   const struct BPlusTreePage* child = page->Child[index];
+
+   page->Key[index]           = child->Key[0];
+   page->ValueSum             = page->ValueSum - page->ChildValueSum[index] + child->ValueSum;
+   page->ChildValueSum[index] = child->ValueSum;
+}
+
+
+/* ###### Update summaries of all parents up to tree root ################ */
+static void bPlusTreeUpdateParents(struct BPlusTreePage* page)
+{
+   struct BPlusTreePage* parent = page->Parent;
+   while(parent != NULL) {
+      bPlusTreePageUpdateChildSummary(parent,
+                                      bPlusTreePageIndexOfChild(parent, page));
+      page   = parent;
+      parent = page->Parent;
+   }
+}
+
+
+/* ###### Find leaf page which should contain a node ##################### */
+static struct BPlusTreePage* bPlusTreeFindLeaf(const struct BPlusTree*     bpt,
+                                               const struct BPlusTreeNode* cmpNode)
+{
+   struct BPlusTreePage* page = bpt->Root;
+   unsigned int          low;
+   unsigned int          high;
+   unsigned int          mid;
+
+   while(!page->IsLeaf) {
+      /* Find the last child whose first key is not greater than cmpNode.
+         The first child also takes all nodes smaller than every key. */
+      low  = 1;
+      high = page->Entries;
+      while(low < high) {
+         mid = (low + high) / 2;
+         if(bpt->ComparisonFunction(cmpNode, page->Key[mid]) < 0) {
+            high = mid;
+         }
+         else {
+            low = mid + 1;
+         }
+      }
+      page = page->Child[low - 1];
+   }
+   return(page);
+}
+
+
+/* ###### Get index of first leaf entry not less than cmpNode ############ */
+static unsigned int bPlusTreeLeafLowerBound(const struct BPlusTree*     bpt,
+                                            const struct BPlusTreePage* leaf,
+                                            const struct BPlusTreeNode* cmpNode)
+{
+   unsigned int low  = 0;
+   unsigned int high = leaf->Entries;
+   unsigned int mid;
+
+   while(low < high) {
+      mid = (low + high) / 2;
+      if(bpt->ComparisonFunction(cmpNode, leaf->Key[mid]) > 0) {
+         low = mid + 1;
+      }
+      else {
+         high = mid;
+      }
+   }
+   return(low);
+}
+
+
+/* ###### Get index of first leaf entry greater than cmpNode ############# */
+static unsigned int bPlusTreeLeafUpperBound(const struct BPlusTree*     bpt,
+                                            const struct BPlusTreePage* leaf,
+                                            const struct BPlusTreeNode* cmpNode)
+{
+   unsigned int low  = 0;
+   unsigned int high = leaf->Entries;
+   unsigned int mid;
+
+   while(low < high) {
+      mid = (low + high) / 2;
+      if(bpt->ComparisonFunction(cmpNode, leaf->Key[mid]) >= 0) {
+         low = mid + 1;
+      }
+      else {
+         high = mid;
+      }
+   }
+   return(low);
+}
+
+
+/* ###### Free list of spare pages ####################################### */
+static void bPlusTreeSparePagesDelete(struct BPlusTreePage* spares)
+{
+   struct BPlusTreePage* page;
+
+   while(spares != NULL) {
+      page   = spares;
+      spares = page->Parent;
+      free(page);
+   }
+}
+
+
+/* ###### Allocate pages for the splits of an insertion ################## */
+/*
+   The pages are allocated before the tree is modified, so that an
+   allocation failure leaves the tree unchanged. They are chained by their
+   Parent pointers, in the order in which bPlusTreeSplit() uses them.
+*/
+static int bPlusTreeSparePagesNew(const struct BPlusTreePage* page,
+                                  struct BPlusTreePage**      spares)
+{
+   struct BPlusTreePage** last = spares;
+
+   *spares = NULL;
+   while( (page != NULL) && (page->Entries >= BPLUSTREE_MAX_ENTRIES) ) {
+      *last = bPlusTreePageNew(page->IsLeaf);
+      if( (*last != NULL) && (page->Parent == NULL) ) {
+         /* The root is split as well -> a new root is needed */
+         last  = &(*last)->Parent;
+         *last = bPlusTreePageNew(0);
+      }
+      if(*last == NULL) {
+         bPlusTreeSparePagesDelete(*spares);
+         *spares = NULL;
+         return(0);
+      }
+      last = &(*last)->Parent;
+      page = page->Parent;
+   }
+   return(1);
+}
+
+
+/* ###### Take page from list of spare pages ############################# */
+static struct BPlusTreePage* bPlusTreeSparePagesGet(struct BPlusTreePage** spares)
+{
+   struct BPlusTreePage* page = *spares;
+
+   CHECK(page != NULL);
+   *spares      = page->Parent;
+   page->Parent = NULL;
+   return(page);
+}
+
+
+/* ###### Split overfull pages up to tree root ########################### */
+static void bPlusTreeSplit(struct BPlusTree*      bpt,
+                           struct BPlusTreePage*  page,
+                           struct BPlusTreePage** spares)
+{
+   struct BPlusTreePage* parent;
+   struct BPlusTreePage* right;
+   unsigned int          index;
+
+   while(page->Entries > BPLUSTREE_MAX_ENTRIES) {
+      /* ====== Move upper half into new right sibling =================== */
+      right = bPlusTreeSparePagesGet(spares);
+      CHECK(right->IsLeaf == page->IsLeaf);
+      while(page->Entries > (BPLUSTREE_MAX_ENTRIES + 1) / 2) {
+         bPlusTreePageMoveEntry(page, page->Entries - 1, right, 0);
+      }
+      if(page->IsLeaf) {
+         right->PrevLeaf = page;
+         right->NextLeaf = page->NextLeaf;
+         if(page->NextLeaf != NULL) {
+            page->NextLeaf->PrevLeaf = right;
+         }
+         else {
+            bpt->LastLeaf = right;
+         }
+         page->NextLeaf = right;
+      }
+
+      /* ====== Link new sibling into parent ============================= */
+      parent = page->Parent;
+      if(parent == NULL) {
+         parent = bPlusTreeSparePagesGet(spares);
+         CHECK(!parent->IsLeaf);
+         bPlusTreePageInsertEntry(parent, 0, page->Key[0], page, page->ValueSum);
+         bpt->Root = parent;
+      }
+      index = bPlusTreePageIndexOfChild(parent, page);
+      bPlusTreePageUpdateChildSummary(parent, index);
+      bPlusTreePageInsertEntry(parent, index + 1, right->Key[0], right, right->ValueSum);
+
+      page = parent;
+   }
+}
+
+
+/* ###### Merge right page into left page ################################ */
+static void bPlusTreeMerge(struct BPlusTree*     bpt,
+                           struct BPlusTreePage* parent,
+                           const unsigned int    leftIndex)
+{
+   struct BPlusTreePage* left  = parent->Child[leftIndex];
+   struct BPlusTreePage* right = parent->Child[leftIndex + 1];
+
+   while(right->Entries > 0) {
+      bPlusTreePageMoveEntry(right, 0, left, left->Entries);
+   }
+   if(left->IsLeaf) {
+      left->NextLeaf = right->NextLeaf;
+      if(right->NextLeaf != NULL) {
+         right->NextLeaf->PrevLeaf = left;
+      }
+      else {
+         bpt->LastLeaf = left;
+      }
+   }
+   bPlusTreePageRemoveEntry(parent, leftIndex + 1);
+   bPlusTreePageUpdateChildSummary(parent, leftIndex);
+   free(right);
+}
+
+
+/* ###### Refill underfull pages up to tree root ######################### */
+static void bPlusTreeRebalance(struct BPlusTree*     bpt,
+                               struct BPlusTreePage* page)
+{
+   struct BPlusTreePage* parent;
+   struct BPlusTreePage* left;
+   struct BPlusTreePage* right;
+   unsigned int          index;
+
+   while( (page != bpt->Root) && (page->Entries < BPLUSTREE_MIN_ENTRIES) ) {
+      parent = page->Parent;
+      index  = bPlusTreePageIndexOfChild(parent, page);
+      left   = (index > 0) ? parent->Child[index - 1] : NULL;
+      right  = (index + 1 < parent->Entries) ? parent->Child[index + 1] : NULL;
+
+      /* ====== Borrow entry from a sibling ============================== */
+      if( (left != NULL) && (left->Entries > BPLUSTREE_MIN_ENTRIES) ) {
+         bPlusTreePageMoveEntry(left, left->Entries - 1, page, 0);
+         bPlusTreePageUpdateChildSummary(parent, index - 1);
+         bPlusTreePageUpdateChildSummary(parent, index);
+         return;
+      }
+      if( (right != NULL) && (right->Entries > BPLUSTREE_MIN_ENTRIES) ) {
+         bPlusTreePageMoveEntry(right, 0, page, page->Entries);
+         bPlusTreePageUpdateChildSummary(parent, index);
+         bPlusTreePageUpdateChildSummary(parent, index + 1);
+         return;
+      }
+
+      /* ====== Merge with a sibling ===================================== */
+      if(left != NULL) {
+         bPlusTreeMerge(bpt, parent, index - 1);
+      }
+      else {
+         CHECK(right != NULL);
+         bPlusTreeMerge(bpt, parent, index);
+      }
+      page = parent;
+   }
+
+   /* ====== Remove root having only a single child ====================== */
+   page = bpt->Root;
+   if( (!page->IsLeaf) && (page->Entries == 1) ) {
+      bpt->Root         = page->Child[0];
+      bpt->Root->Parent = NULL;
+      free(page);
+   }
+}
+
+
+/* ##### Initialize ###################################################### */
+void bPlusTreeNew(struct BPlusTree* bpt,
+                  void              (*printFunction)(const void* node, FILE* fd),
+                  int               (*comparisonFunction)(const void* node1, const void* node2))
+{
+   bpt->Root               = NULL;
+   bpt->FirstLeaf          = NULL;
+   bpt->LastLeaf           = NULL;
+   bpt->Elements           = 0;
+   bpt->PrintFunction      = printFunction;
+   bpt->ComparisonFunction = comparisonFunction;
+}
+
+
+/* ##### Invalidate ###################################################### */
+void bPlusTreeDelete(struct BPlusTree* bpt)
+{
+   if(bpt->Root != NULL) {
+      bPlusTreePageDelete(bpt->Root);
+   }
+   bpt->Root      = NULL;
+   bpt->FirstLeaf = NULL;
+   bpt->LastLeaf  = NULL;
+   bpt->Elements  = 0;
+}
+
+
+/* ###### Print tree ##################################################### */
+void bPlusTreePrint(const struct BPlusTree* bpt,
+                    FILE*                   fd)
+{
+   const struct BPlusTreePage* page;
+   unsigned int                i;
+
+   for(page = bpt->FirstLeaf;page != NULL;page = page->NextLeaf) {
+#ifdef DEBUG
+      fprintf(fd, "leaf=%p parent=%p entries=%u vsum=%llu\n",
+              page, page->Parent, page->Entries, page->ValueSum);
+#endif
+      for(i = 0;i < page->Entries;i++) {
+         bpt->PrintFunction(page->Key[i], fd);
+      }
+   }
+   fputs("\n", fd);
+}
+
+
+/* ###### Is tree empty? ################################################# */
+int bPlusTreeIsEmpty(const struct BPlusTree* bpt)
+{
+   return(bpt->Root == NULL);
+}
+
+
+/* ###### Get first node ################################################# */
+struct BPlusTreeNode* bPlusTreeGetFirst(const struct BPlusTree* bpt)
+{
+   if(bpt->FirstLeaf != NULL) {
+      return(bpt->FirstLeaf->Key[0]);
+   }
+   return(NULL);
+}
+
+
+/* ###### Get last node ################################################## */
+struct BPlusTreeNode* bPlusTreeGetLast(const struct BPlusTree* bpt)
+{
+   if(bpt->LastLeaf != NULL) {
+      return(bpt->LastLeaf->Key[bpt->LastLeaf->Entries - 1]);
+   }
+   return(NULL);
+}
+
+
+/* ###### Get previous node ############################################## */
+struct BPlusTreeNode* bPlusTreeGetPrev(const struct BPlusTree*     bpt,
+                                       const struct BPlusTreeNode* node)
+{
+   const struct BPlusTreePage* page  = node->Page;
+   const unsigned int          index = bPlusTreePageIndexOfNode(page, node);
+
+   if(index > 0) {
+      return(page->Key[index - 1]);
+   }
+   page = page->PrevLeaf;
+   if(page != NULL) {
+      return(page->Key[page->Entries - 1]);
+   }
+   return(NULL);
+}
+
+
+/* ###### Get next node ################################################## */
+struct BPlusTreeNode* bPlusTreeGetNext(const struct BPlusTree*     bpt,
+                                       const struct BPlusTreeNode* node)
+{
+   const struct BPlusTreePage* page  = node->Page;
+   const unsigned int          index = bPlusTreePageIndexOfNode(page, node);
+
+   if(index + 1 < page->Entries) {
+      return(page->Key[index + 1]);
+   }
+   page = page->NextLeaf;
+   if(page != NULL) {
+      return(page->Key[0]);
+   }
+   return(NULL);
+}
+
+
+/* ###### Find nearest previous node ##################################### */
+struct BPlusTreeNode* bPlusTreeGetNearestPrev(const struct BPlusTree*     bpt,
+                                              const struct BPlusTreeNode* cmpNode)
+{
+   const struct BPlusTreePage* leaf;
+   unsigned int                index;
+
+   if(bpt->Root == NULL) {
+      return(NULL);
+   }
+   leaf  = bPlusTreeFindLeaf(bpt, cmpNode);
+   index = bPlusTreeLeafLowerBound(bpt, leaf, cmpNode);
+   if(index > 0) {
+      return(leaf->Key[index - 1]);
+   }
+   leaf = leaf->PrevLeaf;
+   if(leaf != NULL) {
+      return(leaf->Key[leaf->Entries - 1]);
+   }
+   return(NULL);
+}
+
+
+/* ###### Find nearest next node ######################################### */
+struct BPlusTreeNode* bPlusTreeGetNearestNext(const struct BPlusTree*     bpt,
+                                              const struct BPlusTreeNode* cmpNode)
+{
+   const struct BPlusTreePage* leaf;
+   unsigned int                index;
+
+   if(bpt->Root == NULL) {
+      return(NULL);
+   }
+   leaf  = bPlusTreeFindLeaf(bpt, cmpNode);
+   index = bPlusTreeLeafUpperBound(bpt, leaf, cmpNode);
+   if(index < leaf->Entries) {
+      return(leaf->Key[index]);
+   }
+   leaf = leaf->NextLeaf;
+   if(leaf != NULL) {
+      return(leaf->Key[0]);
+   }
+   return(NULL);
+}
+
+
+/* ###### Get number of elements ######################################### */
+size_t bPlusTreeGetElements(const struct BPlusTree* bpt)
+{
+   return(bpt->Elements);
+}
+
+
+/* ###### Insert node #################################################### */
+struct BPlusTreeNode* bPlusTreeInsert(struct BPlusTree*     bpt,
+                                      struct BPlusTreeNode* node)
+{
+   struct BPlusTreePage* leaf;
+   struct BPlusTreePage* spares;
+   unsigned int          index;
+
+   CHECK(!bPlusTreeNodeIsLinked(node));
+
+   if(bpt->Root == NULL) {
+      leaf = bPlusTreePageNew(1);
+      if(leaf == NULL) {
+         return(NULL);
+      }
+      spares         = NULL;
+      bpt->Root      = leaf;
+      bpt->FirstLeaf = leaf;
+      bpt->LastLeaf  = leaf;
+      index          = 0;
+   }
+   else {
+      leaf  = bPlusTreeFindLeaf(bpt, node);
+      index = bPlusTreeLeafLowerBound(bpt, leaf, node);
+      if( (index < leaf->Entries) &&
+          (bpt->ComparisonFunction(node, leaf->Key[index]) == 0) ) {
+         return(leaf->Key[index]);
+      }
+      if(!bPlusTreeSparePagesNew(leaf, &spares)) {
+         return(NULL);
+      }
+   }
+
+   bPlusTreePageInsertEntry(leaf, index, node, NULL, node->Value);
+   bpt->Elements++;
+   bPlusTreeUpdateParents(leaf);
+   bPlusTreeSplit(bpt, leaf, &spares);
+   CHECK(spares == NULL);
+   return(node);
+}
+
+
+/* ###### Remove node #################################################### */
+struct BPlusTreeNode* bPlusTreeRemove(struct BPlusTree*     bpt,
+                                      struct BPlusTreeNode* node)
+{
+   struct BPlusTreePage* leaf = node->Page;
+
+   CHECK(bPlusTreeNodeIsLinked(node));
+   CHECK(bpt->Elements > 0);
+
+   bPlusTreePageRemoveEntry(leaf, bPlusTreePageIndexOfNode(leaf, node));
+   node->Page = NULL;
+   bpt->Elements--;
+
+   if(leaf->Entries == 0) {
+      /* Only the root page may become empty */
+      CHECK(leaf == bpt->Root);
+      free(leaf);
+      bpt->Root      = NULL;
+      bpt->FirstLeaf = NULL;
+      bpt->LastLeaf  = NULL;
+   }
+   else {
+      bPlusTreeUpdateParents(leaf);
+      bPlusTreeRebalance(bpt, leaf);
+   }
+   return(node);
+}
+
+
+/* ###### Find node ###################################################### */
+struct BPlusTreeNode* bPlusTreeFind(const struct BPlusTree*     bpt,
+                                    const struct BPlusTreeNode* cmpNode)
+{
+   const struct BPlusTreePage* leaf;
+   unsigned int                index;
+
+   if(bpt->Root == NULL) {
+      return(NULL);
+   }
+   leaf  = bPlusTreeFindLeaf(bpt, cmpNode);
+   index = bPlusTreeLeafLowerBound(bpt, leaf, cmpNode);
+   if( (index < leaf->Entries) &&
+       (bpt->ComparisonFunction(cmpNode, leaf->Key[index]) == 0) ) {
+      return(leaf->Key[index]);
+   }
+   return(NULL);
+}
+
+
+/* ###### Get value sum from root ######################################## */
+BPlusTreeNodeValueType bPlusTreeGetValueSum(const struct BPlusTree* bpt)
+{
+   return((bpt->Root != NULL) ? bpt->Root->ValueSum : 0);
+}
+
+
+/* ###### Get node by value ############################################## */
+struct BPlusTreeNode* bPlusTreeGetNodeByValue(const struct BPlusTree* bpt,
+                                              BPlusTreeNodeValueType  value)
+{
+   const struct BPlusTreePage* page = bpt->Root;
+   unsigned int                i;
+
+   if(page == NULL) {
+      return(NULL);
+   }
+   while(!page->IsLeaf) {
+      for(i = 0;i < page->Entries - 1;i++) {
+         if(value < page->ChildValueSum[i]) {
+            break;
+         }
+         value -= page->ChildValueSum[i];
+      }
+      page = page->Child[i];
+   }
+   for(i = 0;i < page->Entries - 1;i++) {
+      if(value < page->Key[i]->Value) {
+         break;
+      }
+      value -= page->Key[i]->Value;
+   }
+   return(page->Key[i]);
+}
+
+
+/* ##### Internal verification function ################################## */
+static BPlusTreeNodeValueType bPlusTreeInternalVerify(
+                                 struct BPlusTree*            bpt,
+                                 const struct BPlusTreePage*  parent,
+                                 const struct BPlusTreePage*  page,
+                                 const size_t                 depth,
+                                 size_t*                      leafDepth,
+                                 const struct BPlusTreeNode** lastNode,
+                                 const struct BPlusTreePage** lastLeaf,
+                                 size_t*                      counter)
+{
+   BPlusTreeNodeValueType valueSum = 0;
+   unsigned int           i;
+
+   /* ====== Correct parent and fill level? ============================== */
+   CHECK(page->Parent == parent);
+   CHECK(page->Entries > 0);
+   CHECK(page->Entries <= BPLUSTREE_MAX_ENTRIES);
+   if(page != bpt->Root) {
+      CHECK(page->Entries >= BPLUSTREE_MIN_ENTRIES);
+   }
+
+   if(page->IsLeaf) {
+      /* ====== All leaves at same depth? ================================ */
+      if(*leafDepth == 0) {
+         *leafDepth = depth;
+      }
+      CHECK(*leafDepth == depth);
+
+      /* ====== Is leaf list okay? ======================================= */
+      CHECK(page->PrevLeaf == *lastLeaf);
+      if(*lastLeaf != NULL) {
+         CHECK((*lastLeaf)->NextLeaf == page);
+      }
+      else {
+         CHECK(bpt->FirstLeaf == page);
+      }
+      *lastLeaf = page;
+
+      /* ====== Correct order and node linkage? ========================== */
+      for(i = 0;i < page->Entries;i++) {
+         CHECK(page->Key[i]->Page == page);
+         if(*lastNode != NULL) {
+            CHECK(bpt->ComparisonFunction(*lastNode, page->Key[i]) < 0);
+         }
+         *lastNode = page->Key[i];
+         valueSum += page->Key[i]->Value;
+         (*counter)++;
+      }
+   }
+   else {
+      /* ====== Are children okay? ======================================= */
+      for(i = 0;i < page->Entries;i++) {
+         CHECK(page->Key[i] == page->Child[i]->Key[0]);
+         CHECK(page->ChildValueSum[i] ==
+                  bPlusTreeInternalVerify(bpt, page, page->Child[i], depth + 1,
+                                          leafDepth, lastNode, lastLeaf, counter));
+         valueSum += page->ChildValueSum[i];
+      }
+   }
+
+   /* ====== Is value sum okay? ========================================== */
+   CHECK(page->ValueSum == valueSum);
+   return(valueSum);
+}
+
+
+/* ##### Verify structures ############################################### */
+void bPlusTreeVerify(struct BPlusTree* bpt)
+{
+   size_t                      counter   = 0;
+   size_t                      leafDepth = 0;
+   const struct BPlusTreeNode* lastNode  = NULL;
+   const struct BPlusTreePage* lastLeaf  = NULL;
+
+   if(bpt->Root == NULL) {
+      CHECK(bpt->FirstLeaf == NULL);
+      CHECK(bpt->LastLeaf == NULL);
+   }
+   else {
+      bPlusTreeInternalVerify(bpt, NULL, bpt->Root, 1, &leafDepth,
+                              &lastNode, &lastLeaf, &counter);
+      CHECK(bpt->LastLeaf == lastLeaf);
+      CHECK(lastLeaf->NextLeaf == NULL);
+   }
+   CHECK(counter == bpt->Elements);
+}
+
+
+#ifdef __cplusplus
+}
+#endif
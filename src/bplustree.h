@@ -0,0 +1,133 @@
+/* --------------------------------------------------------------------------
+ *
+ *              //===//   //=====   //===//   //=====  //   //      //
+ *             //    //  //        //    //  //       //   //=/  /=//
+ *            //===//   //=====   //===//   //====   //   //  //  //
+ *           //   \\         //  //             //  //   //  //  //
+ *          //     \\  =====//  //        =====//  //   //      //  Version V
+ *
+ * ------------- An Open Source RSerPool Simulation for OMNeT++ -------------
+ *
+ * Copyright (C) 2003-2026 by Thomas Dreibholz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: thomas.dreibholz@gmail.com
+ */
+
+#ifndef BPLUSTREE_H
+#define BPLUSTREE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+   Leaf-linked B+-tree with wide pages. The leaf pages hold pointers to
+   the stored nodes in sorting order, the inner pages hold pointers to
+   their child pages together with each child's first node and value
+   sum. A page holds up to BPLUSTREE_MAX_ENTRIES entries; all pages
+   except the root hold at least BPLUSTREE_MIN_ENTRIES entries.
+   bPlusTreeInsert() returns NULL and leaves the tree unchanged if a page
+   cannot be allocated.
+*/
+#define BPLUSTREE_MAX_ENTRIES 16
+#define BPLUSTREE_MIN_ENTRIES (BPLUSTREE_MAX_ENTRIES / 2)
+
+typedef unsigned long long BPlusTreeNodeValueType;
+
+
+struct BPlusTreePage;
+
+struct BPlusTreeNode
+{
+   struct BPlusTreePage*  Page;   /* Leaf page containing the node, NULL if not linked */
+   BPlusTreeNodeValueType Value;
+};
+
+struct BPlusTreePage
+{
+   struct BPlusTreePage*  Parent;
+   struct BPlusTreePage*  PrevLeaf;
+   struct BPlusTreePage*  NextLeaf;
+   BPlusTreeNodeValueType ValueSum;
+   unsigned int           Entries;
+   int                    IsLeaf;
+
+   /* Leaf page:  the nodes
+      Inner page: the first node of each child page's subtree
+      One additional entry is used temporarily before a page is split. */
+   struct BPlusTreeNode*  Key[BPLUSTREE_MAX_ENTRIES + 1];
+
+   /* Inner pages only, these arrays are not allocated for leaf pages */
+   struct BPlusTreePage*  Child[BPLUSTREE_MAX_ENTRIES + 1];
+   BPlusTreeNodeValueType ChildValueSum[BPLUSTREE_MAX_ENTRIES + 1];
+};
+
+struct BPlusTree
+{
+   struct BPlusTreePage* Root;
+   struct BPlusTreePage* FirstLeaf;
+   struct BPlusTreePage* LastLeaf;
+   size_t                Elements;
+   void                  (*PrintFunction)(const void* node, FILE* fd);
+   int                   (*ComparisonFunction)(const void* node1, const void* node2);
+};
+
+
+void bPlusTreeNodeNew(struct BPlusTreeNode* node);
+void bPlusTreeNodeDelete(struct BPlusTreeNode* node);
+int bPlusTreeNodeIsLinked(const struct BPlusTreeNode* node);
+
+
+void bPlusTreeNew(struct BPlusTree* bpt,
+                  void              (*printFunction)(const void* node, FILE* fd),
+                  int               (*comparisonFunction)(const void* node1, const void* node2));
+void bPlusTreeDelete(struct BPlusTree* bpt);
+void bPlusTreeVerify(struct BPlusTree* bpt);
+void bPlusTreePrint(const struct BPlusTree* bpt,
+                    FILE*                   fd);
+int bPlusTreeIsEmpty(const struct BPlusTree* bpt);
+struct BPlusTreeNode* bPlusTreeGetFirst(const struct BPlusTree* bpt);
+struct BPlusTreeNode* bPlusTreeGetLast(const struct BPlusTree* bpt);
+struct BPlusTreeNode* bPlusTreeGetPrev(const struct BPlusTree*     bpt,
+                                       const struct BPlusTreeNode* node);
+struct BPlusTreeNode* bPlusTreeGetNext(const struct BPlusTree*     bpt,
+                                       const struct BPlusTreeNode* node);
+struct BPlusTreeNode* bPlusTreeGetNearestPrev(const struct BPlusTree*     bpt,
+                                              const struct BPlusTreeNode* cmpNode);
+struct BPlusTreeNode* bPlusTreeGetNearestNext(const struct BPlusTree*     bpt,
+                                              const struct BPlusTreeNode* cmpNode);
+size_t bPlusTreeGetElements(const struct BPlusTree* bpt);
+struct BPlusTreeNode* bPlusTreeInsert(struct BPlusTree*     bpt,
+                                      struct BPlusTreeNode* node);
+struct BPlusTreeNode* bPlusTreeRemove(struct BPlusTree*     bpt,
+                                      struct BPlusTreeNode* node);
+struct BPlusTreeNode* bPlusTreeFind(const struct BPlusTree*     bpt,
+                                    const struct BPlusTreeNode* cmpNode);
+BPlusTreeNodeValueType bPlusTreeGetValueSum(const struct BPlusTree* bpt);
+struct BPlusTreeNode* bPlusTreeGetNodeByValue(const struct BPlusTree* bpt,
+                                              BPlusTreeNodeValueType  value);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
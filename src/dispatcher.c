@@ -43,6 +43,9 @@
 #include <math.h>
 #include <netinet/in.h>
 #include <ext_socket.h>
+#ifdef HAVE_EPOLL
+#include <unistd.h>
+#endif
 
 
 static void dispatcherDefaultLock(struct Dispatcher* dispatcher, void* userData);
@@ -56,9 +59,11 @@ void dispatcherNew(struct Dispatcher* dispatcher,
                    void*              lockUserData)
 {
    simpleRedBlackTreeNew(&dispatcher->TimerStorage, NULL, timerComparison);
+   dispatcher->TimerWheel = NULL;
    simpleRedBlackTreeNew(&dispatcher->FDCallbackStorage, NULL, fdCallbackComparison);
 
    dispatcher->AddRemove    = false;
+   dispatcher->EPollFD      = -1;
    dispatcher->LockUserData = lockUserData;
 
    if(lock != NULL) {
@@ -81,6 +86,12 @@ void dispatcherDelete(struct Dispatcher* dispatcher)
 {
    CHECK(simpleRedBlackTreeIsEmpty(&dispatcher->TimerStorage));
    CHECK(simpleRedBlackTreeIsEmpty(&dispatcher->FDCallbackStorage));
+   dispatcherSetEPollMode(dispatcher, false);
+   if(dispatcher->TimerWheel != NULL) {
+      timingWheelDelete(dispatcher->TimerWheel);
+      free(dispatcher->TimerWheel);
+      dispatcher->TimerWheel = NULL;
+   }
    simpleRedBlackTreeDelete(&dispatcher->TimerStorage);
    simpleRedBlackTreeDelete(&dispatcher->FDCallbackStorage);
    dispatcher->Lock         = NULL;
@@ -117,6 +128,88 @@ static void dispatcherDefaultUnlock(struct Dispatcher* dispatcher, void* userDat
 }
 
 
+/* ###### Get timeout until next timer event ############################ */
+static int dispatcherGetTimeout(struct Dispatcher*       dispatcher,
+                                const unsigned long long now)
+{
+   struct SimpleRedBlackTreeNode* node;
+   struct Timer*                  timer;
+   unsigned long long             timeStamp;
+   long long                      timeToNextEvent;
+
+   if(dispatcher->TimerWheel != NULL) {
+      timeStamp = timingWheelGetNextTimeStamp(dispatcher->TimerWheel);
+      if(timeStamp == ~0ULL) {
+         return(-1);
+      }
+      timeToNextEvent = max((long long)0, (long long)timeStamp - (long long)now);
+      return((int)ceil((double)timeToNextEvent / 1000.0));
+   }
+
+   node = simpleRedBlackTreeGetFirst(&dispatcher->TimerStorage);
+   if(node != NULL) {
+      timer = (struct Timer*)node;
+      timeToNextEvent = max((long long)0, (long long)timer->TimeStamp - (long long)now);
+      return((int)ceil((double)timeToNextEvent / 1000.0));
+   }
+   return(-1);
+}
+
+
+/* ###### Handle expired timers ########################################## */
+static void dispatcherHandleTimerEvents(struct Dispatcher* dispatcher)
+{
+   unsigned long long             now;
+   struct SimpleRedBlackTreeNode* node;
+   struct Timer*                  timer;
+
+   /* Timers must be handled after the FD callbacks, since
+      they might modify the FDs' states (e.g. completely
+      reading their buffers, establishing new associations, ...)! */
+   LOG_VERBOSE4
+   fputs("Handling timer events...\n", stdlog);
+   LOG_END
+   now  = getMicroTime();
+
+   /* ====== Timing wheel: handle all expired timers in one batch ======= */
+   if(dispatcher->TimerWheel != NULL) {
+      while((timer = timingWheelGetNextExpiredTimer(dispatcher->TimerWheel, now)) != NULL) {
+         timer->TimeStamp = 0;
+         if(timer->Callback != NULL) {
+            dispatcherUnlock(dispatcher);
+            timer->Callback(dispatcher, timer, timer->UserData);
+            dispatcherLock(dispatcher);
+         }
+      }
+      return;
+   }
+
+   /* ====== Red-black tree ============================================= */
+   node = simpleRedBlackTreeGetFirst(&dispatcher->TimerStorage);
+   while(node != NULL) {
+      timer = (struct Timer*)node;
+
+      if(dispatcher->AddRemove == true) {
+         break;
+      }
+      if(now >= timer->TimeStamp) {
+         timer->TimeStamp = 0;
+         simpleRedBlackTreeRemove(&dispatcher->TimerStorage,
+                                  &timer->Node);
+         if(timer->Callback != NULL) {
+            dispatcherUnlock(dispatcher);
+            timer->Callback(dispatcher, timer, timer->UserData);
+            dispatcherLock(dispatcher);
+         }
+      }
+      else {
+         break;
+      }
+      node = simpleRedBlackTreeGetFirst(&dispatcher->TimerStorage);
+   }
+}
+
+
 /* ###### Get poll() parameters ########################################## */
 void dispatcherGetPollParameters(struct Dispatcher*  dispatcher,
                                  struct pollfd*      ufds,
@@ -126,8 +219,6 @@ void dispatcherGetPollParameters(struct Dispatcher*  dispatcher,
 {
    struct SimpleRedBlackTreeNode* node;
    struct FDCallback*             fdCallback;
-   struct Timer*                  timer;
-   long long                      timeToNextEvent;
 
    *nfds    = 0;
    *timeout = -1;
@@ -154,15 +245,7 @@ void dispatcherGetPollParameters(struct Dispatcher*  dispatcher,
       }
 
       /*  ====== Get time to next timer event ============================ */
-      node = simpleRedBlackTreeGetFirst(&dispatcher->TimerStorage);
-      if(node != NULL) {
-         timer = (struct Timer*)node;
-         timeToNextEvent = max((long long)0, (long long)timer->TimeStamp - (long long)*pollTimeStamp);
-         *timeout = (int)ceil((double)timeToNextEvent / 1000.0);
-      }
-      else {
-         *timeout = -1;
-      }
+      *timeout = dispatcherGetTimeout(dispatcher, *pollTimeStamp);
 
       dispatcherUnlock(dispatcher);
    }
@@ -193,11 +276,8 @@ void dispatcherHandlePollResult(struct Dispatcher* dispatcher,
                                 int                timeout,
                                 unsigned long long pollTimeStamp)
 {
-   unsigned long long             now;
-   struct SimpleRedBlackTreeNode* node;
-   struct Timer*                  timer;
-   struct FDCallback*             fdCallback;
-   unsigned int                   i;
+   struct FDCallback* fdCallback;
+   unsigned int       i;
 
    if(dispatcher != NULL) {
       dispatcherLock(dispatcher);
@@ -256,35 +336,7 @@ void dispatcherHandlePollResult(struct Dispatcher* dispatcher,
       }
 
       /* ====== Handle timer events ====================================== */
-      /* Timers must be handled after the FD callbacks, since
-         they might modify the FDs' states (e.g. completely
-         reading their buffers, establishing new associations, ...)! */
-      LOG_VERBOSE4
-      fputs("Handling timer events...\n", stdlog);
-      LOG_END
-      now  = getMicroTime();
-      node = simpleRedBlackTreeGetFirst(&dispatcher->TimerStorage);
-      while(node != NULL) {
-         timer = (struct Timer*)node;
-
-         if(dispatcher->AddRemove == true) {
-            break;
-         }
-         if(now >= timer->TimeStamp) {
-            timer->TimeStamp = 0;
-            simpleRedBlackTreeRemove(&dispatcher->TimerStorage,
-                                     &timer->Node);
-            if(timer->Callback != NULL) {
-               dispatcherUnlock(dispatcher);
-               timer->Callback(dispatcher, timer, timer->UserData);
-               dispatcherLock(dispatcher);
-            }
-         }
-         else {
-            break;
-         }
-         node = simpleRedBlackTreeGetFirst(&dispatcher->TimerStorage);
-      }
+      dispatcherHandleTimerEvents(dispatcher);
 
       dispatcherUnlock(dispatcher);
    }
@@ -301,6 +353,12 @@ void dispatcherEventLoop(struct Dispatcher* dispatcher)
    int                  result;
 
    if(dispatcher != NULL) {
+#ifdef HAVE_EPOLL
+      if(dispatcher->EPollFD >= 0) {
+         dispatcherEPollEventLoop(dispatcher, -1);
+         return;
+      }
+#endif
       dispatcherGetPollParameters(dispatcher,
                                  (struct pollfd*)&ufds, &nfds, &timeout,
                                  &pollTimeStamp);
@@ -310,3 +368,263 @@ void dispatcherEventLoop(struct Dispatcher* dispatcher)
                                  pollTimeStamp);
    }
 }
+
+
+#ifdef HAVE_EPOLL
+/* ###### Convert FDCallback event mask to epoll() events ################ */
+static uint32_t dispatcherEventMaskToEPollEvents(const unsigned int eventMask)
+{
+   uint32_t events = 0;
+   if(eventMask & POLLIN) {
+      events |= EPOLLIN;
+   }
+   if(eventMask & POLLOUT) {
+      events |= EPOLLOUT;
+   }
+   if(eventMask & POLLPRI) {
+      events |= EPOLLPRI;
+   }
+   return(events);
+}
+
+
+/* ###### Convert epoll() events to FDCallback event mask ################ */
+static unsigned int dispatcherEPollEventsToEventMask(const uint32_t events)
+{
+   unsigned int eventMask = 0;
+   if(events & EPOLLIN) {
+      eventMask |= POLLIN;
+   }
+   if(events & EPOLLOUT) {
+      eventMask |= POLLOUT;
+   }
+   if(events & EPOLLPRI) {
+      eventMask |= POLLPRI;
+   }
+   if(events & EPOLLHUP) {
+      eventMask |= POLLHUP;
+   }
+   if(events & EPOLLERR) {
+      eventMask |= POLLERR;
+   }
+   return(eventMask);
+}
+#endif
+
+
+/* ###### Switch between poll() and epoll() mode ######################### */
+bool dispatcherSetEPollMode(struct Dispatcher* dispatcher,
+                            const bool         useEPoll)
+{
+#ifdef HAVE_EPOLL
+   struct SimpleRedBlackTreeNode* node;
+
+   dispatcherLock(dispatcher);
+   if((useEPoll) && (dispatcher->EPollFD < 0)) {
+      dispatcher->EPollFD = epoll_create1(EPOLL_CLOEXEC);
+      if(dispatcher->EPollFD >= 0) {
+         /* ====== Add already registered FDCallbacks ===================== */
+         node = simpleRedBlackTreeGetFirst(&dispatcher->FDCallbackStorage);
+         while(node != NULL) {
+            dispatcherUpdateEPollInterestSet(dispatcher, (struct FDCallback*)node,
+                                             EPOLL_CTL_ADD);
+            node = simpleRedBlackTreeGetNext(&dispatcher->FDCallbackStorage, node);
+         }
+      }
+      else {
+         LOG_WARNING
+         logerror("epoll_create1() failed -> using poll()");
+         LOG_END
+      }
+   }
+   else if((!useEPoll) && (dispatcher->EPollFD >= 0)) {
+      /* ====== poll() cannot handle descriptors beyond FD_SETSIZE ======= */
+      node = simpleRedBlackTreeGetLast(&dispatcher->FDCallbackStorage);
+      if( (node != NULL) && (((struct FDCallback*)node)->FD >= (int)FD_SETSIZE) ) {
+         LOG_WARNING
+         fprintf(stdlog, "Socket %d exceeds FD_SETSIZE -> staying in epoll() mode\n",
+                 ((struct FDCallback*)node)->FD);
+         LOG_END
+      }
+      else {
+         close(dispatcher->EPollFD);
+         dispatcher->EPollFD = -1;
+      }
+   }
+   dispatcher->AddRemove = true;
+   dispatcherUnlock(dispatcher);
+   return(dispatcher->EPollFD >= 0);
+#else
+   return(false);
+#endif
+}
+
+
+/* ###### Select timer storage ########################################## */
+bool dispatcherSetTimingWheelMode(struct Dispatcher*       dispatcher,
+                                  const unsigned long long tickLength)
+{
+   struct TimingWheel*            timingWheel = NULL;
+   struct SimpleRedBlackTreeNode* node;
+   struct Timer*                  timer;
+
+   if(tickLength > 0) {
+      timingWheel = (struct TimingWheel*)malloc(sizeof(struct TimingWheel));
+      if(timingWheel == NULL) {
+         return(dispatcherIsInTimingWheelMode(dispatcher));
+      }
+      timingWheelNew(timingWheel, tickLength, getMicroTime());
+   }
+
+   dispatcherLock(dispatcher);
+   /* ====== Move running timers into the new storage =================== */
+   if(timingWheel != NULL) {
+      while((node = simpleRedBlackTreeGetFirst(&dispatcher->TimerStorage)) != NULL) {
+         timer = (struct Timer*)node;
+         simpleRedBlackTreeRemove(&dispatcher->TimerStorage, &timer->Node);
+         timingWheelInsert(timingWheel, timer);
+      }
+   }
+   if(dispatcher->TimerWheel != NULL) {
+      while((timer = timingWheelGetAnyTimer(dispatcher->TimerWheel)) != NULL) {
+         timingWheelRemove(dispatcher->TimerWheel, timer);
+         if(timingWheel != NULL) {
+            timingWheelInsert(timingWheel, timer);
+         }
+         else {
+            simpleRedBlackTreeInsert(&dispatcher->TimerStorage, &timer->Node);
+         }
+      }
+      timingWheelDelete(dispatcher->TimerWheel);
+      free(dispatcher->TimerWheel);
+   }
+   dispatcher->TimerWheel = timingWheel;
+   dispatcher->AddRemove  = true;
+   dispatcherUnlock(dispatcher);
+
+   return(timingWheel != NULL);
+}
+
+
+/* ###### Check whether dispatcher uses the timing wheel ################# */
+bool dispatcherIsInTimingWheelMode(const struct Dispatcher* dispatcher)
+{
+   return(dispatcher->TimerWheel != NULL);
+}
+
+
+/* ###### Check whether dispatcher is in epoll() mode #################### */
+bool dispatcherIsInEPollMode(const struct Dispatcher* dispatcher)
+{
+   return(dispatcher->EPollFD >= 0);
+}
+
+
+/* ###### Update epoll() interest set #################################### */
+void dispatcherUpdateEPollInterestSet(struct Dispatcher* dispatcher,
+                                      struct FDCallback* fdCallback,
+                                      const int          operation)
+{
+#ifdef HAVE_EPOLL
+   struct epoll_event event;
+   int                epollOperation = operation;
+   int                result;
+
+   if(dispatcher->EPollFD >= 0) {
+      /* FDCallbacks without events are not kept in the interest set, since
+         epoll() would otherwise report EPOLLHUP and EPOLLERR for them. */
+      if(fdCallback->EventMask == 0) {
+         if(epollOperation == EPOLL_CTL_ADD) {
+            return;
+         }
+         epollOperation = EPOLL_CTL_DEL;
+      }
+
+      event.events   = dispatcherEventMaskToEPollEvents(fdCallback->EventMask);
+      event.data.ptr = fdCallback;
+      result = epoll_ctl(dispatcher->EPollFD, epollOperation, fdCallback->FD, &event);
+      if( (result < 0) && (epollOperation == EPOLL_CTL_MOD) && (errno == ENOENT) ) {
+         /* The FDCallback had no events before */
+         result = epoll_ctl(dispatcher->EPollFD, EPOLL_CTL_ADD, fdCallback->FD, &event);
+      }
+      if(result < 0) {
+         /* The socket may already be closed when its FDCallback is removed.
+            In this case, the kernel has already removed it. */
+         if(epollOperation != EPOLL_CTL_DEL) {
+            LOG_ERROR
+            logerror("epoll_ctl() failed");
+            LOG_END
+         }
+      }
+   }
+#endif
+}
+
+
+/* ###### Dispatcher event loop using epoll() ############################ */
+int dispatcherEPollEventLoop(struct Dispatcher* dispatcher,
+                             const int          maxTimeout)
+{
+#ifdef HAVE_EPOLL
+   struct epoll_event events[DISPATCHER_MAX_EPOLL_EVENTS];
+   struct FDCallback* fdCallback;
+   unsigned int       eventMask;
+   int                timeout;
+   int                result;
+   int                i;
+
+   CHECK(dispatcher->EPollFD >= 0);
+
+   /* ====== Get time to next timer event =============================== */
+   dispatcherLock(dispatcher);
+   timeout = dispatcherGetTimeout(dispatcher, getMicroTime());
+   dispatcher->AddRemove = false;
+   dispatcherUnlock(dispatcher);
+   if( (maxTimeout >= 0) && ((timeout < 0) || (timeout > maxTimeout)) ) {
+      timeout = maxTimeout;
+   }
+
+   /* ====== Wait for events ============================================ */
+   result = epoll_wait(dispatcher->EPollFD, (struct epoll_event*)&events,
+                       DISPATCHER_MAX_EPOLL_EVENTS, timeout);
+
+   dispatcherLock(dispatcher);
+   /* If FDCallbacks have been added or removed during epoll_wait(),
+      the returned pointers may be invalid. Since the descriptors are
+      level-triggered, their events will simply be reported again. */
+   if((result > 0) && (dispatcher->AddRemove == false)) {
+      LOG_VERBOSE4
+      fputs("Handling FD events...\n", stdlog);
+      LOG_END
+      for(i = 0;i < result;i++) {
+         fdCallback = (struct FDCallback*)events[i].data.ptr;
+         eventMask  = dispatcherEPollEventsToEventMask(events[i].events);
+         if(eventMask & fdCallback->EventMask) {
+            LOG_VERBOSE4
+            fprintf(stdlog,"Event $%04x (mask $%04x) for socket %d\n",
+                    eventMask, fdCallback->EventMask, fdCallback->FD);
+            LOG_END
+
+            if(fdCallback->Callback != NULL) {
+               dispatcherUnlock(dispatcher);
+               fdCallback->Callback(dispatcher,
+                                    fdCallback->FD, eventMask,
+                                    fdCallback->UserData);
+               dispatcherLock(dispatcher);
+               if(dispatcher->AddRemove == true) {
+                  break;
+               }
+            }
+         }
+      }
+   }
+
+   /* ====== Handle timer events ======================================== */
+   dispatcherHandleTimerEvents(dispatcher);
+   dispatcherUnlock(dispatcher);
+
+   return(result);
+#else
+   return(-1);
+#endif
+}
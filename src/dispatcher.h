@@ -39,10 +39,14 @@
 
 #include "tdtypes.h"
 #include "timer.h"
+#include "timingwheel.h"
 #include "fdcallback.h"
 #include "simpleredblacktree.h"
 
 #include <poll.h>
+#ifdef HAVE_EPOLL
+#include <sys/epoll.h>
+#endif
 
 
 #ifdef __cplusplus
@@ -50,11 +54,18 @@ extern "C" {
 #endif
 
 
+#define DISPATCHER_MAX_EPOLL_EVENTS 256
+
+
+struct FDCallback;
+
 struct Dispatcher
 {
    struct SimpleRedBlackTree TimerStorage;
+   struct TimingWheel*       TimerWheel;
    struct SimpleRedBlackTree FDCallbackStorage;
    bool                      AddRemove;
+   int                       EPollFD;
 
    void                      (*Lock)(struct Dispatcher* dispatcher, void* userData);
    void                      (*Unlock)(struct Dispatcher* dispatcher, void* userData);
@@ -128,8 +139,75 @@ void dispatcherHandlePollResult(struct Dispatcher* dispatcher,
                                 int                timeout,
                                 unsigned long long pollTimeStamp);
 
+/**
+  * Switch between poll() and epoll() mode. In epoll() mode, the kernel
+  * interest set is only updated when FDCallbacks are added, updated or
+  * removed. Events are then dispatched directly to the FDCallback.
+  * Switching back to poll() is refused while an FDCallback for a
+  * descriptor beyond FD_SETSIZE is registered.
+  *
+  * @param dispatcher Dispatcher.
+  * @param useEPoll true to use epoll(), false to use poll().
+  * @return true, if epoll() mode is active after the call; false otherwise.
+  */
+bool dispatcherSetEPollMode(struct Dispatcher* dispatcher,
+                            const bool         useEPoll);
+
+/**
+  * Check whether dispatcher is in epoll() mode.
+  *
+  * @param dispatcher Dispatcher.
+  * @return true, if epoll() mode is active; false otherwise.
+  */
+bool dispatcherIsInEPollMode(const struct Dispatcher* dispatcher);
+
+/**
+  * Select the timer storage. Timers are either kept in a red-black tree
+  * or in a hashed hierarchical timing wheel with O(1) start, stop and
+  * restart. Running timers are moved into the new storage.
+  *
+  * @param dispatcher Dispatcher.
+  * @param tickLength Tick length of the timing wheel in microseconds (0 for red-black tree).
+  * @return true, if the timing wheel is used after the call; false otherwise.
+  */
+bool dispatcherSetTimingWheelMode(struct Dispatcher*       dispatcher,
+                                  const unsigned long long tickLength);
+
+/**
+  * Check whether dispatcher uses the timing wheel.
+  *
+  * @param dispatcher Dispatcher.
+  * @return true, if the timing wheel is used; false otherwise.
+  */
+bool dispatcherIsInTimingWheelMode(const struct Dispatcher* dispatcher);
+
+/**
+  * Add, modify or remove an FDCallback in the epoll() interest set.
+  * This function is called by the FDCallback functions and does nothing
+  * if the dispatcher is not in epoll() mode.
+  *
+  * @param dispatcher Dispatcher.
+  * @param fdCallback FDCallback.
+  * @param operation EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL.
+  */
+void dispatcherUpdateEPollInterestSet(struct Dispatcher* dispatcher,
+                                      struct FDCallback* fdCallback,
+                                      const int          operation);
+
+/**
+  * Wait for events using epoll_wait() and handle them. The dispatcher
+  * must be in epoll() mode.
+  *
+  * @param dispatcher Dispatcher.
+  * @param maxTimeout Maximum timeout in milliseconds (-1 for none).
+  * @return Result of epoll_wait().
+  */
+int dispatcherEPollEventLoop(struct Dispatcher* dispatcher,
+                             const int          maxTimeout);
+
 /**
   * Event loop calling dispatcherGetSelectParameters(), select() and dispatcherHandleSelectResult().
+  * In epoll() mode, dispatcherEPollEventLoop() is used instead.
   *
   * @param dispatcher Dispatcher.
   *
@@ -51,7 +51,8 @@ void fdCallbackNew(struct FDCallback* fdCallback,
                    void*              userData)
 {
    struct SimpleRedBlackTreeNode* result;
-   CHECK((fd >= 0) && (fd < (int)FD_SETSIZE));
+   CHECK((fd >= 0) &&
+         ((fd < (int)FD_SETSIZE) || (dispatcherIsInEPollMode(dispatcher))));
 
    simpleRedBlackTreeNodeNew(&fdCallback->Node);
    fdCallback->Master          = dispatcher;
@@ -65,6 +66,9 @@ void fdCallbackNew(struct FDCallback* fdCallback,
    result = simpleRedBlackTreeInsert(&fdCallback->Master->FDCallbackStorage,
                                      &fdCallback->Node);
    CHECK(result == &fdCallback->Node);
+#ifdef HAVE_EPOLL
+   dispatcherUpdateEPollInterestSet(fdCallback->Master, fdCallback, EPOLL_CTL_ADD);
+#endif
    fdCallback->Master->AddRemove = true;
    dispatcherUnlock(fdCallback->Master);
 }
@@ -80,6 +84,9 @@ void fdCallbackDelete(struct FDCallback* fdCallback)
    result = simpleRedBlackTreeRemove(&fdCallback->Master->FDCallbackStorage,
                                          &fdCallback->Node);
    CHECK(result == &fdCallback->Node);
+#ifdef HAVE_EPOLL
+   dispatcherUpdateEPollInterestSet(fdCallback->Master, fdCallback, EPOLL_CTL_DEL);
+#endif
    fdCallback->Master->AddRemove = true;
    dispatcherUnlock(fdCallback->Master);
 
@@ -98,7 +105,12 @@ void fdCallbackUpdate(struct FDCallback* fdCallback,
                       const unsigned int eventMask)
 {
    dispatcherLock(fdCallback->Master);
-   fdCallback->EventMask = eventMask;
+   if(fdCallback->EventMask != eventMask) {
+      fdCallback->EventMask = eventMask;
+#ifdef HAVE_EPOLL
+      dispatcherUpdateEPollInterestSet(fdCallback->Master, fdCallback, EPOLL_CTL_MOD);
+#endif
+   }
    dispatcherUnlock(fdCallback->Master);
 }
 
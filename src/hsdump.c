@@ -115,7 +115,7 @@ int main(int argc, char** argv)
       exit(1);
    }
 
-   registrarID = random32();
+   registrarID = secureRandom32();
    ST_CLASS(poolHandlespaceManagementNew)(&handlespace,
                                           registrarID,
                                           NULL, NULL, NULL);
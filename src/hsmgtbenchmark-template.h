@@ -0,0 +1,208 @@
+/* --------------------------------------------------------------------------
+ *
+ *              //===//   //=====   //===//   //       //   //===//
+ *             //    //  //        //    //  //       //   //    //
+ *            //===//   //=====   //===//   //       //   //===<<
+ *           //   \\         //  //        //       //   //    //
+ *          //     \\  =====//  //        //=====  //   //===//   Version III
+ *
+ * ------------- An Efficient RSerPool Prototype Implementation -------------
+ *
+ * Copyright (C) 2002-2026 by Thomas Dreibholz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: thomas.dreibholz@gmail.com
+ */
+
+/* Instantiated by hsmgtbenchmark.c for each storage backend */
+
+
+/* ###### Run benchmark for one policy ################################### */
+static void ST_CLASS(hsmgtBenchmarkPolicy)(const char*                        backendName,
+                                           const struct ST_CLASS(PoolPolicy)* poolPolicy,
+                                           const size_t                       pools,
+                                           const size_t                       poolElementsPerPool,
+                                           const size_t                       minOperations)
+{
+   char                                       transportAddressBlockBuffer[transportAddressBlockGetSize(1)];
+   struct TransportAddressBlock*              transportAddressBlock = (struct TransportAddressBlock*)&transportAddressBlockBuffer;
+   union sockaddr_union                       address;
+   struct ST_CLASS(PoolHandlespaceManagement) handlespace;
+   struct PoolPolicySettings                  poolPolicySettings;
+   struct BenchmarkResults                    results;
+   struct PoolHandle*                         poolHandleArray;
+   struct ST_CLASS(PoolElementNode)**         poolElementNodeArray;
+   struct ST_CLASS(PoolElementNode)*          poolElementNode;
+   struct ST_CLASS(PoolElementNode)*          nextPoolElementNode;
+   struct ST_CLASS(PoolElementNode)*          selectionArray[BENCHMARK_HANDLE_RESOLUTION_ITEMS];
+   char                                       poolName[32];
+   const size_t                               poolElements = pools * poolElementsPerPool;
+   const size_t                               rounds       = (minOperations + poolElements - 1) / poolElements;
+   unsigned long long                         start;
+   size_t                                     selected;
+   size_t                                     remaining;
+   size_t                                     round;
+   size_t                                     i, j, k;
+   unsigned int                               errorCode;
+
+   poolHandleArray      = (struct PoolHandle*)malloc(pools * sizeof(struct PoolHandle));
+   poolElementNodeArray = (struct ST_CLASS(PoolElementNode)**)malloc(
+                             poolElements * sizeof(struct ST_CLASS(PoolElementNode)*));
+   if((poolHandleArray == NULL) || (poolElementNodeArray == NULL)) {
+      fputs("ERROR: Out of memory!\n", stderr);
+      exit(1);
+   }
+
+   memset(&address, 0, sizeof(address));
+   address.in.sin_family      = AF_INET;
+   address.in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   transportAddressBlockNew(transportAddressBlock, IPPROTO_SCTP, 1234, 0, &address, 1, 1);
+   for(i = 0;i < pools;i++) {
+      snprintf((char*)&poolName, sizeof(poolName), "BenchmarkPool-%u", (unsigned int)i);
+      poolHandleNew(&poolHandleArray[i], (const unsigned char*)&poolName, strlen(poolName));
+   }
+
+   ST_CLASS(poolHandlespaceManagementNew)(&handlespace, BENCHMARK_FIRST_REGISTRAR,
+                                          NULL, NULL, NULL);
+   memset(&results, 0, sizeof(results));
+   srandom(1);
+
+   for(round = 0;round < rounds;round++) {
+      /* ====== Registration ============================================= */
+      start = getMicroTime();
+      for(j = 0;j < poolElementsPerPool;j++) {
+         for(i = 0;i < pools;i++) {
+            benchmarkGetPoolPolicySettings(&poolPolicySettings, poolPolicy->Type);
+            errorCode = ST_CLASS(poolHandlespaceManagementRegisterPoolElement)(
+                           &handlespace, &poolHandleArray[i],
+                           BENCHMARK_FIRST_REGISTRAR + (RegistrarIdentifierType)(j % BENCHMARK_REGISTRARS),
+                           (PoolElementIdentifierType)(j + 1),
+                           60000, &poolPolicySettings,
+                           transportAddressBlock, NULL, -1, 0,
+                           BENCHMARK_START_TIMESTAMP,
+                           &poolElementNodeArray[(i * poolElementsPerPool) + j]);
+            CHECK(errorCode == RSPERR_OKAY);
+         }
+      }
+      results.Duration[BO_REGISTRATION]   += getMicroTime() - start;
+      results.Operations[BO_REGISTRATION] += poolElements;
+
+      /* ====== Reregistration with load change ========================== */
+      start = getMicroTime();
+      for(j = 0;j < poolElementsPerPool;j++) {
+         for(i = 0;i < pools;i++) {
+            poolElementNode    = poolElementNodeArray[(i * poolElementsPerPool) + j];
+            poolPolicySettings = poolElementNode->PolicySettings;
+            poolPolicySettings.Load = (unsigned int)random();
+            errorCode = ST_CLASS(poolHandlespaceManagementRegisterPoolElement)(
+                           &handlespace, &poolHandleArray[i],
+                           poolElementNode->HomeRegistrarIdentifier,
+                           poolElementNode->Identifier,
+                           60000, &poolPolicySettings,
+                           transportAddressBlock, NULL, -1, 0,
+                           BENCHMARK_START_TIMESTAMP,
+                           &poolElementNode);
+            CHECK(errorCode == RSPERR_OKAY);
+         }
+      }
+      results.Duration[BO_REREGISTRATION]   += getMicroTime() - start;
+      results.Operations[BO_REREGISTRATION] += poolElements;
+
+      /* ====== Handle resolution ======================================== */
+      start = getMicroTime();
+      for(k = 0;k < poolElements;k++) {
+         i = (size_t)random() % pools;
+         errorCode = ST_CLASS(poolHandlespaceManagementHandleResolution)(
+                        &handlespace, &poolHandleArray[i],
+                        (struct ST_CLASS(PoolElementNode)**)&selectionArray, &selected,
+                        BENCHMARK_HANDLE_RESOLUTION_ITEMS, BENCHMARK_MAX_INCREMENT);
+         CHECK(errorCode == RSPERR_OKAY);
+         CHECK(selected > 0);
+      }
+      results.Duration[BO_HANDLE_RESOLUTION]   += getMicroTime() - start;
+      results.Operations[BO_HANDLE_RESOLUTION] += poolElements;
+
+      /* ====== Takeover of the first registrar's PEs ==================== */
+      start = getMicroTime();
+      poolElementNode = ST_CLASS(poolHandlespaceManagementGetFirstPoolElementOwnershipNodeForIdentifier)(
+                           &handlespace, BENCHMARK_FIRST_REGISTRAR);
+      while(poolElementNode != NULL) {
+         nextPoolElementNode = ST_CLASS(poolHandlespaceManagementGetNextPoolElementOwnershipNodeForSameIdentifier)(
+                                  &handlespace, poolElementNode);
+         ST_CLASS(poolHandlespaceManagementUpdateOwnershipOfPoolElementNode)(
+            &handlespace, poolElementNode, BENCHMARK_TAKEOVER_REGISTRAR);
+         results.Operations[BO_TAKEOVER]++;
+         poolElementNode = nextPoolElementNode;
+      }
+      results.Duration[BO_TAKEOVER] += getMicroTime() - start;
+
+      /* ====== Deregistration of every second PE ======================== */
+      start = getMicroTime();
+      for(j = 0;j < poolElementsPerPool;j += 2) {
+         for(i = 0;i < pools;i++) {
+            errorCode = ST_CLASS(poolHandlespaceManagementDeregisterPoolElement)(
+                           &handlespace, &poolHandleArray[i],
+                           (PoolElementIdentifierType)(j + 1));
+            CHECK(errorCode == RSPERR_OKAY);
+            poolElementNodeArray[(i * poolElementsPerPool) + j] = NULL;
+            results.Operations[BO_DEREGISTRATION]++;
+         }
+      }
+      results.Duration[BO_DEREGISTRATION] += getMicroTime() - start;
+
+      /* ====== Timer-driven expiry of the remaining PEs ================= */
+      start     = getMicroTime();
+      remaining = 0;
+      for(k = 0;k < poolElements;k++) {
+         if(poolElementNodeArray[k] != NULL) {
+            ST_CLASS(poolHandlespaceManagementRestartPoolElementExpiryTimer)(
+               &handlespace, poolElementNodeArray[k],
+               1 + ((unsigned long long)random() % BENCHMARK_EXPIRY_TIMEOUT));
+            remaining++;
+         }
+      }
+      CHECK(ST_CLASS(poolHandlespaceManagementPurgeExpiredPoolElements)(
+               &handlespace, BENCHMARK_START_TIMESTAMP + BENCHMARK_EXPIRY_TIMEOUT) == remaining);
+      results.Duration[BO_EXPIRY]   += getMicroTime() - start;
+      results.Operations[BO_EXPIRY] += remaining;
+
+      CHECK(ST_CLASS(poolHandlespaceManagementGetPoolElements)(&handlespace) == 0);
+   }
+
+   benchmarkPrintResults(backendName, poolPolicy->Name, pools, poolElementsPerPool, &results);
+
+   ST_CLASS(poolHandlespaceManagementDelete)(&handlespace);
+   free(poolElementNodeArray);
+   free(poolHandleArray);
+}
+
+
+/* ###### Run benchmark for all policies ################################# */
+static void ST_CLASS(hsmgtBenchmarkRun)(const char*  backendName,
+                                        const char*  policyName,
+                                        const size_t pools,
+                                        const size_t poolElementsPerPool,
+                                        const size_t minOperations)
+{
+   size_t i;
+
+   for(i = 0;i < ST_CLASS(PoolPolicies);i++) {
+      if( (policyName == NULL) ||
+          (strcmp(policyName, ST_CLASS(PoolPolicyArray)[i].Name) == 0) ) {
+         ST_CLASS(hsmgtBenchmarkPolicy)(backendName, &ST_CLASS(PoolPolicyArray)[i],
+                                        pools, poolElementsPerPool, minOperations);
+      }
+   }
+}
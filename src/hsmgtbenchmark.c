@@ -0,0 +1,261 @@
+/* --------------------------------------------------------------------------
+ *
+ *              //===//   //=====   //===//   //       //   //===//
+ *             //    //  //        //    //  //       //   //    //
+ *            //===//   //=====   //===//   //       //   //===<<
+ *           //   \\         //  //        //       //   //    //
+ *          //     \\  =====//  //        //=====  //   //===//   Version III
+ *
+ * ------------- An Efficient RSerPool Prototype Implementation -------------
+ *
+ * Copyright (C) 2002-2026 by Thomas Dreibholz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: thomas.dreibholz@gmail.com
+ */
+
+#include "tdtypes.h"
+#include "poolhandlespacemanagement.h"
+#include "rserpool-policytypes.h"
+#include "timeutilities.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+   Micro-benchmark of the handlespace management over all storage
+   backends. The program is built with all backends' INCLUDE_* definitions
+   set, so that poolhandlespacemanagement.c instantiates the templates for
+   each of them. For every backend, policy and handlespace size, the
+   benchmark runs rounds of registration, reregistration with load change,
+   handle resolution, ownership takeover, deregistration and timer-driven
+   expiry, and writes the average time per operation as CSV to stdout.
+*/
+
+#define BENCHMARK_REGISTRARS               4
+#define BENCHMARK_FIRST_REGISTRAR          0x10000001
+#define BENCHMARK_TAKEOVER_REGISTRAR       (BENCHMARK_FIRST_REGISTRAR + BENCHMARK_REGISTRARS)
+#define BENCHMARK_HANDLE_RESOLUTION_ITEMS  3
+#define BENCHMARK_MAX_INCREMENT            0
+#define BENCHMARK_START_TIMESTAMP          1000000ULL
+#define BENCHMARK_EXPIRY_TIMEOUT           30000000ULL
+
+enum BenchmarkOperation
+{
+   BO_REGISTRATION       = 0,
+   BO_REREGISTRATION     = 1,
+   BO_HANDLE_RESOLUTION  = 2,
+   BO_TAKEOVER           = 3,
+   BO_DEREGISTRATION     = 4,
+   BO_EXPIRY             = 5,
+   BO_OPERATIONS         = 6
+};
+
+static const char* BenchmarkOperationNames[BO_OPERATIONS] = {
+   "Registration",
+   "Reregistration",
+   "HandleResolution",
+   "Takeover",
+   "Deregistration",
+   "Expiry"
+};
+
+struct BenchmarkResults
+{
+   unsigned long long Operations[BO_OPERATIONS];
+   unsigned long long Duration[BO_OPERATIONS];
+};
+
+
+/* ###### Get random policy settings of a pool element ################### */
+static void benchmarkGetPoolPolicySettings(struct PoolPolicySettings* poolPolicySettings,
+                                           const unsigned int         policyType)
+{
+   poolPolicySettingsNew(poolPolicySettings);
+   poolPolicySettings->PolicyType      = policyType;
+   poolPolicySettings->Weight          = 1 + (unsigned int)(random() % 16);
+   poolPolicySettings->Load            = (unsigned int)random();
+   poolPolicySettings->LoadDegradation = PPV_MAX_LOAD_DEGRADATION / 100;
+   poolPolicySettings->LoadDPF         = (unsigned int)random();
+   poolPolicySettings->WeightDPF       = (unsigned int)random();
+   poolPolicySettings->Distance        = (unsigned int)(random() % 250);
+}
+
+
+/* ###### Print results as CSV lines ##################################### */
+static void benchmarkPrintResults(const char*                    backendName,
+                                  const char*                    policyName,
+                                  const size_t                   pools,
+                                  const size_t                   poolElementsPerPool,
+                                  const struct BenchmarkResults* results)
+{
+   unsigned int i;
+
+   for(i = 0;i < BO_OPERATIONS;i++) {
+      printf("%s,%s,%u,%u,%s,%llu,%1.1f\n",
+             backendName, policyName,
+             (unsigned int)pools, (unsigned int)poolElementsPerPool,
+             BenchmarkOperationNames[i],
+             results->Operations[i],
+             (results->Operations[i] > 0) ?
+                (1000.0 * results->Duration[i]) / results->Operations[i] : 0.0);
+   }
+   fflush(stdout);
+}
+
+
+/* ====== Instantiate the benchmark for each storage backend ============== */
+#undef STN_CLASSNAME
+#undef STN_METHOD
+#undef ST_CLASSNAME
+#undef ST_CLASS
+#undef ST_METHOD
+
+#ifdef INCLUDE_SIMPLEREDBLACKTREE
+#define STN_CLASSNAME SimpleRedBlackTreeNode
+#define STN_METHOD(x) simpleRedBlackTreeNode##x
+#define ST_CLASSNAME SimpleRedBlackTree
+#define ST_CLASS(x) x##_SimpleRedBlackTree
+#define ST_METHOD(x) simpleRedBlackTree##x
+#include "hsmgtbenchmark-template.h"
+#undef STN_CLASSNAME
+#undef STN_METHOD
+#undef ST_CLASSNAME
+#undef ST_CLASS
+#undef ST_METHOD
+#endif
+
+#ifdef INCLUDE_LEAFLINKEDREDBLACKTREE
+#define STN_CLASSNAME LeafLinkedRedBlackTreeNode
+#define STN_METHOD(x) leafLinkedRedBlackTreeNode##x
+#define ST_CLASSNAME LeafLinkedRedBlackTree
+#define ST_CLASS(x) x##_LeafLinkedRedBlackTree
+#define ST_METHOD(x) leafLinkedRedBlackTree##x
+#include "hsmgtbenchmark-template.h"
+#undef STN_CLASSNAME
+#undef STN_METHOD
+#undef ST_CLASSNAME
+#undef ST_CLASS
+#undef ST_METHOD
+#endif
+
+#ifdef INCLUDE_BPLUSTREE
+#define STN_CLASSNAME BPlusTreeNode
+#define STN_METHOD(x) bPlusTreeNode##x
+#define ST_CLASSNAME BPlusTree
+#define ST_CLASS(x) x##_BPlusTree
+#define ST_METHOD(x) bPlusTree##x
+#include "hsmgtbenchmark-template.h"
+#undef STN_CLASSNAME
+#undef STN_METHOD
+#undef ST_CLASSNAME
+#undef ST_CLASS
+#undef ST_METHOD
+#endif
+
+
+struct Backend
+{
+   const char* Name;
+   void        (*RunFunction)(const char*  backendName,
+                              const char*  policyName,
+                              const size_t pools,
+                              const size_t poolElementsPerPool,
+                              const size_t minOperations);
+};
+
+static const struct Backend BackendArray[] = {
+#ifdef INCLUDE_SIMPLEREDBLACKTREE
+   { "SimpleRedBlackTree",     TMPL_CLASS(hsmgtBenchmarkRun, SimpleRedBlackTree)     },
+#endif
+#ifdef INCLUDE_LEAFLINKEDREDBLACKTREE
+   { "LeafLinkedRedBlackTree", TMPL_CLASS(hsmgtBenchmarkRun, LeafLinkedRedBlackTree) },
+#endif
+#ifdef INCLUDE_BPLUSTREE
+   { "BPlusTree",              TMPL_CLASS(hsmgtBenchmarkRun, BPlusTree)              },
+#endif
+};
+
+struct Configuration
+{
+   size_t Pools;
+   size_t PoolElementsPerPool;
+};
+
+static const struct Configuration ConfigurationArray[] = {
+   { 1,     10      },
+   { 1,     100     },
+   { 1,     1000    },
+   { 1,     10000   },
+   { 1,     100000  },
+   { 1,     1000000 },
+   { 10,    10      },
+   { 100,   100     },
+   { 1000,  10      },
+   { 1000,  1000    },
+   { 10000, 100     }
+};
+
+
+/* ###### Main program ################################################### */
+int main(int argc, char** argv)
+{
+   const char* backendName     = NULL;
+   const char* policyName      = NULL;
+   size_t      maxPoolElements = 1000000;
+   size_t      minOperations   = 100000;
+   size_t      b, c;
+   int         i;
+
+   for(i = 1;i < argc;i++) {
+      if(!(strncmp(argv[i], "-backend=", 9))) {
+         backendName = (const char*)&argv[i][9];
+      }
+      else if(!(strncmp(argv[i], "-policy=", 8))) {
+         policyName = (const char*)&argv[i][8];
+      }
+      else if(!(strncmp(argv[i], "-maxpoolelements=", 17))) {
+         maxPoolElements = (size_t)atol((const char*)&argv[i][17]);
+      }
+      else if(!(strncmp(argv[i], "-minoperations=", 15))) {
+         minOperations = (size_t)atol((const char*)&argv[i][15]);
+         if(minOperations < 1) {
+            minOperations = 1;
+         }
+      }
+      else {
+         fprintf(stderr, "Usage: %s {-backend=Backend} {-policy=Policy} {-maxpoolelements=PEs} {-minoperations=Operations}\n", argv[0]);
+         exit(1);
+      }
+   }
+
+   puts("Backend,Policy,Pools,PoolElementsPerPool,Operation,Operations,NanosecondsPerOperation");
+   for(b = 0;b < sizeof(BackendArray) / sizeof(BackendArray[0]);b++) {
+      if( (backendName != NULL) && (strcmp(backendName, BackendArray[b].Name) != 0) ) {
+         continue;
+      }
+      for(c = 0;c < sizeof(ConfigurationArray) / sizeof(ConfigurationArray[0]);c++) {
+         if(ConfigurationArray[c].Pools * ConfigurationArray[c].PoolElementsPerPool > maxPoolElements) {
+            continue;
+         }
+         BackendArray[b].RunFunction(BackendArray[b].Name, policyName,
+                                     ConfigurationArray[c].Pools,
+                                     ConfigurationArray[c].PoolElementsPerPool,
+                                     minOperations);
+      }
+   }
+   return(0);
+}
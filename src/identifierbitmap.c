@@ -25,7 +25,6 @@
  *
  * Contact: thomas.dreibholz@gmail.com
  */
-
 #include "tdtypes.h"
 #include "identifierbitmap.h"
 #include "debug.h"
@@ -33,17 +32,144 @@
 #include <string.h>
 
 
+#define SLOT_FULL (~((uint64_t)0))
+
+
+/* ###### Mark entry as allocated ######################################## */
+static void identifierBitmapMarkAllocated(struct IdentifierBitmap* identifierBitmap,
+                                          size_t                   index)
+{
+   uint64_t* slot;
+   size_t    level;
+
+   for(level = 0;level < identifierBitmap->Levels;level++) {
+      slot = &identifierBitmap->Level[level][index / IdentifierBitmapSlotsize];
+      *slot |= ((uint64_t)1 << (index % IdentifierBitmapSlotsize));
+      if(*slot != SLOT_FULL) {
+         break;   /* Upper levels are unaffected */
+      }
+      index /= IdentifierBitmapSlotsize;
+   }
+}
+
+
+/* ###### Mark entry as free ############################################# */
+static void identifierBitmapMarkFree(struct IdentifierBitmap* identifierBitmap,
+                                     size_t                   index)
+{
+   uint64_t* slot;
+   bool      wasFull;
+   size_t    level;
+
+   for(level = 0;level < identifierBitmap->Levels;level++) {
+      slot    = &identifierBitmap->Level[level][index / IdentifierBitmapSlotsize];
+      wasFull = (*slot == SLOT_FULL);
+      *slot &= ~((uint64_t)1 << (index % IdentifierBitmapSlotsize));
+      if(!wasFull) {
+         break;   /* Upper levels are unaffected */
+      }
+      index /= IdentifierBitmapSlotsize;
+   }
+}
+
+
+/* ###### Find first free entry at or after given index ################## */
+static int identifierBitmapFindFree(const struct IdentifierBitmap* identifierBitmap,
+                                    size_t                         index)
+{
+   size_t   level = 0;
+   size_t   slot;
+   uint64_t candidates;
+
+   /* ====== Go up until a slot with a free entry is found =============== */
+   for(;;) {
+      slot = index / IdentifierBitmapSlotsize;
+      if(slot >= identifierBitmap->LevelSlots[level]) {
+         return(-1);
+      }
+      candidates = ~identifierBitmap->Level[level][slot] &
+                      (SLOT_FULL << (index % IdentifierBitmapSlotsize));
+      if(candidates != 0) {
+         index = (slot * IdentifierBitmapSlotsize) + __builtin_ctzll(candidates);
+         break;
+      }
+      level++;
+      if(level >= identifierBitmap->Levels) {
+         return(-1);
+      }
+      index = slot + 1;
+   }
+
+   /* ====== Go down along the first free entries ======================== */
+   while(level > 0) {
+      level--;
+      candidates = ~identifierBitmap->Level[level][index];
+      CHECK(candidates != 0);
+      index = (index * IdentifierBitmapSlotsize) + __builtin_ctzll(candidates);
+   }
+
+   CHECK(index < identifierBitmap->Entries);
+   return((int)index);
+}
+
+
 /* ###### Constructor #################################################### */
 struct IdentifierBitmap* identifierBitmapNew(const size_t entries)
 {
-   const size_t slots = (entries + (IdentifierBitmapSlotsize - (entries % IdentifierBitmapSlotsize))) /
-                           IdentifierBitmapSlotsize;
-   struct IdentifierBitmap* identifierBitmap = (struct IdentifierBitmap*)malloc(sizeof(struct IdentifierBitmap) + (slots + 1) * sizeof(size_t));
+   struct IdentifierBitmap* identifierBitmap;
+   size_t                   levelSlots[IdentifierBitmapMaxLevels];
+   size_t                   levels     = 0;
+   size_t                   totalSlots = 0;
+   size_t                   slots;
+   size_t                   level;
+   size_t                   i;
+
+   /* ====== Compute size of each level ================================== */
+   slots = (entries + IdentifierBitmapSlotsize - 1) / IdentifierBitmapSlotsize;
+   if(slots == 0) {
+      slots = 1;
+   }
+   for(;;) {
+      CHECK(levels < IdentifierBitmapMaxLevels);
+      levelSlots[levels++] = slots;
+      totalSlots += slots;
+      if(slots == 1) {
+         break;
+      }
+      slots = (slots + IdentifierBitmapSlotsize - 1) / IdentifierBitmapSlotsize;
+   }
+
+   identifierBitmap = (struct IdentifierBitmap*)malloc(sizeof(struct IdentifierBitmap) + totalSlots * sizeof(uint64_t));
    if(identifierBitmap) {
-      memset(&identifierBitmap->Bitmap, 0, (slots + 1) * sizeof(size_t));
-      identifierBitmap->Entries   = entries;
-      identifierBitmap->Available = entries;
-      identifierBitmap->Slots     = slots;
+      memset(&identifierBitmap->Bitmap, 0, totalSlots * sizeof(uint64_t));
+      identifierBitmap->Entries         = entries;
+      identifierBitmap->Available       = entries;
+      identifierBitmap->Levels          = levels;
+      identifierBitmap->NextFit         = false;
+      identifierBitmap->NextFitPosition = 0;
+      slots = 0;
+      for(level = 0;level < IdentifierBitmapMaxLevels;level++) {
+         if(level < levels) {
+            identifierBitmap->LevelSlots[level] = levelSlots[level];
+            identifierBitmap->Level[level]      = &identifierBitmap->Bitmap[slots];
+            slots += levelSlots[level];
+         }
+         else {
+            identifierBitmap->LevelSlots[level] = 0;
+            identifierBitmap->Level[level]      = NULL;
+         }
+      }
+
+      /* ====== Mark padding bits as allocated =========================== */
+      for(i = entries;i < levelSlots[0] * IdentifierBitmapSlotsize;i++) {
+         identifierBitmapMarkAllocated(identifierBitmap, i);
+      }
+      for(level = 1;level < levels;level++) {
+         for(i = levelSlots[level - 1];i < levelSlots[level] * IdentifierBitmapSlotsize;i++) {
+            identifierBitmap->Level[level][i / IdentifierBitmapSlotsize] |=
+               ((uint64_t)1 << (i % IdentifierBitmapSlotsize));
+         }
+      }
    }
    return(identifierBitmap);
 }
@@ -57,30 +183,36 @@ void identifierBitmapDelete(struct IdentifierBitmap* identifierBitmap)
 }
 
 
+/* ###### Enable or disable next-fit allocation ########################## */
+/*
+   With next-fit, the search for a free ID starts behind the previously
+   allocated one. Therefore, the reuse of recently freed IDs is delayed.
+*/
+void identifierBitmapSetNextFit(struct IdentifierBitmap* identifierBitmap,
+                                const bool               nextFit)
+{
+   identifierBitmap->NextFit         = nextFit;
+   identifierBitmap->NextFitPosition = 0;
+}
+
+
 /* ###### Allocate ID #################################################### */
 int identifierBitmapAllocateID(struct IdentifierBitmap* identifierBitmap)
 {
-   unsigned int i, j;
-   int      id = -1;
+   int id = -1;
 
    if(identifierBitmap->Available > 0) {
-      i = 0;
-      while(identifierBitmap->Bitmap[i] == ~((size_t)0)) {
-         i++;
+      if(identifierBitmap->NextFit) {
+         id = identifierBitmapFindFree(identifierBitmap, identifierBitmap->NextFitPosition);
       }
-      id = i * IdentifierBitmapSlotsize;
-
-      j = 0;
-      while((j < IdentifierBitmapSlotsize) &&
-            (id < (int)identifierBitmap->Entries) &&
-            (identifierBitmap->Bitmap[i] & (1UL << j))) {
-         j++;
-         id++;
+      if(id < 0) {
+         id = identifierBitmapFindFree(identifierBitmap, 0);
       }
-      CHECK(id < (int)identifierBitmap->Entries);
+      CHECK(id >= 0);
 
-      identifierBitmap->Bitmap[i] |= (1UL << j);
+      identifierBitmapMarkAllocated(identifierBitmap, (size_t)id);
       identifierBitmap->Available--;
+      identifierBitmap->NextFitPosition = (size_t)id + 1;
    }
 
    return(id);
@@ -96,10 +228,10 @@ int identifierBitmapAllocateSpecificID(struct IdentifierBitmap* identifierBitmap
    CHECK((id >= 0) && (id < (int)identifierBitmap->Entries));
    i = id / IdentifierBitmapSlotsize;
    j = id % IdentifierBitmapSlotsize;
-   if(identifierBitmap->Bitmap[i] & (1UL << j)) {
+   if(identifierBitmap->Level[0][i] & ((uint64_t)1 << j)) {
       return(-1);
    }
-   identifierBitmap->Bitmap[i] |= (1UL << j);
+   identifierBitmapMarkAllocated(identifierBitmap, (size_t)id);
    identifierBitmap->Available--;
    return(id);
 }
@@ -113,7 +245,7 @@ void identifierBitmapFreeID(struct IdentifierBitmap* identifierBitmap, const int
    CHECK((id >= 0) && (id < (int)identifierBitmap->Entries));
    i = id / IdentifierBitmapSlotsize;
    j = id % IdentifierBitmapSlotsize;
-   CHECK(identifierBitmap->Bitmap[i] & (1UL << j));
-   identifierBitmap->Bitmap[i] &= ~(1UL << j);
+   CHECK(identifierBitmap->Level[0][i] & ((uint64_t)1 << j));
+   identifierBitmapMarkFree(identifierBitmap, (size_t)id);
    identifierBitmap->Available++;
 }
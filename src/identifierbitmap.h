@@ -37,19 +37,33 @@ extern "C" {
 #endif
 
 
+/*
+   The bitmap is organized hierarchically: level 0 contains one bit per
+   identifier (set means allocated), each bit of level n + 1 is set when
+   the corresponding slot of level n is completely allocated. The topmost
+   level consists of a single slot. Therefore, a free identifier is found
+   in O(log n) by following the first zero bits from the top.
+*/
+#define IdentifierBitmapSlotsize  (sizeof(uint64_t) * 8)
+#define IdentifierBitmapMaxLevels 4   /* up to 64^4 = 16M identifiers */
+
 struct IdentifierBitmap
 {
-   size_t        Entries;
-   size_t        Available;
-   size_t        Slots;
-   unsigned long Bitmap[0];
+   size_t    Entries;
+   size_t    Available;
+   size_t    Levels;
+   size_t    LevelSlots[IdentifierBitmapMaxLevels];
+   uint64_t* Level[IdentifierBitmapMaxLevels];
+   bool      NextFit;
+   size_t    NextFitPosition;
+   uint64_t  Bitmap[0];
 };
 
-#define IdentifierBitmapSlotsize (sizeof(unsigned long) * 8)
-
 
 struct IdentifierBitmap* identifierBitmapNew(const size_t entries);
 void identifierBitmapDelete(struct IdentifierBitmap* identifierBitmap);
+void identifierBitmapSetNextFit(struct IdentifierBitmap* identifierBitmap,
+                                const bool               nextFit);
 int identifierBitmapAllocateID(struct IdentifierBitmap* identifierBitmap);
 int identifierBitmapAllocateSpecificID(struct IdentifierBitmap* identifierBitmap,
                                        const int                id);
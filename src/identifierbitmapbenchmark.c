@@ -0,0 +1,111 @@
+/* --------------------------------------------------------------------------
+ *
+ *              //===//   //=====   //===//   //       //   //===//
+ *             //    //  //        //    //  //       //   //    //
+ *            //===//   //=====   //===//   //       //   //===<<
+ *           //   \\         //  //        //       //   //    //
+ *          //     \\  =====//  //        //=====  //   //===//   Version III
+ *
+ * ------------- An Efficient RSerPool Prototype Implementation -------------
+ *
+ * Copyright (C) 2002-2026 by Thomas Dreibholz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: thomas.dreibholz@gmail.com
+ */
+#include "tdtypes.h"
+#include "identifierbitmap.h"
+#include "timeutilities.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ###### Run one benchmark ############################################## */
+static void runBenchmark(const size_t       entries,
+                         const double       occupancy,
+                         const unsigned int operations,
+                         const bool         nextFit)
+{
+   struct IdentifierBitmap* identifierBitmap;
+   int*                     ids;
+   size_t                   used;
+   size_t                   i;
+   unsigned int             j;
+   unsigned long long       start;
+   unsigned long long       duration;
+
+   identifierBitmap = identifierBitmapNew(entries);
+   ids              = (int*)malloc(entries * sizeof(int));
+   if((identifierBitmap == NULL) || (ids == NULL)) {
+      fputs("ERROR: Out of memory!\n", stderr);
+      exit(1);
+   }
+   identifierBitmapSetNextFit(identifierBitmap, nextFit);
+
+   /* ====== Fill bitmap up to the requested occupancy =================== */
+   used = (size_t)(occupancy * entries);
+   for(i = 0;i < used;i++) {
+      ids[i] = identifierBitmapAllocateID(identifierBitmap);
+   }
+
+   /* ====== Churn: free a random ID, allocate a new one ================= */
+   start = getMicroTime();
+   for(j = 0;j < operations;j++) {
+      i = (size_t)random() % used;
+      identifierBitmapFreeID(identifierBitmap, ids[i]);
+      ids[i] = identifierBitmapAllocateID(identifierBitmap);
+   }
+   duration = getMicroTime() - start;
+
+   printf("entries=%-8u occupancy=%5.1f%%  %-9s  %8.1f ns/operation\n",
+          (unsigned int)entries, 100.0 * occupancy,
+          (nextFit == true) ? "next-fit" : "first-fit",
+          (1000.0 * duration) / operations);
+
+   free(ids);
+   identifierBitmapDelete(identifierBitmap);
+}
+
+
+/* ###### Main program ################################################### */
+int main(int argc, char** argv)
+{
+   const size_t sizes[]       = { 1024, 65536, 1048576 };
+   const double occupancies[] = { 0.5, 0.9, 0.999 };
+   unsigned int operations    = 1000000;
+   size_t       i, j;
+
+   for(i = 1;i < (size_t)argc;i++) {
+      if(!(strncmp(argv[i], "-operations=", 12))) {
+         operations = (unsigned int)atol((const char*)&argv[i][12]);
+         if(operations < 1) {
+            operations = 1;
+         }
+      }
+      else {
+         fprintf(stderr, "Usage: %s {-operations=Operations}\n", argv[0]);
+         exit(1);
+      }
+   }
+
+   for(i = 0;i < sizeof(sizes) / sizeof(sizes[0]);i++) {
+      for(j = 0;j < sizeof(occupancies) / sizeof(occupancies[0]);j++) {
+         runBenchmark(sizes[i], occupancies[j], operations, false);
+         runBenchmark(sizes[i], occupancies[j], operations, true);
+      }
+   }
+   return(0);
+}
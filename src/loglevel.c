@@ -40,7 +40,10 @@
 #include "stringutilities.h"
 
 #include <unistd.h>
+#include <time.h>
 #include <sys/utsname.h>
+#include <stdarg.h>
+#include <stdatomic.h>
 
 
 /* stderr is a macro returning standard error FILE* */
@@ -54,6 +57,74 @@ struct ThreadSafety   gLogMutex;
 static char           gHostName[128] = { 0x00 };
 
 
+/*
+   Asynchronous logging backend:
+   Each logging thread has a single-producer/single-consumer ring buffer.
+   LOG_* blocks write their text into the thread's record buffer; LOG_END
+   appends it as a binary record (header + text) to the ring buffer without
+   any lock. A writer thread formats the records and writes them in
+   batches, with one write() call per batch. When a ring buffer is full,
+   the record is dropped and counted.
+*/
+#define LOG_RING_BUFFER_SIZE   (128 * 1024)
+#define LOG_RECORD_MAX_PAYLOAD (8 * 1024)
+#define LOG_BATCH_SIZE         (64 * 1024)
+#define LOG_WRITER_INTERVAL    50000   /* Writer wake-up interval in us */
+#define LOG_RECORD_WRAP        ((size_t)-1)
+#define LOG_RECORD_ALIGN(size) (((size) + 7) & ~((size_t)7))
+
+struct LogRecordHeader
+{
+   unsigned long long TimeStamp;
+   unsigned long      ThreadID;
+   const char*        File;
+   const char*        Function;
+   unsigned int       Line;
+   unsigned short     Level;
+   unsigned char      Color1;
+   unsigned char      Color2;
+   size_t             Length;   /* Payload length or LOG_RECORD_WRAP */
+};
+
+struct LogRingBuffer
+{
+   struct LogRingBuffer*  Next;
+   atomic_size_t          Head;        /* Written by producer only */
+   atomic_size_t          Tail;        /* Written by consumer only */
+   atomic_ullong          Dropped;
+   atomic_ullong          Truncated;
+   atomic_bool            Orphaned;    /* Producer thread has finished */
+   atomic_bool            Detached;    /* Unlinked by stopped writer */
+
+   FILE*                  RecordFile;
+   struct LogRecordHeader Record;
+   unsigned int           RecordNesting;
+   char                   RecordPayload[LOG_RECORD_MAX_PAYLOAD];
+
+   char                   Data[LOG_RING_BUFFER_SIZE];
+};
+
+atomic_bool                  gLogAsynchronous = false;   /* Writer is running */
+static bool                  gLogAsynchronousRequested = false;
+__thread FILE*               gLogRecordFile   = NULL;
+static __thread struct LogRingBuffer* gLogRingBuffer = NULL;
+static pthread_once_t        gLogRingBufferKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t         gLogRingBufferKey;
+static pthread_mutex_t       gLogWriterMutex  = PTHREAD_MUTEX_INITIALIZER;   /* Ring list, consumer side */
+static pthread_cond_t        gLogWriterCondition = PTHREAD_COND_INITIALIZER;
+static pthread_t             gLogWriterThread;
+static bool                  gLogWriterRunning  = false;
+static bool                  gLogWriterShutdown = false;
+static struct LogRingBuffer* gLogRingBufferList = NULL;
+static unsigned long long    gLogDroppedRecords   = 0;   /* Of freed ring buffers */
+static unsigned long long    gLogTruncatedRecords = 0;
+static unsigned long long    gLogReportedRecords  = 0;
+static char                  gLogBatch[LOG_BATCH_SIZE];
+static size_t                gLogBatchLength      = 0;
+static time_t                gLogCachedSecond     = (time_t)-1;
+static char                  gLogCachedDate[32];
+
+
 /* ###### Set ASCII color ################################################ */
 void setLogColor(const unsigned int color)
 {
@@ -83,6 +154,468 @@ static bool initLogFile(const unsigned int logLevel, const char* fileName, const
 }
 
 
+/* ###### Write batch of asynchronous log output ######################### */
+static void logWriterFlushBatch()
+{
+   ssize_t written;
+   size_t  offset = 0;
+
+   if(gLogBatchLength > 0) {
+      loggingMutexLock();
+      fflush(*gStdLog);
+      while(offset < gLogBatchLength) {
+         written = write(fileno(*gStdLog), (const char*)&gLogBatch[offset],
+                         gLogBatchLength - offset);
+         if(written <= 0) {
+            if((written < 0) && (errno == EINTR)) {
+               continue;
+            }
+            break;
+         }
+         offset += (size_t)written;
+      }
+      loggingMutexUnlock();
+      gLogBatchLength = 0;
+   }
+}
+
+
+/* ###### Append text to batch of asynchronous log output ################ */
+static void logWriterAppend(const char* text, size_t length)
+{
+   size_t chunk;
+
+   while(length > 0) {
+      if(gLogBatchLength == LOG_BATCH_SIZE) {
+         logWriterFlushBatch();
+      }
+      chunk = min(length, LOG_BATCH_SIZE - gLogBatchLength);
+      memcpy(&gLogBatch[gLogBatchLength], text, chunk);
+      gLogBatchLength += chunk;
+      text            += chunk;
+      length          -= chunk;
+   }
+}
+
+
+/* ###### Append formatted text to batch of asynchronous log output ###### */
+static void logWriterAppendFormatted(const char* format, ...)
+{
+   char    buffer[512];
+   va_list args;
+   int     length;
+
+   va_start(args, format);
+   length = vsnprintf((char*)&buffer, sizeof(buffer), format, args);
+   va_end(args);
+   if(length > 0) {
+      logWriterAppend((const char*)&buffer, min((size_t)length, sizeof(buffer) - 1));
+   }
+}
+
+
+/* ###### Append color code to batch of asynchronous log output ########## */
+static void logWriterAppendColor(const unsigned int color)
+{
+   if(gColorMode) {
+      logWriterAppendFormatted("\x1b[%dm",
+                               30 + (color % 8) + ((color > 8) ? 60 : 0));
+   }
+}
+
+
+/* ###### Append time stamp to batch of asynchronous log output ########## */
+static void logWriterAppendTimeStamp(const unsigned long long microTime)
+{
+   const time_t timeStamp = microTime / 1000000;
+   struct tm    tm;
+
+   /* The date part only changes once per second */
+   if(timeStamp != gLogCachedSecond) {
+      localtime_r(&timeStamp, &tm);
+      strftime((char*)&gLogCachedDate, sizeof(gLogCachedDate), "%d-%b-%Y %H:%M:%S", &tm);
+      gLogCachedSecond = timeStamp;
+   }
+   logWriterAppend((const char*)&gLogCachedDate, strlen(gLogCachedDate));
+   logWriterAppendFormatted(".%04d: ", (unsigned int)(microTime % 1000000) / 100);
+}
+
+
+/* ###### Write records of a ring buffer ################################# */
+static size_t logWriterDrainRingBuffer(struct LogRingBuffer* ringBuffer)
+{
+   struct LogRecordHeader header;
+   size_t                 tail    = atomic_load_explicit(&ringBuffer->Tail, memory_order_relaxed);
+   const size_t           head    = atomic_load_explicit(&ringBuffer->Head, memory_order_acquire);
+   size_t                 records = 0;
+   size_t                 offset;
+
+   while(tail != head) {
+      offset = tail % LOG_RING_BUFFER_SIZE;
+      if(LOG_RING_BUFFER_SIZE - offset < sizeof(header)) {
+         tail += LOG_RING_BUFFER_SIZE - offset;
+         continue;
+      }
+      memcpy(&header, &ringBuffer->Data[offset], sizeof(header));
+      if(header.Length == LOG_RECORD_WRAP) {
+         tail += LOG_RING_BUFFER_SIZE - offset;
+         continue;
+      }
+
+      logWriterAppendColor(header.Color1);
+      logWriterAppendTimeStamp(header.TimeStamp);
+      logWriterAppendColor(header.Color2);
+      logWriterAppendFormatted("P%lu.%lx@%s %s:%u %s()\n",
+                               (unsigned long)getpid(), header.ThreadID,
+                               getHostName(),
+                               header.File, header.Line, header.Function);
+      logWriterAppendColor(header.Color1);
+      logWriterAppendTimeStamp(header.TimeStamp);
+      logWriterAppendColor(header.Color2);
+      logWriterAppend(&ringBuffer->Data[offset + sizeof(header)], header.Length);
+      logWriterAppendColor(0);
+
+      tail += LOG_RECORD_ALIGN(sizeof(header) + header.Length);
+      records++;
+   }
+   atomic_store_explicit(&ringBuffer->Tail, tail, memory_order_release);
+   return(records);
+}
+
+
+/* ###### Free ring buffer ############################################### */
+static void logRingBufferDelete(struct LogRingBuffer* ringBuffer)
+{
+   gLogDroppedRecords   += atomic_load_explicit(&ringBuffer->Dropped, memory_order_relaxed);
+   gLogTruncatedRecords += atomic_load_explicit(&ringBuffer->Truncated, memory_order_relaxed);
+   if(ringBuffer->RecordFile != NULL) {
+      fclose(ringBuffer->RecordFile);
+   }
+   free(ringBuffer);
+}
+
+
+/* ###### Write records of all ring buffers ############################## */
+static size_t logWriterDrain()
+{
+   struct LogRingBuffer** ringBufferPtr;
+   struct LogRingBuffer*  ringBuffer;
+   unsigned long long     dropped   = gLogDroppedRecords;
+   unsigned long long     truncated = gLogTruncatedRecords;
+   size_t                 records   = 0;
+
+   ringBufferPtr = &gLogRingBufferList;
+   while(*ringBufferPtr != NULL) {
+      ringBuffer = *ringBufferPtr;
+      records += logWriterDrainRingBuffer(ringBuffer);
+      dropped   += atomic_load_explicit(&ringBuffer->Dropped, memory_order_relaxed);
+      truncated += atomic_load_explicit(&ringBuffer->Truncated, memory_order_relaxed);
+
+      /* ====== Free ring buffer of finished thread ====================== */
+      if( (atomic_load_explicit(&ringBuffer->Orphaned, memory_order_acquire)) &&
+          (atomic_load_explicit(&ringBuffer->Head, memory_order_acquire) ==
+              atomic_load_explicit(&ringBuffer->Tail, memory_order_relaxed)) ) {
+         *ringBufferPtr = ringBuffer->Next;
+         logRingBufferDelete(ringBuffer);
+      }
+      else {
+         ringBufferPtr = &ringBuffer->Next;
+      }
+   }
+
+   /* ====== Report lost records ========================================= */
+   if(dropped + truncated > gLogReportedRecords) {
+      logWriterAppendColor(13);
+      logWriterAppendTimeStamp(getMicroTime());
+      logWriterAppendColor(5);
+      logWriterAppendFormatted("Warning: Asynchronous logging dropped %llu and truncated %llu records so far\n",
+                               dropped, truncated);
+      logWriterAppendColor(0);
+      gLogReportedRecords = dropped + truncated;
+   }
+
+   logWriterFlushBatch();
+   return(records);
+}
+
+
+/* ###### Asynchronous logging writer thread ############################# */
+static void* logWriterThread(void* arg)
+{
+   struct timespec    timeout;
+   unsigned long long wakeUpTime;
+
+   pthread_mutex_lock(&gLogWriterMutex);
+   while(!gLogWriterShutdown) {
+      /* Keep on writing as long as there are new records */
+      if(logWriterDrain() > 0) {
+         continue;
+      }
+
+      wakeUpTime = getMicroTime() + LOG_WRITER_INTERVAL;
+      timeout.tv_sec  = wakeUpTime / 1000000;
+      timeout.tv_nsec = (wakeUpTime % 1000000) * 1000;
+      pthread_cond_timedwait(&gLogWriterCondition, &gLogWriterMutex, &timeout);
+   }
+   logWriterDrain();
+   pthread_mutex_unlock(&gLogWriterMutex);
+   return(NULL);
+}
+
+
+/* ###### Mark ring buffer of finished thread ############################ */
+static void logRingBufferOrphan(void* arg)
+{
+   struct LogRingBuffer* ringBuffer = (struct LogRingBuffer*)arg;
+
+   gLogRecordFile = NULL;
+   gLogRingBuffer = NULL;
+   pthread_mutex_lock(&gLogWriterMutex);
+   if(atomic_load_explicit(&ringBuffer->Detached, memory_order_relaxed)) {
+      /* The writer has already been stopped -> nobody else will free it */
+      logRingBufferDelete(ringBuffer);
+   }
+   else {
+      fclose(ringBuffer->RecordFile);
+      ringBuffer->RecordFile = NULL;
+      atomic_store_explicit(&ringBuffer->Orphaned, true, memory_order_release);
+   }
+   pthread_mutex_unlock(&gLogWriterMutex);
+}
+
+
+/* ###### Create key for ring buffer destructor ########################## */
+static void logRingBufferCreateKey()
+{
+   CHECK(pthread_key_create(&gLogRingBufferKey, logRingBufferOrphan) == 0);
+}
+
+
+/* ###### Get ring buffer of current thread ############################## */
+static struct LogRingBuffer* logRingBufferGet()
+{
+   struct LogRingBuffer* ringBuffer = gLogRingBuffer;
+
+   /* ====== Free ring buffer left over from a stopped writer ============ */
+   if( (ringBuffer != NULL) &&
+       (atomic_load_explicit(&ringBuffer->Detached, memory_order_acquire)) ) {
+      pthread_mutex_lock(&gLogWriterMutex);
+      logRingBufferDelete(ringBuffer);
+      pthread_mutex_unlock(&gLogWriterMutex);
+      pthread_setspecific(gLogRingBufferKey, NULL);
+      ringBuffer     = NULL;
+      gLogRingBuffer = NULL;
+   }
+
+   if(ringBuffer == NULL) {
+      ringBuffer = (struct LogRingBuffer*)malloc(sizeof(struct LogRingBuffer));
+      if(ringBuffer == NULL) {
+         return(NULL);
+      }
+      ringBuffer->RecordFile = fmemopen((char*)&ringBuffer->RecordPayload,
+                                        sizeof(ringBuffer->RecordPayload), "w");
+      if(ringBuffer->RecordFile == NULL) {
+         free(ringBuffer);
+         return(NULL);
+      }
+      setvbuf(ringBuffer->RecordFile, NULL, _IONBF, 0);
+      ringBuffer->RecordNesting = 0;
+      atomic_init(&ringBuffer->Head, 0);
+      atomic_init(&ringBuffer->Tail, 0);
+      atomic_init(&ringBuffer->Dropped, 0);
+      atomic_init(&ringBuffer->Truncated, 0);
+      atomic_init(&ringBuffer->Orphaned, false);
+      atomic_init(&ringBuffer->Detached, false);
+
+      pthread_once(&gLogRingBufferKeyOnce, logRingBufferCreateKey);
+      pthread_setspecific(gLogRingBufferKey, ringBuffer);
+
+      pthread_mutex_lock(&gLogWriterMutex);
+      ringBuffer->Next   = gLogRingBufferList;
+      gLogRingBufferList = ringBuffer;
+      pthread_mutex_unlock(&gLogWriterMutex);
+      gLogRingBuffer = ringBuffer;
+   }
+   return(ringBuffer);
+}
+
+
+/* ###### Begin asynchronous log record ################################## */
+bool loggingBeginRecord(const unsigned int level,
+                        const unsigned int color1,
+                        const unsigned int color2,
+                        const char*        file,
+                        const unsigned int line,
+                        const char*        function)
+{
+   struct LogRingBuffer* ringBuffer;
+
+   if(gLogRecordFile != NULL) {
+      /* Nested LOG_* block: append to the outer record */
+      gLogRingBuffer->RecordNesting++;
+      return(true);
+   }
+   ringBuffer = logRingBufferGet();
+   if(ringBuffer == NULL) {
+      return(false);
+   }
+   ringBuffer->Record.TimeStamp = getMicroTime();
+   ringBuffer->Record.ThreadID  = (unsigned long)pthread_self();
+   ringBuffer->Record.File      = file;
+   ringBuffer->Record.Function  = function;
+   ringBuffer->Record.Line      = line;
+   ringBuffer->Record.Level     = (unsigned short)level;
+   ringBuffer->Record.Color1    = (unsigned char)color1;
+   ringBuffer->Record.Color2    = (unsigned char)color2;
+   ringBuffer->RecordNesting    = 0;
+   rewind(ringBuffer->RecordFile);
+   gLogRecordFile = ringBuffer->RecordFile;
+   return(true);
+}
+
+
+/* ###### Finish asynchronous log record ################################# */
+void loggingEndRecord()
+{
+   struct LogRingBuffer* ringBuffer = gLogRingBuffer;
+   size_t                head;
+   size_t                tail;
+   size_t                offset;
+   size_t                contiguous;
+   size_t                required;
+   long                  length;
+
+   if(ringBuffer->RecordNesting > 0) {
+      ringBuffer->RecordNesting--;
+      return;
+   }
+   gLogRecordFile = NULL;
+
+   /* ====== Get payload ================================================= */
+   length = ftell(ringBuffer->RecordFile);
+   if(length < 0) {
+      length = 0;
+   }
+   if((size_t)length >= sizeof(ringBuffer->RecordPayload) - 1) {
+      /* fmemopen() keeps space for the terminating null byte */
+      atomic_fetch_add_explicit(&ringBuffer->Truncated, 1, memory_order_relaxed);
+      length = sizeof(ringBuffer->RecordPayload) - 1;
+   }
+   ringBuffer->Record.Length = (size_t)length;
+   required = LOG_RECORD_ALIGN(sizeof(struct LogRecordHeader) + (size_t)length);
+
+   /* ====== Reserve space in ring buffer ================================ */
+   head       = atomic_load_explicit(&ringBuffer->Head, memory_order_relaxed);
+   tail       = atomic_load_explicit(&ringBuffer->Tail, memory_order_acquire);
+   offset     = head % LOG_RING_BUFFER_SIZE;
+   contiguous = LOG_RING_BUFFER_SIZE - offset;
+   if(LOG_RING_BUFFER_SIZE - (head - tail) < required + ((contiguous < required) ? contiguous : 0)) {
+      atomic_fetch_add_explicit(&ringBuffer->Dropped, 1, memory_order_relaxed);
+      return;
+   }
+   if(contiguous < required) {
+      /* Record does not fit at the end -> wrap around */
+      if(contiguous >= sizeof(struct LogRecordHeader)) {
+         struct LogRecordHeader wrap;
+         memset(&wrap, 0, sizeof(wrap));
+         wrap.Length = LOG_RECORD_WRAP;
+         memcpy(&ringBuffer->Data[offset], &wrap, sizeof(wrap));
+      }
+      head   += contiguous;
+      offset  = 0;
+   }
+
+   /* ====== Append record =============================================== */
+   memcpy(&ringBuffer->Data[offset], &ringBuffer->Record, sizeof(struct LogRecordHeader));
+   memcpy(&ringBuffer->Data[offset + sizeof(struct LogRecordHeader)],
+          &ringBuffer->RecordPayload, (size_t)length);
+   atomic_store_explicit(&ringBuffer->Head, head + required, memory_order_release);
+
+   /* ====== Write record directly, if the writer has been stopped ======= */
+   /* Either stopLogWriter() sees the new Head in its final drain, or this
+      thread sees the writer stopped and writes the record itself. */
+   atomic_thread_fence(memory_order_seq_cst);
+   if(!atomic_load_explicit(&gLogAsynchronous, memory_order_relaxed)) {
+      pthread_mutex_lock(&gLogWriterMutex);
+      logWriterDrainRingBuffer(ringBuffer);
+      logWriterFlushBatch();
+      pthread_mutex_unlock(&gLogWriterMutex);
+   }
+
+   /* ====== Wake up writer, if the ring buffer is getting full ========== */
+   else if(head + required - tail > LOG_RING_BUFFER_SIZE / 2) {
+      pthread_cond_signal(&gLogWriterCondition);
+   }
+}
+
+
+/* ###### Write all queued asynchronous log records ###################### */
+void loggingFlush()
+{
+   pthread_mutex_lock(&gLogWriterMutex);
+   logWriterDrain();
+   pthread_mutex_unlock(&gLogWriterMutex);
+}
+
+
+/* ###### Start asynchronous logging writer ############################## */
+static void startLogWriter()
+{
+   if(!gLogWriterRunning) {
+      gLogWriterShutdown = false;
+      if(pthread_create(&gLogWriterThread, NULL, logWriterThread, NULL) == 0) {
+         gLogWriterRunning = true;
+         atomic_store(&gLogAsynchronous, true);
+      }
+      else {
+         fputs("ERROR: Unable to start asynchronous logging, using synchronous logging!\n", stderr);
+      }
+   }
+}
+
+
+/* ###### Stop asynchronous logging writer ############################### */
+static void stopLogWriter()
+{
+   struct LogRingBuffer* ringBuffer;
+
+   if(gLogWriterRunning) {
+      atomic_store(&gLogAsynchronous, false);
+      atomic_thread_fence(memory_order_seq_cst);
+      pthread_mutex_lock(&gLogWriterMutex);
+      gLogWriterShutdown = true;
+      pthread_cond_signal(&gLogWriterCondition);
+      pthread_mutex_unlock(&gLogWriterMutex);
+      CHECK(pthread_join(gLogWriterThread, NULL) == 0);
+      gLogWriterRunning = false;
+
+      /* ====== Write remaining records and release ring buffers ========= */
+      /* Records completed from now on are written by their producers
+         (see loggingEndRecord()). A ring buffer of a still running thread
+         may be in use, so it is only detached here and freed by its owner. */
+      pthread_mutex_lock(&gLogWriterMutex);
+      logWriterDrain();
+      while(gLogRingBufferList != NULL) {
+         ringBuffer         = gLogRingBufferList;
+         gLogRingBufferList = ringBuffer->Next;
+         ringBuffer->Next   = NULL;
+         if( (ringBuffer == gLogRingBuffer) && (gLogRecordFile == NULL) ) {
+            pthread_setspecific(gLogRingBufferKey, NULL);
+            gLogRingBuffer = NULL;
+            logRingBufferDelete(ringBuffer);
+         }
+         else if(atomic_load_explicit(&ringBuffer->Orphaned, memory_order_acquire)) {
+            logRingBufferDelete(ringBuffer);
+         }
+         else {
+            atomic_store_explicit(&ringBuffer->Detached, true, memory_order_release);
+         }
+      }
+      pthread_mutex_unlock(&gLogWriterMutex);
+   }
+}
+
+
 /* ###### Set logging parameter ########################################## */
 bool initLogging(const char* parameter)
 {
@@ -99,6 +632,12 @@ bool initLogging(const char* parameter)
    else if(!(strncmp(parameter,"-loglevel=",10))) {
       gLogLevel = min(atol((char*)&parameter[10]),MAX_LOGLEVEL);
    }
+   else if(!(strcmp(parameter,"-logasync"))) {
+      gLogAsynchronousRequested = true;
+   }
+   else if(!(strncmp(parameter,"-logasync=",10))) {
+      gLogAsynchronousRequested = (strcmp((char*)&parameter[10],"off") != 0);
+   }
    else if(!(strncmp(parameter,"-logcolor=",10))) {
       if(!(strcmp((char*)&parameter[10],"off"))) {
          gColorMode = false;
@@ -134,6 +673,9 @@ void beginLogging()
       snprintf((char*)&gHostName, sizeof(gHostName), "%s",
                hostInfo.nodename);
    }
+   if(gLogAsynchronousRequested) {
+      startLogWriter();
+   }
    LOG_NOTE
    fprintf(stdlog,"Logging started, log level is %d.\n",gLogLevel);
    LOG_END
@@ -147,10 +689,14 @@ void finishLogging()
       LOG_ACTION
       fputs("Logging finished.\n",stdlog);
       LOG_END
+      stopLogWriter();
+      loggingMutexLock();
       fclose(*gStdLog);
       gCloseStdLog = false;
       *gStdLog     = stderr;
+      loggingMutexUnlock();
    }
+   stopLogWriter();
    threadSafetyDelete(&gLogMutex);
 }
 
@@ -44,6 +44,11 @@
 
 #include <errno.h>
 #include <unistd.h>
+#ifdef __cplusplus
+#include <atomic>
+#else
+#include <stdatomic.h>
+#endif
 
 
 #ifdef __cplusplus
@@ -71,58 +76,83 @@ extern unsigned int        gLogLevel;
 extern bool                gLogColorMode;
 extern FILE**              gStdLog;
 extern struct ThreadSafety gLogMutex;
+#ifdef __cplusplus
+extern std::atomic<bool>   gLogAsynchronous;
+#else
+extern atomic_bool         gLogAsynchronous;
+#endif
+extern __thread FILE*      gLogRecordFile;
 
 
 void setLogColor(const unsigned int color);
 
 
-#define stdlog (*gStdLog)
+/* Within a LOG_* block of the asynchronous backend, the output goes into
+   the thread's record buffer instead of the log file. */
+#define stdlog ((gLogRecordFile != NULL) ? gLogRecordFile : *gStdLog)
 #define logerror(text) fprintf(stdlog, "%s: %s\n", text, strerror(errno))
 
 
-#define LOG_BEGIN(prefix,c1,c2)                \
-   {                                           \
-      loggingMutexLock();                      \
-      setLogColor(c1);                         \
-      printTimeStamp(stdlog);                  \
-      setLogColor(c2);                         \
-      fprintf(stdlog,"P%lu.%lx@%s %s:%u %s()\n", \
-              (unsigned long)getpid(),           \
-              (unsigned long)pthread_self(),     \
-              getHostName(),                   \
-              __FILE__,                        \
-              __LINE__,                        \
-              __FUNCTION__                     \
-              );                               \
-      setLogColor(c1);                         \
-      printTimeStamp(stdlog);                  \
-      setLogColor(c2);                         \
+#define LOG_BEGIN(level,prefix,c1,c2)            \
+   {                                             \
+      if( (!gLogAsynchronous) ||                 \
+          (!loggingBeginRecord(level, c1, c2,    \
+                               __FILE__,         \
+                               __LINE__,         \
+                               __FUNCTION__)) ) {\
+         loggingMutexLock();                     \
+         setLogColor(c1);                        \
+         printTimeStamp(stdlog);                 \
+         setLogColor(c2);                        \
+         fprintf(stdlog,"P%lu.%lx@%s %s:%u %s()\n", \
+                 (unsigned long)getpid(),           \
+                 (unsigned long)pthread_self(),     \
+                 getHostName(),                  \
+                 __FILE__,                       \
+                 __LINE__,                       \
+                 __FUNCTION__                    \
+                 );                              \
+         setLogColor(c1);                        \
+         printTimeStamp(stdlog);                 \
+         setLogColor(c2);                        \
+      }                                          \
       fputs(prefix,stdlog);
 
-#define LOG_END             \
-      setLogColor(0);       \
-      fflush(stdlog);       \
-      loggingMutexUnlock(); \
+#define LOG_END                  \
+      if(gLogRecordFile) {       \
+         loggingEndRecord();     \
+      }                          \
+      else {                     \
+         setLogColor(0);         \
+         fflush(stdlog);         \
+         loggingMutexUnlock();   \
+      }                          \
    }
 
 #define LOG_END_FATAL                             \
       fputs("FATAL ERROR - ABORTING!\n", stdlog); \
-      setLogColor(0);                             \
-      fflush(stdlog);                             \
+      if(gLogRecordFile) {                        \
+         loggingEndRecord();                      \
+         loggingFlush();                          \
+      }                                           \
+      else {                                      \
+         setLogColor(0);                          \
+         fflush(stdlog);                          \
+      }                                           \
       abort();                                    \
    }
 
 
-#define LOG_ERROR    if((LOGLEVEL_ERROR    <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_ERROR))     LOG_BEGIN("Error: ", 9, 1)
-#define LOG_WARNING  if((LOGLEVEL_WARNING  <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_WARNING))   LOG_BEGIN("Warning: ", 13, 5)
-#define LOG_ACTION   if((LOGLEVEL_ACTION   <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_ACTION))    LOG_BEGIN("", 12, 4)
-#define LOG_NOTE     if((LOGLEVEL_NOTE     <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_NOTE))      LOG_BEGIN("", 10, 2)
+#define LOG_ERROR    if((LOGLEVEL_ERROR    <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_ERROR))     LOG_BEGIN(LOGLEVEL_ERROR, "Error: ", 9, 1)
+#define LOG_WARNING  if((LOGLEVEL_WARNING  <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_WARNING))   LOG_BEGIN(LOGLEVEL_WARNING, "Warning: ", 13, 5)
+#define LOG_ACTION   if((LOGLEVEL_ACTION   <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_ACTION))    LOG_BEGIN(LOGLEVEL_ACTION, "", 12, 4)
+#define LOG_NOTE     if((LOGLEVEL_NOTE     <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_NOTE))      LOG_BEGIN(LOGLEVEL_NOTE, "", 10, 2)
 #define LOG_VERBOSE  LOG_VERBOSE1
-#define LOG_VERBOSE1 if((LOGLEVEL_VERBOSE1 <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_VERBOSE1))  LOG_BEGIN("", 10, 3)
-#define LOG_VERBOSE2 if((LOGLEVEL_VERBOSE2 <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_VERBOSE2))  LOG_BEGIN("", 14, 6)
-#define LOG_VERBOSE3 if((LOGLEVEL_VERBOSE3 <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_VERBOSE3))  LOG_BEGIN("", 3, 3)
-#define LOG_VERBOSE4 if((LOGLEVEL_VERBOSE4 <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_VERBOSE4))  LOG_BEGIN("", 6, 6)
-#define LOG_VERBOSE5 if((LOGLEVEL_VERBOSE5 <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_VERBOSE5))  LOG_BEGIN("", 7, 7)
+#define LOG_VERBOSE1 if((LOGLEVEL_VERBOSE1 <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_VERBOSE1))  LOG_BEGIN(LOGLEVEL_VERBOSE1, "", 10, 3)
+#define LOG_VERBOSE2 if((LOGLEVEL_VERBOSE2 <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_VERBOSE2))  LOG_BEGIN(LOGLEVEL_VERBOSE2, "", 14, 6)
+#define LOG_VERBOSE3 if((LOGLEVEL_VERBOSE3 <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_VERBOSE3))  LOG_BEGIN(LOGLEVEL_VERBOSE3, "", 3, 3)
+#define LOG_VERBOSE4 if((LOGLEVEL_VERBOSE4 <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_VERBOSE4))  LOG_BEGIN(LOGLEVEL_VERBOSE4, "", 6, 6)
+#define LOG_VERBOSE5 if((LOGLEVEL_VERBOSE5 <= MAX_LOGLEVEL) && (gLogLevel >= LOGLEVEL_VERBOSE5))  LOG_BEGIN(LOGLEVEL_VERBOSE5, "", 7, 7)
 
 
 /**
@@ -153,6 +183,36 @@ void loggingMutexLock();
   */
 void loggingMutexUnlock();
 
+/**
+  * Begin a record of the asynchronous logging backend. Until
+  * loggingEndRecord(), stdlog writes into the thread's record buffer.
+  *
+  * @param level Log level.
+  * @param color1 Color of time stamp.
+  * @param color2 Color of text.
+  * @param file Source file name (must be static).
+  * @param line Source line.
+  * @param function Function name (must be static).
+  * @return true in case of success; false if the synchronous output has to be used.
+  */
+bool loggingBeginRecord(const unsigned int level,
+                        const unsigned int color1,
+                        const unsigned int color2,
+                        const char*        file,
+                        const unsigned int line,
+                        const char*        function);
+
+/**
+  * Finish record of the asynchronous logging backend and queue it
+  * for the writer thread.
+  */
+void loggingEndRecord();
+
+/**
+  * Write all queued records of the asynchronous logging backend.
+  */
+void loggingFlush();
+
 /**
   * Obtain host name.
   */
@@ -30,6 +30,11 @@
 #include "notificationqueue.h"
 #include "debug.h"
 
+#include <unistd.h>
+#ifdef HAVE_EVENTFD
+#include <sys/eventfd.h>
+#endif
+
 
 /* ###### Constructor #################################################### */
 void notificationQueueNew(struct NotificationQueue* notificationQueue)
@@ -39,6 +44,7 @@ void notificationQueueNew(struct NotificationQueue* notificationQueue)
    notificationQueue->PostReadQueue = NULL;
    notificationQueue->PostReadLast  = NULL;
    notificationQueue->EventMask     = 0;
+   notificationQueue->EventFD       = -1;
 }
 
 
@@ -46,6 +52,41 @@ void notificationQueueNew(struct NotificationQueue* notificationQueue)
 void notificationQueueDelete(struct NotificationQueue* notificationQueue)
 {
    notificationQueueClear(notificationQueue);
+   if(notificationQueue->EventFD >= 0) {
+      close(notificationQueue->EventFD);
+      notificationQueue->EventFD = -1;
+   }
+}
+
+
+/* ###### Update readability of event FD ################################# */
+static void notificationQueueUpdateEventFD(struct NotificationQueue* notificationQueue)
+{
+#ifdef HAVE_EVENTFD
+   eventfd_t value;
+
+   if(notificationQueue->EventFD >= 0) {
+      if(notificationQueueHasData(notificationQueue)) {
+         eventfd_write(notificationQueue->EventFD, 1);
+      }
+      else {
+         eventfd_read(notificationQueue->EventFD, &value);
+      }
+   }
+#endif
+}
+
+
+/* ###### Get event FD, readable while notifications are queued ########## */
+int notificationQueueGetEventFD(struct NotificationQueue* notificationQueue)
+{
+#ifdef HAVE_EVENTFD
+   if(notificationQueue->EventFD < 0) {
+      notificationQueue->EventFD = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+      notificationQueueUpdateEventFD(notificationQueue);
+   }
+#endif
+   return(notificationQueue->EventFD);
 }
 
 
@@ -68,6 +109,7 @@ void notificationQueueClear(struct NotificationQueue* notificationQueue)
       notificationQueue->PostReadQueue = next;
    }
    notificationQueue->PostReadLast = NULL;
+   notificationQueueUpdateEventFD(notificationQueue);
 }
 
 
@@ -116,6 +158,7 @@ struct NotificationNode* notificationQueueEnqueueNotification(
              }
              notificationQueue->PostReadLast = notificationNode;
          }
+         notificationQueueUpdateEventFD(notificationQueue);
       }
    }
    else {
@@ -150,6 +193,9 @@ struct NotificationNode* notificationQueueDequeueNotification(
          notificationQueue->PostReadLast = NULL;
       }
    }
+   if((notificationNode != NULL) && (!notificationQueueHasData(notificationQueue))) {
+      notificationQueueUpdateEventFD(notificationQueue);
+   }
    return(notificationNode);
 }
 
@@ -58,6 +58,7 @@ struct NotificationQueue
    struct NotificationNode* PostReadQueue;
    struct NotificationNode* PostReadLast;
    unsigned int             EventMask;
+   int                      EventFD;   /* Readable while notifications are queued */
 };
 
 
@@ -72,6 +73,7 @@ struct NotificationNode* notificationQueueDequeueNotification(
                             struct NotificationQueue* notificationQueue,
                             const bool                fromPreReadNotifications);
 bool notificationQueueHasData(struct NotificationQueue* notificationQueue);
+int notificationQueueGetEventFD(struct NotificationQueue* notificationQueue);
 void notificationNodeDelete(struct NotificationNode* notificationNode);
 
 
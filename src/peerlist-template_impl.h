@@ -304,6 +304,10 @@ struct ST_CLASS(PeerListNode)* ST_CLASS(peerListAddPeerListNode)(
 
    result = ST_METHOD(Insert)(&peerList->PeerListIndexStorage,
                               &peerListNode->PeerListIndexStorageNode);
+   if(result == NULL) {
+      *errorCode = RSPERR_OUT_OF_MEMORY;
+      return(NULL);
+   }
    if(result == &peerListNode->PeerListIndexStorageNode) {
       peerListNode->OwnerPeerList = peerList;
       *errorCode = RSPERR_OKAY;
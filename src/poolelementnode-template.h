@@ -46,6 +46,7 @@ extern "C" {
 
 /* Pool Element flags */
 #define PENF_MARKED  (1 << 0)
+#define PENF_PENDING (1 << 1)    /* Indicates pending propagation to peers      */
 #define PENF_UPDATED (1 << 14)   /* Indicates that reregistration updated entry */
 #define PENF_NEW     (1 << 15)   /* Indicates that registration added new node  */
 
@@ -70,11 +71,12 @@ struct ST_CLASS(PoolElementNode)
    unsigned int                       Flags;
 
    PoolElementSeqNumberType           SeqNumber;
-   PoolElementSeqNumberType           RoundCounter;
-   unsigned int                       VirtualCounter;
+   unsigned long long                 StridePass;
    unsigned int                       Degradation;
    unsigned int                       UnreachabilityReports;
    unsigned long long                 SelectionCounter;
+   size_t                             SelectionArrayIndex;
+   unsigned int                       SelectionWeight;
    unsigned long long                 LastUpdateTimeStamp;
 
    unsigned int                       TimerCode;
@@ -88,6 +90,11 @@ struct ST_CLASS(PoolElementNode)
 
    void*                              UserData;
    unsigned long long                 LastKeepAliveTransmission;
+
+   /* Cached wire encoding of the Pool Element parameter up to the policy
+      parameter, see rserpoolmessagecreator.c */
+   char*                              EncodedParameter;
+   size_t                             EncodedParameterSize;
 };
 
 
@@ -101,6 +108,7 @@ void ST_CLASS(poolElementNodeNew)(struct ST_CLASS(PoolElementNode)* poolElementN
                                   const int                         connectionSocketDescriptor,
                                   const sctp_assoc_t                connectionAssocID);
 void ST_CLASS(poolElementNodeDelete)(struct ST_CLASS(PoolElementNode)* poolElementNode);
+void ST_CLASS(poolElementNodeInvalidateEncodedParameter)(struct ST_CLASS(PoolElementNode)* poolElementNode);
 void ST_CLASS(poolElementNodeGetDescription)(
         const struct ST_CLASS(PoolElementNode)* poolElementNode,
         char*                                   buffer,
@@ -53,9 +53,10 @@ void ST_CLASS(poolElementNodeNew)(struct ST_CLASS(PoolElementNode)* poolElementN
    poolElementNode->Flags                      = 0;
 
    poolElementNode->SeqNumber                  = 0;
-   poolElementNode->RoundCounter               = 0;
-   poolElementNode->VirtualCounter             = 0;
+   poolElementNode->StridePass                 = 0;
    poolElementNode->SelectionCounter           = 0;
+   poolElementNode->SelectionArrayIndex        = 0;
+   poolElementNode->SelectionWeight            = 0;
    poolElementNode->Degradation                = 0;
    poolElementNode->UnreachabilityReports      = 0;
 
@@ -72,6 +73,9 @@ void ST_CLASS(poolElementNodeNew)(struct ST_CLASS(PoolElementNode)* poolElementN
 
    poolElementNode->UserData                   = 0;
    poolElementNode->LastKeepAliveTransmission  = 0;
+
+   poolElementNode->EncodedParameter           = NULL;
+   poolElementNode->EncodedParameterSize       = 0;
 }
 
 
@@ -88,9 +92,10 @@ void ST_CLASS(poolElementNodeDelete)(struct ST_CLASS(PoolElementNode)* poolEleme
    poolElementNode->RegistrationLife            = 0;
    poolElementNode->OwnerPoolNode               = NULL;
    poolElementNode->SeqNumber                   = 0;
-   poolElementNode->RoundCounter                = 0;
-   poolElementNode->VirtualCounter              = 0;
+   poolElementNode->StridePass                  = 0;
    poolElementNode->SelectionCounter            = 0;
+   poolElementNode->SelectionArrayIndex         = 0;
+   poolElementNode->SelectionWeight             = 0;
    poolElementNode->Degradation                 = 0;
    poolElementNode->UnreachabilityReports       = 0;
    poolElementNode->LastUpdateTimeStamp         = 0;
@@ -108,6 +113,18 @@ void ST_CLASS(poolElementNodeDelete)(struct ST_CLASS(PoolElementNode)* poolEleme
    STN_METHOD(Delete)(&poolElementNode->PoolElementIndexStorageNode);
    STN_METHOD(Delete)(&poolElementNode->PoolElementSelectionStorageNode);
    poolPolicySettingsDelete(&poolElementNode->PolicySettings);
+   ST_CLASS(poolElementNodeInvalidateEncodedParameter)(poolElementNode);
+}
+
+
+/* ###### Invalidate cached wire encoding ################################ */
+void ST_CLASS(poolElementNodeInvalidateEncodedParameter)(struct ST_CLASS(PoolElementNode)* poolElementNode)
+{
+   if(poolElementNode->EncodedParameter != NULL) {
+      free(poolElementNode->EncodedParameter);
+      poolElementNode->EncodedParameter = NULL;
+   }
+   poolElementNode->EncodedParameterSize = 0;
 }
 
 
@@ -175,11 +192,10 @@ void ST_CLASS(poolElementNodeGetDescription)(
       safestrcat(buffer, tmp, bufferSize);
    }
    if(fields & PENPO_POLICYSTATE) {
-      snprintf((char*)&tmp, sizeof(tmp), "\n     seq=%llu val=%llu rd=%u vrt=%u deg=$%x {sel=%llu s/w=%1.1f}",
+      snprintf((char*)&tmp, sizeof(tmp), "\n     seq=%llu val=%llu pass=%llu deg=$%x {sel=%llu s/w=%1.1f}",
                (unsigned long long)poolElementNode->SeqNumber,
                poolElementNode->PoolElementSelectionStorageNode.Value,
-               poolElementNode->RoundCounter,
-               poolElementNode->VirtualCounter,
+               poolElementNode->StridePass,
                poolElementNode->Degradation,
                poolElementNode->SelectionCounter,
                (double)poolElementNode->SelectionCounter / (double)poolElementNode->PolicySettings.Weight);
@@ -265,10 +281,6 @@ int ST_CLASS(poolElementNodeUpdate)(struct ST_CLASS(PoolElementNode)*       pool
       /* ====== Reset of degradation ===================================== */
       poolElementNode->Degradation = 0;
 
-      /* ====== Reduce virtual nodes counter, if necessary =============== */
-      if(poolElementNode->VirtualCounter > poolElementNode->PolicySettings.Weight) {
-         poolElementNode->VirtualCounter = poolElementNode->PolicySettings.Weight;
-      }
       poolElementNode->Flags |= PENF_UPDATED;
       return(1);
    }
@@ -97,3 +97,16 @@ int poolHandleComparison(const struct PoolHandle* poolHandle1,
    return(memcmp(poolHandle1->Handle, poolHandle2->Handle,
                  poolHandle1->Size));
 }
+
+
+/* ###### Pool Handle hash (FNV-1a) ###################################### */
+uint32_t poolHandleHash(const struct PoolHandle* poolHandle)
+{
+   uint32_t hash = 2166136261U;
+   size_t   i;
+
+   for(i = 0;i < poolHandle->Size;i++) {
+      hash = (hash ^ poolHandle->Handle[i]) * 16777619U;
+   }
+   return(hash);
+}
@@ -31,6 +31,7 @@
 
 #include <ctype.h>
 #include <stdio.h>
+#include <stdint.h>
 
 
 #ifdef __cplusplus
@@ -58,6 +59,7 @@ void poolHandlePrint(const struct PoolHandle* poolHandle,
                      FILE*                    fd);
 int poolHandleComparison(const struct PoolHandle* poolHandle1,
                          const struct PoolHandle* poolHandle2);
+uint32_t poolHandleHash(const struct PoolHandle* poolHandle);
 
 
 #ifdef __cplusplus
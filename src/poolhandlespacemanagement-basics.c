@@ -44,7 +44,7 @@ const char* poolHandlespaceManagementGetErrorDescription(const unsigned int erro
 /* ###### Get pool element identifier #################################### */
 PoolElementIdentifierType getPoolElementIdentifier()
 {
-   PoolElementIdentifierType poolElementIdentifier = 1 + (random32() % 0xfffffffe);
+   PoolElementIdentifierType poolElementIdentifier = 1 + (secureRandom32() % 0xfffffffe);
    return(poolElementIdentifier);
 }
 
@@ -49,6 +49,19 @@ extern "C" {
 
 #define MAX_PE_TRANSPORTADDRESSES 64
 
+/* Initial number of buckets of the pool handle hash index (power of 2) */
+#define POOL_INDEX_HASH_INITIAL_BUCKETS 64
+
+/* Number of PEs sampled for each PE selected by PowerOfTwoChoices */
+#define POWER_OF_CHOICES_SAMPLES 2
+
+/* Initial capacity of a pool's selection array */
+#define SELECTION_ARRAY_INITIAL_CAPACITY 16
+
+/* WeightedRoundRobin pass increment of a PE with weight 1; the stride of
+   a PE with weight w is STRIDE1 / w */
+#define WEIGHTED_ROUNDROBIN_STRIDE1 (1ULL << 32)
+
 
 typedef uint32_t RegistrarIdentifierType;
 typedef uint32_t PoolElementIdentifierType;
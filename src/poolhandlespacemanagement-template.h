@@ -41,6 +41,7 @@ struct ST_CLASS(PoolHandlespaceManagement)
    struct ST_CLASS(PoolHandlespaceNode) Handlespace;
    struct ST_CLASS(PoolNode)*           NewPoolNode;
    struct ST_CLASS(PoolElementNode)*    NewPoolElementNode;
+   struct SlabAllocator                 Allocator;
 
    void (*PoolNodeUserDataDisposer)(struct ST_CLASS(PoolNode)* poolNode,
                                     void*                      userData);
@@ -78,6 +79,9 @@ void ST_CLASS(poolHandlespaceManagementPrint)(
         const unsigned int                                fields);
 void ST_CLASS(poolHandlespaceManagementVerify)(
         struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement);
+void ST_CLASS(poolHandlespaceManagementPrintAllocatorStatistics)(
+        const struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement,
+        FILE*                                             fd);
 void ST_CLASS(poolHandlespaceManagementClear)(
         struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement);
 
@@ -175,6 +179,11 @@ struct ST_CLASS(PoolElementNode)* ST_CLASS(poolHandlespaceManagementFindPoolElem
 unsigned int ST_CLASS(poolHandlespaceManagementDeregisterPoolElementByPtr)(
                 struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement,
                 struct ST_CLASS(PoolElementNode)*           poolElementNode);
+unsigned int ST_CLASS(poolHandlespaceManagementUpdatePoolElementPolicySettings)(
+                struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement,
+                struct ST_CLASS(PoolElementNode)*           poolElementNode,
+                const struct PoolPolicySettings*            policySettings,
+                const unsigned long long                    currentTimeStamp);
 
 unsigned int ST_CLASS(poolHandlespaceManagementDeregisterPoolElement)(
                 struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement,
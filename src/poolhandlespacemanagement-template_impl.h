@@ -65,6 +65,18 @@ void ST_CLASS(poolHandlespaceManagementNew)(
                                                 void*                             userData),
         void* disposerUserData)
 {
+   /* Size classes: nodes and typical transport address blocks */
+   const size_t classSizes[] = {
+      sizeof(struct ST_CLASS(PoolNode)),
+      sizeof(struct ST_CLASS(PoolElementNode)),
+      transportAddressBlockGetSize(1),
+      transportAddressBlockGetSize(2),
+      transportAddressBlockGetSize(4),
+      transportAddressBlockGetSize(8)
+   };
+
+   slabAllocatorNew(&poolHandlespaceManagement->Allocator,
+                    classSizes, sizeof(classSizes) / sizeof(classSizes[0]), 0);
    ST_CLASS(poolHandlespaceNodeNew)(&poolHandlespaceManagement->Handlespace, homeRegistrarIdentifier,
                                     ST_CLASS(poolNodeUpdateNotification),
                                     (void*)poolHandlespaceManagement);
@@ -78,6 +90,39 @@ void ST_CLASS(poolHandlespaceManagementNew)(
 }
 
 
+/* ###### Duplicate TransportAddressBlock into slab ###################### */
+static struct TransportAddressBlock* ST_CLASS(poolHandlespaceManagementDuplicateTransportAddressBlock)(
+                                        struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement,
+                                        const struct TransportAddressBlock*         transportAddressBlock)
+{
+   struct TransportAddressBlock* duplicate;
+   size_t                        size;
+
+   if(transportAddressBlock) {
+      size      = transportAddressBlockGetSize(transportAddressBlock->Addresses);
+      duplicate = (struct TransportAddressBlock*)slabAllocatorAllocate(
+                     &poolHandlespaceManagement->Allocator, size);
+      if(duplicate) {
+         memcpy(duplicate, transportAddressBlock, size);
+         return(duplicate);
+      }
+   }
+   return(NULL);
+}
+
+
+/* ###### Free TransportAddressBlock from slab ########################### */
+static void ST_CLASS(poolHandlespaceManagementFreeTransportAddressBlock)(
+               struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement,
+               struct TransportAddressBlock*               transportAddressBlock)
+{
+   const size_t size = transportAddressBlockGetSize(transportAddressBlock->Addresses);
+
+   transportAddressBlockDelete(transportAddressBlock);
+   slabAllocatorFree(&poolHandlespaceManagement->Allocator, transportAddressBlock, size);
+}
+
+
 /* ###### PoolElementNode deallocation helper ############################ */
 static void ST_CLASS(poolHandlespaceManagementPoolElementNodeDisposer)(void* arg1,
                                                                        void* arg2)
@@ -89,15 +134,16 @@ static void ST_CLASS(poolHandlespaceManagementPoolElementNodeDisposer)(void* arg
                                                                  poolHandlespaceManagement->DisposerUserData);
       poolElementNode->UserData = NULL;
    }
-   transportAddressBlockDelete(poolElementNode->UserTransport);
-   free(poolElementNode->UserTransport);
+   ST_CLASS(poolHandlespaceManagementFreeTransportAddressBlock)(poolHandlespaceManagement,
+                                                                poolElementNode->UserTransport);
    poolElementNode->UserTransport = NULL;
    if(poolElementNode->RegistratorTransport) {
-      transportAddressBlockDelete(poolElementNode->RegistratorTransport);
-      free(poolElementNode->RegistratorTransport);
+      ST_CLASS(poolHandlespaceManagementFreeTransportAddressBlock)(poolHandlespaceManagement,
+                                                                   poolElementNode->RegistratorTransport);
       poolElementNode->RegistratorTransport = NULL;
    }
-   free(poolElementNode);
+   slabAllocatorFree(&poolHandlespaceManagement->Allocator,
+                     poolElementNode, sizeof(struct ST_CLASS(PoolElementNode)));
 }
 
 
@@ -112,7 +158,8 @@ static void ST_CLASS(poolHandlespaceManagementPoolNodeDisposer)(void* arg1,
                                                           poolHandlespaceManagement->DisposerUserData);
       poolNode->UserData = NULL;
    }
-   free(poolNode);
+   slabAllocatorFree(&poolHandlespaceManagement->Allocator,
+                     poolNode, sizeof(struct ST_CLASS(PoolNode)));
 }
 
 
@@ -123,13 +170,18 @@ void ST_CLASS(poolHandlespaceManagementDelete)(
    ST_CLASS(poolHandlespaceManagementClear)(poolHandlespaceManagement);
    ST_CLASS(poolHandlespaceNodeDelete)(&poolHandlespaceManagement->Handlespace);
    if(poolHandlespaceManagement->NewPoolNode) {
-      free(poolHandlespaceManagement->NewPoolNode);
+      slabAllocatorFree(&poolHandlespaceManagement->Allocator,
+                        poolHandlespaceManagement->NewPoolNode,
+                        sizeof(struct ST_CLASS(PoolNode)));
       poolHandlespaceManagement->NewPoolNode = NULL;
    }
    if(poolHandlespaceManagement->NewPoolElementNode) {
-      free(poolHandlespaceManagement->NewPoolElementNode);
+      slabAllocatorFree(&poolHandlespaceManagement->Allocator,
+                        poolHandlespaceManagement->NewPoolElementNode,
+                        sizeof(struct ST_CLASS(PoolElementNode)));
       poolHandlespaceManagement->NewPoolElementNode = NULL;
    }
+   slabAllocatorDelete(&poolHandlespaceManagement->Allocator);
 }
 
 
@@ -189,7 +241,9 @@ unsigned int ST_CLASS(poolHandlespaceManagementRegisterPoolElement)(
       return(RSPERR_INVALID_POOL_POLICY);
    }
    if(poolHandlespaceManagement->NewPoolNode == NULL) {
-      poolHandlespaceManagement->NewPoolNode = (struct ST_CLASS(PoolNode)*)malloc(sizeof(struct ST_CLASS(PoolNode)));
+      poolHandlespaceManagement->NewPoolNode = (struct ST_CLASS(PoolNode)*)slabAllocatorAllocate(
+                                                  &poolHandlespaceManagement->Allocator,
+                                                  sizeof(struct ST_CLASS(PoolNode)));
       if(poolHandlespaceManagement->NewPoolNode == NULL) {
          return(RSPERR_OUT_OF_MEMORY);
       }
@@ -200,7 +254,9 @@ unsigned int ST_CLASS(poolHandlespaceManagementRegisterPoolElement)(
                          (userTransport->Flags & TABF_CONTROLCHANNEL) ? PNF_CONTROLCHANNEL : 0);
 
    if(poolHandlespaceManagement->NewPoolElementNode == NULL) {
-      poolHandlespaceManagement->NewPoolElementNode = (struct ST_CLASS(PoolElementNode)*)malloc(sizeof(struct ST_CLASS(PoolElementNode)));
+      poolHandlespaceManagement->NewPoolElementNode = (struct ST_CLASS(PoolElementNode)*)slabAllocatorAllocate(
+                                                         &poolHandlespaceManagement->Allocator,
+                                                         sizeof(struct ST_CLASS(PoolElementNode)));
       if(poolHandlespaceManagement->NewPoolElementNode == NULL) {
          return(RSPERR_OUT_OF_MEMORY);
       }
@@ -232,32 +288,37 @@ unsigned int ST_CLASS(poolHandlespaceManagementRegisterPoolElement)(
    if(errorCode == RSPERR_OKAY) {
       (*poolElementNode)->LastUpdateTimeStamp = currentTimeStamp;
 
-      userTransportCopy        = transportAddressBlockDuplicate(userTransport);
-      registratorTransportCopy = transportAddressBlockDuplicate(registratorTransport);
+      userTransportCopy        = ST_CLASS(poolHandlespaceManagementDuplicateTransportAddressBlock)(
+                                    poolHandlespaceManagement, userTransport);
+      registratorTransportCopy = ST_CLASS(poolHandlespaceManagementDuplicateTransportAddressBlock)(
+                                    poolHandlespaceManagement, registratorTransport);
 
       if((userTransportCopy != NULL) &&
          ((registratorTransportCopy != NULL) || (registratorTransport == NULL))) {
          if((*poolElementNode)->UserTransport != userTransport) {   /* see comment above! */
-            transportAddressBlockDelete((*poolElementNode)->UserTransport);
-            free((*poolElementNode)->UserTransport);
+            if(transportAddressBlockComparison((*poolElementNode)->UserTransport, userTransport) != 0) {
+               ST_CLASS(poolElementNodeInvalidateEncodedParameter)(*poolElementNode);
+            }
+            ST_CLASS(poolHandlespaceManagementFreeTransportAddressBlock)(poolHandlespaceManagement,
+                                                                         (*poolElementNode)->UserTransport);
          }
          (*poolElementNode)->UserTransport = userTransportCopy;
 
          if(((*poolElementNode)->RegistratorTransport != registratorTransport) &&
             ((*poolElementNode)->RegistratorTransport != NULL)) {   /* see comment above! */
-            transportAddressBlockDelete((*poolElementNode)->RegistratorTransport);
-            free((*poolElementNode)->RegistratorTransport);
+            ST_CLASS(poolHandlespaceManagementFreeTransportAddressBlock)(poolHandlespaceManagement,
+                                                                         (*poolElementNode)->RegistratorTransport);
          }
          (*poolElementNode)->RegistratorTransport = registratorTransportCopy;
       }
       else {
          if(userTransportCopy) {
-            transportAddressBlockDelete(userTransportCopy);
-            free(userTransportCopy);
+            ST_CLASS(poolHandlespaceManagementFreeTransportAddressBlock)(poolHandlespaceManagement,
+                                                                         userTransportCopy);
          }
          if(registratorTransportCopy) {
-            transportAddressBlockDelete(registratorTransportCopy);
-            free(registratorTransportCopy);
+            ST_CLASS(poolHandlespaceManagementFreeTransportAddressBlock)(poolHandlespaceManagement,
+                                                                         registratorTransportCopy);
          }
          ST_CLASS(poolHandlespaceManagementDeregisterPoolElement)(
             poolHandlespaceManagement,
@@ -304,6 +365,15 @@ void ST_CLASS(poolHandlespaceManagementVerify)(
 }
 
 
+/* ###### Print allocation statistics #################################### */
+void ST_CLASS(poolHandlespaceManagementPrintAllocatorStatistics)(
+        const struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement,
+        FILE*                                             fd)
+{
+   slabAllocatorPrintStatistics(&poolHandlespaceManagement->Allocator, fd);
+}
+
+
 /* ###### Find pool element ############################################## */
 struct ST_CLASS(PoolElementNode)* ST_CLASS(poolHandlespaceManagementFindPoolElement)(
                                      struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement,
@@ -342,6 +412,30 @@ unsigned int ST_CLASS(poolHandlespaceManagementDeregisterPoolElementByPtr)(
 }
 
 
+/* ###### Update policy settings only #################################### */
+unsigned int ST_CLASS(poolHandlespaceManagementUpdatePoolElementPolicySettings)(
+                struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement,
+                struct ST_CLASS(PoolElementNode)*           poolElementNode,
+                const struct PoolPolicySettings*            policySettings,
+                const unsigned long long                    currentTimeStamp)
+{
+   unsigned int errorCode;
+
+   /* Neither transport addresses nor ownership change here. Since the
+      checksum only covers pool handle and PE identifier, it stays valid. */
+   ST_CLASS(poolNodeUpdatePoolElementNodePolicySettings)(
+      poolElementNode->OwnerPoolNode, poolElementNode,
+      policySettings, &errorCode);
+   if(errorCode == RSPERR_OKAY) {
+      poolElementNode->LastUpdateTimeStamp = currentTimeStamp;
+   }
+#ifdef VERIFY
+      ST_CLASS(poolHandlespaceNodeVerify)(&poolHandlespaceManagement->Handlespace);
+#endif
+   return(errorCode);
+}
+
+
 /* ###### Registration ################################################### */
 unsigned int ST_CLASS(poolHandlespaceManagementRegisterPoolElementByPtr)(
                 struct ST_CLASS(PoolHandlespaceManagement)* poolHandlespaceManagement,
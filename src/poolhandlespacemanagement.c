@@ -34,9 +34,9 @@
 unsigned int poolPolicyGetPoolPolicyTypeByName(const char* policyName)
 {
    size_t i;
-   for(i = 0;i < TMPL_CLASS(PoolPolicies,SimpleRedBlackTree);i++) {
-      if(strcmp(TMPL_CLASS(PoolPolicyArray,SimpleRedBlackTree)[i].Name, policyName) == 0) {
-         return(TMPL_CLASS(PoolPolicyArray,SimpleRedBlackTree)[i].Type);
+   for(i = 0;i < ST_CLASS(PoolPolicies);i++) {
+      if(strcmp(ST_CLASS(PoolPolicyArray)[i].Name, policyName) == 0) {
+         return(ST_CLASS(PoolPolicyArray)[i].Type);
       }
    }
    return(PPT_UNDEFINED);
@@ -47,9 +47,9 @@ unsigned int poolPolicyGetPoolPolicyTypeByName(const char* policyName)
 const char* poolPolicyGetPoolPolicyNameByType(const unsigned int policyType)
 {
    size_t i;
-   for(i = 0;i < TMPL_CLASS(PoolPolicies,SimpleRedBlackTree);i++) {
-      if(TMPL_CLASS(PoolPolicyArray,SimpleRedBlackTree)[i].Type == policyType) {
-         return(TMPL_CLASS(PoolPolicyArray,SimpleRedBlackTree)[i].Name);
+   for(i = 0;i < ST_CLASS(PoolPolicies);i++) {
+      if(ST_CLASS(PoolPolicyArray)[i].Type == policyType) {
+         return(ST_CLASS(PoolPolicyArray)[i].Name);
       }
    }
    return(NULL);
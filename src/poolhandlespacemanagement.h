@@ -41,6 +41,7 @@
 #include "poolhandle.h"
 #include "poolpolicysettings.h"
 #include "transportaddressblock.h"
+#include "slaballocator.h"
 #include "stringutilities.h"
 
 #include <math.h>
@@ -67,6 +68,9 @@
 #ifdef INCLUDE_LEAFLINKEDREDBLACKTREE
 #include "leaflinkedredblacktree.h"
 #endif
+#ifdef INCLUDE_BPLUSTREE
+#include "bplustree.h"
+#endif
 
 
 #define INTERNAL_POOLTEMPLATE
@@ -356,6 +360,45 @@
 #endif
 
 
+#ifdef INCLUDE_BPLUSTREE
+#define STN_CLASSNAME BPlusTreeNode
+#define STN_METHOD(x) bPlusTreeNode##x
+#define ST_CLASSNAME BPlusTree
+#define ST_CLASS(x) x##_BPlusTree
+#define ST_METHOD(x) bPlusTree##x
+
+#include "poolpolicy-template.h"
+#include "poolelementnode-template.h"
+#include "poolnode-template.h"
+#include "poolhandlespacenode-template.h"
+#include "poolhandlespacemanagement-template.h"
+#include "peerlistnode-template.h"
+#include "peerlist-template.h"
+#include "peerlistmanagement-template.h"
+#include "poolusernode-template.h"
+#include "pooluserlist-template.h"
+
+#ifdef INTERNAL_POOLTEMPLATE_IMPLEMENT_IT
+#include "poolpolicy-template_impl.h"
+#include "poolelementnode-template_impl.h"
+#include "poolnode-template_impl.h"
+#include "poolhandlespacenode-template_impl.h"
+#include "poolhandlespacemanagement-template_impl.h"
+#include "peerlistnode-template_impl.h"
+#include "peerlist-template_impl.h"
+#include "peerlistmanagement-template_impl.h"
+#include "poolusernode-template_impl.h"
+#include "pooluserlist-template_impl.h"
+#endif
+
+#undef STN_CLASSNAME
+#undef STN_METHOD
+#undef ST_CLASSNAME
+#undef ST_CLASS
+#undef ST_METHOD
+#endif
+
+
 
 
 #define TMPL_CLASS(x, c) x##_##c
@@ -411,6 +454,13 @@
 #define ST_CLASS(x) x##_LeafLinkedRedBlackTree
 #define ST_METHOD(x) leafLinkedRedBlackTree##x
 #endif
+#ifdef USE_BPLUSTREE
+#define STN_CLASSNAME BPlusTreeNode
+#define STN_METHOD(x) bPlusTreeNode##x
+#define ST_CLASSNAME BPlusTree
+#define ST_CLASS(x) x##_BPlusTree
+#define ST_METHOD(x) bPlusTree##x
+#endif
 
 
 #ifdef __cplusplus
@@ -42,6 +42,10 @@ struct ST_CLASS(PoolHandlespaceNode)
    struct ST_CLASSNAME                 PoolElementTimerStorage;      /* PEs with timer event scheduled */
    struct ST_CLASSNAME                 PoolElementConnectionStorage; /* PEs by connection              */
    struct ST_CLASSNAME                 PoolElementOwnershipStorage;  /* PEs by ownership               */
+#ifdef ENABLE_POOL_INDEX_HASH
+   struct ST_CLASS(PoolNode)**         PoolIndexHashTable;           /* Pools by handle hash           */
+   size_t                              PoolIndexHashBuckets;         /* Number of buckets (2^n)        */
+#endif
 
    HandlespaceChecksumAccumulatorType  HandlespaceChecksum;          /* Handlespace checksum           */
    HandlespaceChecksumAccumulatorType  OwnershipChecksum;            /* Ownership checksum             */
@@ -50,6 +50,15 @@ void ST_CLASS(poolHandlespaceNodeNew)(struct ST_CLASS(PoolHandlespaceNode)* pool
 
    poolHandlespaceNode->PoolNodeUpdateNotification = poolNodeUpdateNotification;
    poolHandlespaceNode->NotificationUserData       = notificationUserData;
+
+#ifdef ENABLE_POOL_INDEX_HASH
+   /* The hash index is an accelerator only: if the allocation fails,
+      lookups simply fall back to PoolIndexStorage. */
+   poolHandlespaceNode->PoolIndexHashBuckets = POOL_INDEX_HASH_INITIAL_BUCKETS;
+   poolHandlespaceNode->PoolIndexHashTable   = (struct ST_CLASS(PoolNode)**)calloc(
+                                                  poolHandlespaceNode->PoolIndexHashBuckets,
+                                                  sizeof(struct ST_CLASS(PoolNode)*));
+#endif
 }
 
 
@@ -64,6 +73,13 @@ void ST_CLASS(poolHandlespaceNodeDelete)(struct ST_CLASS(PoolHandlespaceNode)* p
    ST_METHOD(Delete)(&poolHandlespaceNode->PoolElementTimerStorage);
    ST_METHOD(Delete)(&poolHandlespaceNode->PoolElementOwnershipStorage);
    ST_METHOD(Delete)(&poolHandlespaceNode->PoolElementConnectionStorage);
+#ifdef ENABLE_POOL_INDEX_HASH
+   if(poolHandlespaceNode->PoolIndexHashTable) {
+      free(poolHandlespaceNode->PoolIndexHashTable);
+      poolHandlespaceNode->PoolIndexHashTable = NULL;
+   }
+   poolHandlespaceNode->PoolIndexHashBuckets = 0;
+#endif
    poolHandlespaceNode->HandlespaceChecksum = 0;
    poolHandlespaceNode->OwnershipChecksum   = 0;
    poolHandlespaceNode->PoolElements        = 0;
@@ -418,6 +434,77 @@ size_t ST_CLASS(poolHandlespaceNodeSelectPoolElementNodesByPolicy)(
 }
 
 
+#ifdef ENABLE_POOL_INDEX_HASH
+/* ###### Grow hash index ################################################ */
+static void ST_CLASS(poolHandlespaceNodeGrowPoolIndexHash)(
+               struct ST_CLASS(PoolHandlespaceNode)* poolHandlespaceNode)
+{
+   const size_t                newBuckets = 2 * poolHandlespaceNode->PoolIndexHashBuckets;
+   struct ST_CLASS(PoolNode)** newTable;
+   struct ST_CLASS(PoolNode)*  poolNode;
+   struct ST_CLASS(PoolNode)*  nextPoolNode;
+   size_t                      i;
+
+   newTable = (struct ST_CLASS(PoolNode)**)calloc(newBuckets, sizeof(struct ST_CLASS(PoolNode)*));
+   if(newTable == NULL) {
+      return;   /* Keep the current table; chains just get longer. */
+   }
+   for(i = 0;i < poolHandlespaceNode->PoolIndexHashBuckets;i++) {
+      poolNode = poolHandlespaceNode->PoolIndexHashTable[i];
+      while(poolNode != NULL) {
+         nextPoolNode = poolNode->PoolIndexHashNext;
+         poolNode->PoolIndexHashNext = newTable[poolNode->PoolIndexHash & (newBuckets - 1)];
+         newTable[poolNode->PoolIndexHash & (newBuckets - 1)] = poolNode;
+         poolNode = nextPoolNode;
+      }
+   }
+   free(poolHandlespaceNode->PoolIndexHashTable);
+   poolHandlespaceNode->PoolIndexHashTable   = newTable;
+   poolHandlespaceNode->PoolIndexHashBuckets = newBuckets;
+}
+
+
+/* ###### Link PoolNode into hash index ################################## */
+static void ST_CLASS(poolHandlespaceNodeLinkPoolIndexHash)(
+               struct ST_CLASS(PoolHandlespaceNode)* poolHandlespaceNode,
+               struct ST_CLASS(PoolNode)*            poolNode)
+{
+   struct ST_CLASS(PoolNode)** bucket;
+
+   if(poolHandlespaceNode->PoolIndexHashTable) {
+      if(ST_METHOD(GetElements)(&poolHandlespaceNode->PoolIndexStorage) >
+            poolHandlespaceNode->PoolIndexHashBuckets) {
+         ST_CLASS(poolHandlespaceNodeGrowPoolIndexHash)(poolHandlespaceNode);
+      }
+      bucket = &poolHandlespaceNode->PoolIndexHashTable[poolNode->PoolIndexHash &
+                                                        (poolHandlespaceNode->PoolIndexHashBuckets - 1)];
+      poolNode->PoolIndexHashNext = *bucket;
+      *bucket = poolNode;
+   }
+}
+
+
+/* ###### Unlink PoolNode from hash index ################################ */
+static void ST_CLASS(poolHandlespaceNodeUnlinkPoolIndexHash)(
+               struct ST_CLASS(PoolHandlespaceNode)* poolHandlespaceNode,
+               struct ST_CLASS(PoolNode)*            poolNode)
+{
+   struct ST_CLASS(PoolNode)** bucket;
+
+   if(poolHandlespaceNode->PoolIndexHashTable) {
+      bucket = &poolHandlespaceNode->PoolIndexHashTable[poolNode->PoolIndexHash &
+                                                        (poolHandlespaceNode->PoolIndexHashBuckets - 1)];
+      while(*bucket != poolNode) {
+         CHECK(*bucket != NULL);
+         bucket = &(*bucket)->PoolIndexHashNext;
+      }
+      *bucket = poolNode->PoolIndexHashNext;
+      poolNode->PoolIndexHashNext = NULL;
+   }
+}
+#endif
+
+
 /* ###### Add PoolNode ################################################### */
 struct ST_CLASS(PoolNode)* ST_CLASS(poolHandlespaceNodeAddPoolNode)(
                               struct ST_CLASS(PoolHandlespaceNode)* poolHandlespaceNode,
@@ -425,8 +512,14 @@ struct ST_CLASS(PoolNode)* ST_CLASS(poolHandlespaceNodeAddPoolNode)(
 {
    struct STN_CLASSNAME* result = ST_METHOD(Insert)(&poolHandlespaceNode->PoolIndexStorage,
                                                     &poolNode->PoolIndexStorageNode);
+   if(result == NULL) {
+      return(NULL);   /* Out of memory */
+   }
    if(result == &poolNode->PoolIndexStorageNode) {
       poolNode->OwnerPoolHandlespaceNode = poolHandlespaceNode;
+#ifdef ENABLE_POOL_INDEX_HASH
+      ST_CLASS(poolHandlespaceNodeLinkPoolIndexHash)(poolHandlespaceNode, poolNode);
+#endif
    }
    return((struct ST_CLASS(PoolNode)*)result);
 }
@@ -454,6 +547,22 @@ struct ST_CLASS(PoolNode)* ST_CLASS(poolHandlespaceNodeFindPoolNode)(
 {
    struct ST_CLASS(PoolNode)* poolNode;
    struct ST_CLASS(PoolNode)  cmpPoolNode;
+#ifdef ENABLE_POOL_INDEX_HASH
+   uint32_t                   hash;
+
+   if(poolHandlespaceNode->PoolIndexHashTable) {
+      hash     = poolHandleHash(poolHandle);
+      poolNode = poolHandlespaceNode->PoolIndexHashTable[hash & (poolHandlespaceNode->PoolIndexHashBuckets - 1)];
+      while(poolNode != NULL) {
+         if( (poolNode->PoolIndexHash == hash) &&
+             (poolHandleComparison(&poolNode->Handle, poolHandle) == 0) ) {
+            break;
+         }
+         poolNode = poolNode->PoolIndexHashNext;
+      }
+      return(poolNode);
+   }
+#endif
 
    poolHandleNew(&cmpPoolNode.Handle, poolHandle->Handle, poolHandle->Size);
    poolNode = (struct ST_CLASS(PoolNode)*)ST_METHOD(Find)(&poolHandlespaceNode->PoolIndexStorage,
@@ -537,6 +646,9 @@ struct ST_CLASS(PoolNode)* ST_CLASS(poolHandlespaceNodeRemovePoolNode)(
    const struct STN_CLASSNAME* result = ST_METHOD(Remove)(&poolHandlespaceNode->PoolIndexStorage,
                                                           &poolNode->PoolIndexStorageNode);
    CHECK(result == &poolNode->PoolIndexStorageNode);
+#ifdef ENABLE_POOL_INDEX_HASH
+   ST_CLASS(poolHandlespaceNodeUnlinkPoolIndexHash)(poolHandlespaceNode, poolNode);
+#endif
    poolNode->OwnerPoolHandlespaceNode = NULL;
    return(poolNode);
 }
@@ -560,15 +672,32 @@ struct ST_CLASS(PoolElementNode)* ST_CLASS(poolHandlespaceNodeAddPoolElementNode
       if(poolElementNode->HomeRegistrarIdentifier != 0) {
          result2 = ST_METHOD(Insert)(&poolHandlespaceNode->PoolElementOwnershipStorage,
                                      &poolElementNode->PoolElementOwnershipStorageNode);
+         if(result2 == NULL) {
+            goto out_of_memory;
+         }
          CHECK(result2 == &poolElementNode->PoolElementOwnershipStorageNode);
       }
       if(poolElementNode->ConnectionSocketDescriptor > 0) {
          result2 = ST_METHOD(Insert)(&poolHandlespaceNode->PoolElementConnectionStorage,
                                      &poolElementNode->PoolElementConnectionStorageNode);
+         if(result2 == NULL) {
+            goto out_of_memory;
+         }
          CHECK(result2 == &poolElementNode->PoolElementConnectionStorageNode);
       }
    }
    return(result);
+
+   /* ====== Undo insertion ============================================== */
+out_of_memory:
+   if(STN_METHOD(IsLinked)(&poolElementNode->PoolElementOwnershipStorageNode)) {
+      ST_METHOD(Remove)(&poolHandlespaceNode->PoolElementOwnershipStorage,
+                        &poolElementNode->PoolElementOwnershipStorageNode);
+   }
+   ST_CLASS(poolNodeRemovePoolElementNode)(poolNode, poolElementNode);
+   poolHandlespaceNode->PoolElements--;
+   *errorCode = RSPERR_OUT_OF_MEMORY;
+   return(NULL);
 }
 
 
@@ -595,6 +724,7 @@ void ST_CLASS(poolHandlespaceNodeUpdateOwnershipOfPoolElementNode)(
       }
       poolElementNode->Flags |= PENF_UPDATED;
       poolElementNode->HomeRegistrarIdentifier = newHomeRegistrarIdentifier;
+      ST_CLASS(poolElementNodeInvalidateEncodedParameter)(poolElementNode);
       result = ST_METHOD(Insert)(&poolHandlespaceNode->PoolElementOwnershipStorage,
                                  &poolElementNode->PoolElementOwnershipStorageNode);
       CHECK(result == &poolElementNode->PoolElementOwnershipStorageNode);
@@ -715,6 +845,10 @@ struct ST_CLASS(PoolElementNode)* ST_CLASS(poolHandlespaceNodeAddOrUpdatePoolEle
    struct ST_CLASS(PoolElementNode)* newPoolElementNode;
 
    newPoolNode = ST_CLASS(poolHandlespaceNodeAddPoolNode)(poolHandlespaceNode, *poolNode);
+   if(newPoolNode == NULL) {
+      *errorCode = RSPERR_OUT_OF_MEMORY;
+      return(NULL);
+   }
    newPoolElementNode = ST_CLASS(poolHandlespaceNodeAddPoolElementNode)(poolHandlespaceNode, newPoolNode, *poolElementNode, errorCode);
 
    if(newPoolElementNode != NULL) {
@@ -944,6 +1078,16 @@ void ST_CLASS(poolHandlespaceNodeVerify)(struct ST_CLASS(PoolHandlespaceNode)* p
 
    ST_METHOD(Verify)(&poolHandlespaceNode->PoolIndexStorage);
    ST_METHOD(Verify)(&poolHandlespaceNode->PoolElementTimerStorage);
+#ifdef ENABLE_POOL_INDEX_HASH
+   if(poolHandlespaceNode->PoolIndexHashTable) {
+      poolNode = ST_CLASS(poolHandlespaceNodeGetFirstPoolNode)(poolHandlespaceNode);
+      while(poolNode != NULL) {
+         CHECK(poolNode->PoolIndexHash == poolHandleHash(&poolNode->Handle));
+         CHECK(ST_CLASS(poolHandlespaceNodeFindPoolNode)(poolHandlespaceNode, &poolNode->Handle) == poolNode);
+         poolNode = ST_CLASS(poolHandlespaceNodeGetNextPoolNode)(poolHandlespaceNode, poolNode);
+      }
+   }
+#endif
    ST_METHOD(Verify)(&poolHandlespaceNode->PoolElementOwnershipStorage);
 
    i = 0;
@@ -47,6 +47,15 @@ struct ST_CLASS(PoolNode)
    struct ST_CLASSNAME                   PoolElementSelectionStorage;
    struct ST_CLASSNAME                   PoolElementIndexStorage;
    struct ST_CLASS(PoolHandlespaceNode)* OwnerPoolHandlespaceNode;
+   struct ST_CLASS(PoolElementNode)**    SelectionArray;
+   size_t                                SelectionArraySize;
+   size_t                                SelectionArrayCapacity;
+   unsigned long long*                   SelectionWeightTree;
+   struct ST_CLASS(PoolElementNode)*     SelectionCursor;
+#ifdef ENABLE_POOL_INDEX_HASH
+   struct ST_CLASS(PoolNode)*            PoolIndexHashNext;
+   uint32_t                              PoolIndexHash;
+#endif
 
    struct PoolHandle                     Handle;
    const struct ST_CLASS(PoolPolicy)*    Policy;
@@ -90,9 +99,18 @@ struct ST_CLASS(PoolElementNode)* ST_CLASS(poolNodeGetPrevPoolElementNodeFromSel
 void ST_CLASS(poolNodeUnlinkPoolElementNodeFromSelection)(
         struct ST_CLASS(PoolNode)*        poolNode,
         struct ST_CLASS(PoolElementNode)* poolElementNode);
-void ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(
+int ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(
         struct ST_CLASS(PoolNode)*        poolNode,
         struct ST_CLASS(PoolElementNode)* poolElementNode);
+void ST_CLASS(poolNodeSetPoolElementNodeSelectionWeight)(
+        struct ST_CLASS(PoolNode)*        poolNode,
+        struct ST_CLASS(PoolElementNode)* poolElementNode,
+        const unsigned int                selectionWeight);
+unsigned long long ST_CLASS(poolNodeGetSelectionWeightSum)(
+                      const struct ST_CLASS(PoolNode)* poolNode);
+struct ST_CLASS(PoolElementNode)* ST_CLASS(poolNodeGetPoolElementNodeBySelectionWeight)(
+                                     struct ST_CLASS(PoolNode)* poolNode,
+                                     unsigned long long         value);
 unsigned int ST_CLASS(poolNodeCheckPoolElementNodeCompatibility)(
                 struct ST_CLASS(PoolNode)*          poolNode,
                 struct ST_CLASS(PoolElementNode)*   poolElementNode);
@@ -105,6 +123,11 @@ void ST_CLASS(poolNodeUpdatePoolElementNode)(
         struct ST_CLASS(PoolElementNode)*       poolElementNode,
         const struct ST_CLASS(PoolElementNode)* source,
         unsigned int*                           errorCode);
+void ST_CLASS(poolNodeUpdatePoolElementNodePolicySettings)(
+        struct ST_CLASS(PoolNode)*        poolNode,
+        struct ST_CLASS(PoolElementNode)* poolElementNode,
+        const struct PoolPolicySettings*  policySettings,
+        unsigned int*                     errorCode);
 struct ST_CLASS(PoolElementNode)* ST_CLASS(poolNodeFindPoolElementNode)(
                                      struct ST_CLASS(PoolNode)*      poolNode,
                                      const PoolElementIdentifierType identifier);
@@ -62,6 +62,15 @@ void ST_CLASS(poolNodeNew)(struct ST_CLASS(PoolNode)*         poolNode,
    poolNode->GlobalSeqNumber        = SeqNumberStart;
    poolNode->UserData               = NULL;
    poolNode->OwnerPoolHandlespaceNode = NULL;
+   poolNode->SelectionArray         = NULL;
+   poolNode->SelectionArraySize     = 0;
+   poolNode->SelectionArrayCapacity = 0;
+   poolNode->SelectionWeightTree    = NULL;
+   poolNode->SelectionCursor        = NULL;
+#ifdef ENABLE_POOL_INDEX_HASH
+   poolNode->PoolIndexHashNext      = NULL;
+   poolNode->PoolIndexHash          = poolHandleHash(&poolNode->Handle);
+#endif
    ST_METHOD(New)(&poolNode->PoolElementSelectionStorage, ST_CLASS(poolElementSelectionStorageNodePrint), ST_CLASS(poolElementSelectionStorageNodeComparison));
    ST_METHOD(New)(&poolNode->PoolElementIndexStorage, ST_CLASS(poolElementIndexStorageNodePrint), ST_CLASS(poolElementIndexStorageNodeComparison));
 }
@@ -72,9 +81,20 @@ void ST_CLASS(poolNodeDelete)(struct ST_CLASS(PoolNode)* poolNode)
 {
    CHECK(!STN_METHOD(IsLinked)(&poolNode->PoolIndexStorageNode));
    CHECK(ST_METHOD(IsEmpty)(&poolNode->PoolElementSelectionStorage));
+   CHECK(poolNode->SelectionArraySize == 0);
+   CHECK(poolNode->SelectionCursor == NULL);
    poolHandleDelete(&poolNode->Handle);
    ST_METHOD(Delete)(&poolNode->PoolElementSelectionStorage);
    ST_METHOD(Delete)(&poolNode->PoolElementIndexStorage);
+   if(poolNode->SelectionArray) {
+      free(poolNode->SelectionArray);
+      poolNode->SelectionArray         = NULL;
+      poolNode->SelectionArrayCapacity = 0;
+   }
+   if(poolNode->SelectionWeightTree) {
+      free(poolNode->SelectionWeightTree);
+      poolNode->SelectionWeightTree = NULL;
+   }
    poolNode->Protocol = 0;
    poolNode->UserData = NULL;
 }
@@ -323,19 +343,43 @@ struct ST_CLASS(PoolElementNode)* ST_CLASS(poolNodeGetPrevPoolElementNodeFromSel
 }
 
 
+/* ###### Move selection cursor away from PoolElementNode ################ */
+static void ST_CLASS(poolNodeMoveSelectionCursorFromPoolElementNode)(
+               struct ST_CLASS(PoolNode)*        poolNode,
+               struct ST_CLASS(PoolElementNode)* poolElementNode)
+{
+   /* The cursor must not point to a PE that leaves the selection storage.
+      It is moved to the successor in the ring. */
+   if(poolNode->SelectionCursor == poolElementNode) {
+      poolNode->SelectionCursor =
+         ST_CLASS(poolNodeGetNextPoolElementNodeFromSelection)(poolNode, poolElementNode);
+      if(poolNode->SelectionCursor == NULL) {
+         poolNode->SelectionCursor =
+            ST_CLASS(poolNodeGetFirstPoolElementNodeFromSelection)(poolNode);
+         if(poolNode->SelectionCursor == poolElementNode) {
+            poolNode->SelectionCursor = NULL;
+         }
+      }
+   }
+}
+
+
 /* ###### Unlink PoolElementNode from Selection ########################## */
 void ST_CLASS(poolNodeUnlinkPoolElementNodeFromSelection)(
         struct ST_CLASS(PoolNode)*        poolNode,
         struct ST_CLASS(PoolElementNode)* poolElementNode)
 {
-   struct STN_CLASSNAME* node = ST_METHOD(Remove)(&poolNode->PoolElementSelectionStorage,
-                                                  &poolElementNode->PoolElementSelectionStorageNode);
+   struct STN_CLASSNAME* node;
+
+   ST_CLASS(poolNodeMoveSelectionCursorFromPoolElementNode)(poolNode, poolElementNode);
+   node = ST_METHOD(Remove)(&poolNode->PoolElementSelectionStorage,
+                            &poolElementNode->PoolElementSelectionStorageNode);
    CHECK(node == &poolElementNode->PoolElementSelectionStorageNode);
 }
 
 
 /* ###### Link PoolElementNode into Selection ############################ */
-void ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(
+int ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(
         struct ST_CLASS(PoolNode)*        poolNode,
         struct ST_CLASS(PoolElementNode)* poolElementNode)
 {
@@ -349,7 +393,188 @@ void ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(
 
    node = ST_METHOD(Insert)(&poolNode->PoolElementSelectionStorage,
                             &poolElementNode->PoolElementSelectionStorageNode);
+   if(node == NULL) {
+      return(0);   /* Out of memory */
+   }
    CHECK(node == &poolElementNode->PoolElementSelectionStorageNode);
+
+   if(poolNode->Policy->Flags & PPF_WEIGHT_TREE) {
+      ST_CLASS(poolNodeSetPoolElementNodeSelectionWeight)(
+         poolNode, poolElementNode,
+         (unsigned int)poolElementNode->PoolElementSelectionStorageNode.Value);
+   }
+   return(1);
+}
+
+
+/*
+   The selection weights of a PPF_WEIGHT_TREE pool are kept in a Fenwick
+   tree over the SelectionArray positions: SelectionWeightTree[i] (1-based)
+   holds the weight sum of the positions (i - lowbit(i), i]. Its size is
+   always SelectionArrayCapacity + 1, unused positions have weight 0.
+*/
+
+/* ###### Rebuild selection weight tree for new capacity ################# */
+static int ST_CLASS(poolNodeRebuildSelectionWeightTree)(
+              struct ST_CLASS(PoolNode)* poolNode,
+              const size_t               capacity)
+{
+   unsigned long long* selectionWeightTree;
+   size_t              i, j;
+
+   selectionWeightTree = (unsigned long long*)realloc(
+                            poolNode->SelectionWeightTree,
+                            (capacity + 1) * sizeof(unsigned long long));
+   if(selectionWeightTree == NULL) {
+      return(0);
+   }
+   poolNode->SelectionWeightTree = selectionWeightTree;
+
+   /* Linear-time construction: propagate each sum to its parent */
+   memset(selectionWeightTree, 0, (capacity + 1) * sizeof(unsigned long long));
+   for(i = 1;i <= capacity;i++) {
+      if(i <= poolNode->SelectionArraySize) {
+         selectionWeightTree[i] += poolNode->SelectionArray[i - 1]->SelectionWeight;
+      }
+      j = i + (i & (~i + 1));
+      if(j <= capacity) {
+         selectionWeightTree[j] += selectionWeightTree[i];
+      }
+   }
+   return(1);
+}
+
+
+/* ###### Set selection weight of PoolElementNode ######################## */
+void ST_CLASS(poolNodeSetPoolElementNodeSelectionWeight)(
+        struct ST_CLASS(PoolNode)*        poolNode,
+        struct ST_CLASS(PoolElementNode)* poolElementNode,
+        const unsigned int                selectionWeight)
+{
+   /* Unsigned arithmetic: adding the two's complement subtracts */
+   const unsigned long long delta = (unsigned long long)selectionWeight -
+                                       (unsigned long long)poolElementNode->SelectionWeight;
+   size_t                   i;
+
+   CHECK(poolNode->Policy->Flags & PPF_WEIGHT_TREE);
+   CHECK(poolNode->SelectionArray[poolElementNode->SelectionArrayIndex] == poolElementNode);
+
+   for(i = poolElementNode->SelectionArrayIndex + 1;
+       i <= poolNode->SelectionArrayCapacity;
+       i += (i & (~i + 1))) {
+      poolNode->SelectionWeightTree[i] += delta;
+   }
+   poolElementNode->SelectionWeight = selectionWeight;
+}
+
+
+/* ###### Get sum of all selection weights ############################### */
+unsigned long long ST_CLASS(poolNodeGetSelectionWeightSum)(
+                      const struct ST_CLASS(PoolNode)* poolNode)
+{
+   unsigned long long sum = 0;
+   size_t             i;
+
+   /* The capacity is a power of 2, i.e. the loop usually runs only once */
+   for(i = poolNode->SelectionArrayCapacity;i > 0;i -= (i & (~i + 1))) {
+      sum += poolNode->SelectionWeightTree[i];
+   }
+   return(sum);
+}
+
+
+/* ###### Get PoolElementNode by selection weight value ################## */
+struct ST_CLASS(PoolElementNode)* ST_CLASS(poolNodeGetPoolElementNodeBySelectionWeight)(
+                                     struct ST_CLASS(PoolNode)* poolNode,
+                                     unsigned long long         value)
+{
+   size_t position = 0;
+   size_t step     = 1;
+
+   /* Find the first position whose prefix sum exceeds value */
+   while(2 * step <= poolNode->SelectionArrayCapacity) {
+      step *= 2;
+   }
+   for( ;step > 0;step /= 2) {
+      if( (position + step <= poolNode->SelectionArrayCapacity) &&
+          (poolNode->SelectionWeightTree[position + step] <= value) ) {
+         position += step;
+         value    -= poolNode->SelectionWeightTree[position];
+      }
+   }
+   if(position < poolNode->SelectionArraySize) {
+      return(poolNode->SelectionArray[position]);
+   }
+   return(NULL);
+}
+
+
+/* ###### Append PoolElementNode to selection array ###################### */
+static int ST_CLASS(poolNodeAppendPoolElementNodeToSelectionArray)(
+              struct ST_CLASS(PoolNode)*        poolNode,
+              struct ST_CLASS(PoolElementNode)* poolElementNode)
+{
+   struct ST_CLASS(PoolElementNode)** selectionArray;
+   size_t                             capacity;
+
+   if(poolNode->SelectionArraySize >= poolNode->SelectionArrayCapacity) {
+      capacity = (poolNode->SelectionArrayCapacity > 0) ?
+                    2 * poolNode->SelectionArrayCapacity : SELECTION_ARRAY_INITIAL_CAPACITY;
+      selectionArray = (struct ST_CLASS(PoolElementNode)**)realloc(
+                          poolNode->SelectionArray,
+                          capacity * sizeof(struct ST_CLASS(PoolElementNode)*));
+      if(selectionArray == NULL) {
+         return(0);
+      }
+      poolNode->SelectionArray = selectionArray;
+      if(poolNode->Policy->Flags & PPF_WEIGHT_TREE) {
+         if(!ST_CLASS(poolNodeRebuildSelectionWeightTree)(poolNode, capacity)) {
+            return(0);
+         }
+      }
+      poolNode->SelectionArrayCapacity = capacity;
+   }
+   /* The new entry gets its weight when it is linked into the selection */
+   poolElementNode->SelectionArrayIndex = poolNode->SelectionArraySize;
+   poolElementNode->SelectionWeight     = 0;
+   poolNode->SelectionArray[poolNode->SelectionArraySize++] = poolElementNode;
+   return(1);
+}
+
+
+/* ###### Remove PoolElementNode from selection array #################### */
+static void ST_CLASS(poolNodeRemovePoolElementNodeFromSelectionArray)(
+               struct ST_CLASS(PoolNode)*        poolNode,
+               struct ST_CLASS(PoolElementNode)* poolElementNode)
+{
+   struct ST_CLASS(PoolElementNode)* lastPoolElementNode;
+   const size_t                      index = poolElementNode->SelectionArrayIndex;
+
+   unsigned int                      lastSelectionWeight;
+
+   CHECK(index < poolNode->SelectionArraySize);
+   CHECK(poolNode->SelectionArray[index] == poolElementNode);
+
+   /* Move the last entry into the gap */
+   lastPoolElementNode = poolNode->SelectionArray[poolNode->SelectionArraySize - 1];
+   if(poolNode->Policy->Flags & PPF_WEIGHT_TREE) {
+      /* Unused positions of the weight tree must have weight 0 */
+      ST_CLASS(poolNodeSetPoolElementNodeSelectionWeight)(poolNode, poolElementNode, 0);
+      if(lastPoolElementNode != poolElementNode) {
+         lastSelectionWeight = lastPoolElementNode->SelectionWeight;
+         ST_CLASS(poolNodeSetPoolElementNodeSelectionWeight)(poolNode, lastPoolElementNode, 0);
+         poolNode->SelectionArray[index]          = lastPoolElementNode;
+         lastPoolElementNode->SelectionArrayIndex = index;
+         ST_CLASS(poolNodeSetPoolElementNodeSelectionWeight)(poolNode, lastPoolElementNode,
+                                                             lastSelectionWeight);
+      }
+   }
+   else {
+      poolNode->SelectionArray[index]          = lastPoolElementNode;
+      lastPoolElementNode->SelectionArrayIndex = index;
+   }
+   poolNode->SelectionArraySize--;
+   poolElementNode->SelectionArrayIndex = 0;
 }
 
 
@@ -368,22 +593,42 @@ struct ST_CLASS(PoolElementNode)* ST_CLASS(poolNodeAddPoolElementNode)(
 
    result = ST_METHOD(Insert)(&poolNode->PoolElementIndexStorage,
                               &poolElementNode->PoolElementIndexStorageNode);
+   if(result == NULL) {
+      *errorCode = RSPERR_OUT_OF_MEMORY;
+      return(NULL);
+   }
    if(result == &poolElementNode->PoolElementIndexStorageNode) {
+      if(poolNode->Policy->Flags & PPF_SELECTION_ARRAY) {
+         if(!ST_CLASS(poolNodeAppendPoolElementNodeToSelectionArray)(poolNode, poolElementNode)) {
+            ST_METHOD(Remove)(&poolNode->PoolElementIndexStorage,
+                              &poolElementNode->PoolElementIndexStorageNode);
+            *errorCode = RSPERR_OUT_OF_MEMORY;
+            return(NULL);
+         }
+      }
       if((PoolElementSeqNumberType)(poolNode->GlobalSeqNumber + 1) <
          poolNode->GlobalSeqNumber) {
          ST_CLASS(poolNodeResequence)(poolNode);
       }
       poolElementNode->Flags |= PENF_UPDATED;
       poolElementNode->SeqNumber        = poolNode->GlobalSeqNumber++;
-      poolElementNode->VirtualCounter   = 0;
-      poolElementNode->RoundCounter     = 0;
+      poolElementNode->StridePass       = 0;
       poolElementNode->SelectionCounter = 0;
       poolElementNode->Degradation      = 0;
       poolElementNode->OwnerPoolNode    = poolNode;
       if(poolNode->Policy->InitializePoolElementNodeFunction) {
          poolNode->Policy->InitializePoolElementNodeFunction(poolElementNode);
       }
-      ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(poolNode, poolElementNode);
+      if(!ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(poolNode, poolElementNode)) {
+         if(poolNode->Policy->Flags & PPF_SELECTION_ARRAY) {
+            ST_CLASS(poolNodeRemovePoolElementNodeFromSelectionArray)(poolNode, poolElementNode);
+         }
+         ST_METHOD(Remove)(&poolNode->PoolElementIndexStorage,
+                           &poolElementNode->PoolElementIndexStorageNode);
+         poolElementNode->OwnerPoolNode = NULL;
+         *errorCode = RSPERR_OUT_OF_MEMORY;
+         return(NULL);
+      }
       *errorCode = RSPERR_OKAY;
       return(poolElementNode);
    }
@@ -401,18 +646,47 @@ void ST_CLASS(poolNodeUpdatePoolElementNode)(
 {
    *errorCode = ST_CLASS(poolNodeCheckPoolElementNodeCompatibility)(poolNode, poolElementNode);
    if(*errorCode == RSPERR_OKAY) {
-      if(ST_CLASS(poolElementNodeUpdate)(poolElementNode, source)) {
+      if( (ST_CLASS(poolElementNodeUpdate)(poolElementNode, source)) &&
+          (!(poolNode->Policy->Flags & PPF_STATIC_ORDER)) ) {
          /*
             Policy information has changed. Now, the node has to be re-inserted (Selection only).
             Currently, the node's position may be incorrect now!
+            Policies with static selection order (e.g. PowerOfTwoChoices)
+            do not depend on the policy information here.
          */
          ST_CLASS(poolNodeUnlinkPoolElementNodeFromSelection)(poolNode, poolElementNode);
-         ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(poolNode, poolElementNode);
+         CHECK(ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(poolNode, poolElementNode));
       }
    }
 }
 
 
+/* ###### Update PoolElementNode's policy settings ####################### */
+void ST_CLASS(poolNodeUpdatePoolElementNodePolicySettings)(
+        struct ST_CLASS(PoolNode)*        poolNode,
+        struct ST_CLASS(PoolElementNode)* poolElementNode,
+        const struct PoolPolicySettings*  policySettings,
+        unsigned int*                     errorCode)
+{
+   struct ST_CLASS(PoolElementNode) source;
+
+   /* The new settings have to be checked here, since
+      poolNodeUpdatePoolElementNode() only checks the existing node. */
+   source.PolicySettings = *policySettings;
+   if(!poolPolicySettingsIsValid(&source.PolicySettings)) {
+      *errorCode = RSPERR_INVALID_POOL_POLICY;
+      return;
+   }
+   if(poolPolicySettingsAdapt(&source.PolicySettings, poolNode->Policy->Type) == 0) {
+      *errorCode = RSPERR_INCOMPATIBLE_POOL_POLICY;
+      return;
+   }
+
+   /* Only the policy settings of source are used for the update */
+   ST_CLASS(poolNodeUpdatePoolElementNode)(poolNode, poolElementNode, &source, errorCode);
+}
+
+
 /* ###### Find PoolElementNode ########################################### */
 struct ST_CLASS(PoolElementNode)* ST_CLASS(poolNodeFindPoolElementNode)(
                                      struct ST_CLASS(PoolNode)*      poolNode,
@@ -459,9 +733,13 @@ struct ST_CLASS(PoolElementNode)* ST_CLASS(poolNodeRemovePoolElementNode)(
    result = ST_METHOD(Remove)(&poolNode->PoolElementIndexStorage,
                               &poolElementNode->PoolElementIndexStorageNode);
    CHECK(result == &poolElementNode->PoolElementIndexStorageNode);
+   ST_CLASS(poolNodeMoveSelectionCursorFromPoolElementNode)(poolNode, poolElementNode);
    result = ST_METHOD(Remove)(&poolNode->PoolElementSelectionStorage,
                               &poolElementNode->PoolElementSelectionStorageNode);
    CHECK(result != NULL);
+   if(poolNode->Policy->Flags & PPF_SELECTION_ARRAY) {
+      ST_CLASS(poolNodeRemovePoolElementNodeFromSelectionArray)(poolNode, poolElementNode);
+   }
    poolElementNode->OwnerPoolNode = NULL;
    return(poolElementNode);
 }
@@ -39,10 +39,19 @@ extern "C" {
 struct ST_CLASS(PoolElementNode);
 struct ST_CLASS(PoolNode);
 
+
+#define PPF_SELECTION_ARRAY (1 << 0)   /* PEs are kept in PoolNode's SelectionArray    */
+#define PPF_STATIC_ORDER    (1 << 1)   /* Policy updates do not change selection order */
+#define PPF_WEIGHT_TREE     (1 << 2)   /* Selection weights are kept in a Fenwick tree */
+                                       /* over the SelectionArray                      */
+#define PPF_SELECTION_CURSOR (1 << 3)  /* Selection advances PoolNode's SelectionCursor */
+                                       /* instead of reordering the selection storage  */
+
 struct ST_CLASS(PoolPolicy)
 {
    unsigned int Type;
    const char*  Name;
+   unsigned int Flags;
 
    size_t       DefaultMaxIncrement;
 
@@ -62,6 +71,32 @@ extern const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[];
 extern const size_t ST_CLASS(PoolPolicies);
 
 
+size_t ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder)(
+          struct ST_CLASS(PoolNode)*         poolNode,
+          struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+          const size_t                       maxPoolElementNodes,
+          size_t                             maxIncrement);
+size_t ST_CLASS(poolPolicySelectPoolElementNodesByValueTree)(
+          struct ST_CLASS(PoolNode)*         poolNode,
+          struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+          const size_t                       maxPoolElementNodes,
+          size_t                             maxIncrement);
+size_t ST_CLASS(poolPolicySelectPoolElementNodesByWeightTree)(
+          struct ST_CLASS(PoolNode)*         poolNode,
+          struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+          const size_t                       maxPoolElementNodes,
+          size_t                             maxIncrement);
+size_t ST_CLASS(poolPolicySelectPoolElementNodesByCursor)(
+          struct ST_CLASS(PoolNode)*         poolNode,
+          struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+          const size_t                       maxPoolElementNodes,
+          size_t                             maxIncrement);
+size_t ST_CLASS(poolPolicySelectPoolElementNodesByPowerOfChoices)(
+          struct ST_CLASS(PoolNode)*         poolNode,
+          struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+          const size_t                       maxPoolElementNodes,
+          size_t                             maxIncrement);
+
 const struct ST_CLASS(PoolPolicy)* ST_CLASS(poolPolicyGetPoolPolicyByName)(const char* policyName);
 const struct ST_CLASS(PoolPolicy)* ST_CLASS(poolPolicyGetPoolPolicyByType)(const unsigned int policyType);
 
@@ -143,7 +143,7 @@ size_t ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder)(
          poolNode->Policy->UpdatePoolElementNodeFunction(poolElementNodeArray[i]);
       }
 
-      ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(poolNode, poolElementNodeArray[i]);
+      CHECK(ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(poolNode, poolElementNodeArray[i]));
    }
 
    return(poolElementNodes);
@@ -219,7 +219,213 @@ size_t ST_CLASS(poolPolicySelectPoolElementNodesByValueTree)(
 
    /* Re-linking of all previously unlinked nodes */
    for(i = 0;i < poolElementNodes;i++) {
-      ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(poolNode, poolElementNodeArray[i]);
+      CHECK(ST_CLASS(poolNodeLinkPoolElementNodeToSelection)(poolNode, poolElementNodeArray[i]));
+   }
+
+   return(poolElementNodes);
+}
+
+
+/* ###### Select PoolElementNodes from Storage at the cursor ############# */
+size_t ST_CLASS(poolPolicySelectPoolElementNodesByCursor)(
+          struct ST_CLASS(PoolNode)*         poolNode,
+          struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+          const size_t                       maxPoolElementNodes,
+          size_t                             maxIncrement)
+{
+   struct ST_CLASS(PoolElementNode)* poolElementNode;
+   const size_t                      poolElements = ST_METHOD(GetElements)(&poolNode->PoolElementSelectionStorage);
+   size_t                            poolElementNodes;
+   size_t                            i;
+
+   CHECK(poolNode->Policy->Flags & PPF_SELECTION_CURSOR);
+
+   /* Set maxIncrement to default, if maxIncrement == 0. */
+   if(maxIncrement == 0) {
+      maxIncrement = poolNode->Policy->DefaultMaxIncrement;
+   }
+
+   /* Policy-specifc pool element node updates (e.g. counter changes) */
+   if(poolNode->Policy->PrepareSelectionFunction) {
+      poolNode->Policy->PrepareSelectionFunction(poolNode);
+   }
+
+   /*
+      The selection storage is used as a ring, which is traversed from the
+      cursor on. Instead of moving the selected PEs to the end of the
+      storage, the cursor is advanced behind the first maxIncrement ones.
+      Only membership changes modify the storage.
+   */
+   poolElementNodes = (poolElements < maxPoolElementNodes) ? poolElements : maxPoolElementNodes;
+   poolElementNode  = poolNode->SelectionCursor;
+   if(poolElementNode == NULL) {
+      poolElementNode = ST_CLASS(poolNodeGetFirstPoolElementNodeFromSelection)(poolNode);
+   }
+   for(i = 0;i < poolElementNodes;i++) {
+      poolElementNodeArray[i] = poolElementNode;
+      poolElementNode = ST_CLASS(poolNodeGetNextPoolElementNodeFromSelection)(poolNode, poolElementNode);
+      if(poolElementNode == NULL) {
+         poolElementNode = ST_CLASS(poolNodeGetFirstPoolElementNodeFromSelection)(poolNode);
+      }
+      if(i < maxIncrement) {
+         poolElementNodeArray[i]->SelectionCounter++;
+         poolNode->SelectionCursor = poolElementNode;
+      }
+   }
+
+   return(poolElementNodes);
+}
+
+
+/* ###### Select PoolElementNodes by weight from the weight tree ######### */
+size_t ST_CLASS(poolPolicySelectPoolElementNodesByWeightTree)(
+          struct ST_CLASS(PoolNode)*         poolNode,
+          struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+          const size_t                       maxPoolElementNodes,
+          size_t                             maxIncrement)
+{
+   struct ST_CLASS(PoolElementNode)* poolElementNode;
+   unsigned long long                maxValue;
+   unsigned long long                value;
+   const size_t                      poolElements     = poolNode->SelectionArraySize;
+   size_t                            poolElementNodes = 0;
+   size_t                            i;
+
+   CHECK(poolNode->Policy->Flags & PPF_WEIGHT_TREE);
+
+   /* Set maxIncrement to default, if maxIncrement == 0. */
+   if(maxIncrement == 0) {
+      maxIncrement = poolNode->Policy->DefaultMaxIncrement;
+   }
+
+   /* Check, if resequencing is necessary. However, using 64 bit counters,
+      this should (almost) never be necessary */
+   CHECK(maxPoolElementNodes >= 1);
+   if((PoolElementSeqNumberType)(poolNode->GlobalSeqNumber + maxPoolElementNodes) <
+      poolNode->GlobalSeqNumber) {
+      ST_CLASS(poolNodeResequence)(poolNode);
+   }
+
+   /* Policy-specifc pool element node updates (e.g. counter changes) */
+   if(poolNode->Policy->PrepareSelectionFunction) {
+      poolNode->Policy->PrepareSelectionFunction(poolNode);
+   }
+
+
+   for(i = 0;i < ((poolElements < maxPoolElementNodes) ? poolElements : maxPoolElementNodes);i++) {
+      maxValue = ST_CLASS(poolNodeGetSelectionWeightSum)(poolNode);
+      if(maxValue < 1) {
+         break;
+      }
+
+      value = random64() % maxValue;
+      poolElementNode = ST_CLASS(poolNodeGetPoolElementNodeBySelectionWeight)(poolNode, value);
+      if(poolElementNode == NULL) {
+         break;
+      }
+
+      /* Common update functionality: SeqNumber increment and Selection Counter */
+      poolElementNode->SeqNumber = poolNode->GlobalSeqNumber++;
+      poolElementNode->SelectionCounter++;
+
+      /* Update PE entries with respect to maxIncrement setting. */
+      if(poolElementNodes < maxIncrement) {
+         /* Policy-specifc pool element node updates (e.g. counter changes) */
+         if(poolNode->Policy->UpdatePoolElementNodeFunction) {
+            poolNode->Policy->UpdatePoolElementNodeFunction(poolElementNode);
+         }
+      }
+
+      /* Setting the weight to 0 prevents multiple selections of the same
+         PE. In contrast to unlinking, this does not touch the selection
+         storage. */
+      ST_CLASS(poolNodeSetPoolElementNodeSelectionWeight)(poolNode, poolElementNode, 0);
+      poolElementNodeArray[poolElementNodes++] = poolElementNode;
+   }
+
+   /* Restore the weights of all selected nodes */
+   for(i = 0;i < poolElementNodes;i++) {
+      ST_CLASS(poolNodeSetPoolElementNodeSelectionWeight)(
+         poolNode, poolElementNodeArray[i],
+         (unsigned int)poolElementNodeArray[i]->PoolElementSelectionStorageNode.Value);
+   }
+
+   return(poolElementNodes);
+}
+
+
+/* ###### Swap two entries of the selection array ######################## */
+static void ST_CLASS(poolPolicySwapSelectionArrayEntries)(
+               struct ST_CLASS(PoolNode)* poolNode,
+               const size_t               i,
+               const size_t               j)
+{
+   struct ST_CLASS(PoolElementNode)* poolElementNode = poolNode->SelectionArray[i];
+
+   poolNode->SelectionArray[i]                      = poolNode->SelectionArray[j];
+   poolNode->SelectionArray[i]->SelectionArrayIndex = i;
+   poolNode->SelectionArray[j]                      = poolElementNode;
+   poolElementNode->SelectionArrayIndex             = j;
+}
+
+
+/* ###### Select PoolElementNodes by sampling the selection array ######## */
+size_t ST_CLASS(poolPolicySelectPoolElementNodesByPowerOfChoices)(
+          struct ST_CLASS(PoolNode)*         poolNode,
+          struct ST_CLASS(PoolElementNode)** poolElementNodeArray,
+          const size_t                       maxPoolElementNodes,
+          size_t                             maxIncrement)
+{
+   struct ST_CLASS(PoolElementNode)* candidate;
+   struct ST_CLASS(PoolElementNode)* best;
+   const size_t                      poolElements = poolNode->SelectionArraySize;
+   size_t                            poolElementNodes;
+   size_t                            bestIndex;
+   size_t                            index;
+   size_t                            i, j;
+
+   CHECK(poolNode->Policy->Flags & PPF_SELECTION_ARRAY);
+
+   /* Check, if resequencing is necessary. However, using 64 bit counters,
+      this should (almost) never be necessary */
+   CHECK(maxPoolElementNodes >= 1);
+   if((PoolElementSeqNumberType)(poolNode->GlobalSeqNumber + maxPoolElementNodes) <
+      poolNode->GlobalSeqNumber) {
+      ST_CLASS(poolNodeResequence)(poolNode);
+   }
+
+   /* Policy-specifc pool element node updates (e.g. counter changes) */
+   if(poolNode->Policy->PrepareSelectionFunction) {
+      poolNode->Policy->PrepareSelectionFunction(poolNode);
+   }
+
+   /*
+      The i-th PE is the best of POWER_OF_CHOICES_SAMPLES random PEs from
+      the not yet selected part [i, poolElements) of the array. The chosen
+      PE is then swapped to position i, i.e. PEs are selected only once.
+   */
+   poolElementNodes = (poolElements < maxPoolElementNodes) ? poolElements : maxPoolElementNodes;
+   for(i = 0;i < poolElementNodes;i++) {
+      bestIndex = i + (random32() % (poolElements - i));
+      best      = poolNode->SelectionArray[bestIndex];
+      for(j = 1;j < POWER_OF_CHOICES_SAMPLES;j++) {
+         index     = i + (random32() % (poolElements - i));
+         candidate = poolNode->SelectionArray[index];
+         if( (candidate->PolicySettings.Load < best->PolicySettings.Load) ||
+             ( (candidate->PolicySettings.Load == best->PolicySettings.Load) &&
+               (candidate->SeqNumber < best->SeqNumber) ) ) {
+            best      = candidate;
+            bestIndex = index;
+         }
+      }
+      if(bestIndex != i) {
+         ST_CLASS(poolPolicySwapSelectionArrayEntries)(poolNode, i, bestIndex);
+      }
+
+      /* Common update functionality: SeqNumber increment and Selection Counter */
+      poolElementNodeArray[i] = best;
+      best->SeqNumber = poolNode->GlobalSeqNumber++;
+      best->SelectionCounter++;
    }
 
    return(poolElementNodes);
@@ -248,45 +454,30 @@ static int ST_CLASS(roundRobinComparison)(
    #######################################################################
 */
 
+/*
+   Weighted Round Robin is realized by stride scheduling: each selection
+   advances the PE's pass by its stride STRIDE1 / weight, and the PE with
+   the lowest pass is selected next. This interleaves the selections of
+   the PEs smoothly. Passes are compared by their signed difference, since
+   all passes of a pool are within one maximum stride of each other. So,
+   they may wrap without any round counter resets.
+*/
+
 /* ###### Sorting Order ################################################## */
 static int ST_CLASS(weightedRoundRobinComparison)(
    const struct ST_CLASS(PoolElementNode)* poolElementNode1,
    const struct ST_CLASS(PoolElementNode)* poolElementNode2)
 {
-   COMPARE_KEY_ASCENDING(poolElementNode1->RoundCounter, poolElementNode2->RoundCounter);
-   COMPARE_KEY_ASCENDING(poolElementNode1->VirtualCounter, poolElementNode2->VirtualCounter);
-   COMPARE_KEY_ASCENDING(poolElementNode1->SeqNumber, poolElementNode2->SeqNumber);
-   return(0);
-}
-
-
-/* ###### Get current round counter ###################################### */
-static PoolElementSeqNumberType ST_CLASS(weightedRoundRobinGetCurrentRoundCounter)(
-                                   struct ST_CLASS(PoolNode)* poolNode)
-{
-   struct ST_CLASS(PoolElementNode)* poolElementNode =
-      ST_CLASS(poolNodeGetFirstPoolElementNodeFromSelection)(poolNode);
-   if(poolElementNode) {
-      return(poolElementNode->RoundCounter);
+   const long long passDifference =
+      (long long)(poolElementNode1->StridePass - poolElementNode2->StridePass);
+   if(passDifference < 0) {
+      return(-1);
    }
-   return(SeqNumberStart);
-}
-
-
-/* ###### Reset round counters to lowest possible values ################# */
-static void ST_CLASS(weightedRoundRobinResetRoundCounters)(
-               struct ST_CLASS(PoolNode)* poolNode)
-{
-   struct ST_CLASS(PoolElementNode)* poolElementNode =
-      ST_CLASS(poolNodeGetFirstPoolElementNodeFromSelection)(poolNode);
-
-   if(poolElementNode) {
-      const PoolElementSeqNumberType lowestRoundCounter = poolElementNode->RoundCounter;
-      do {
-         poolElementNode->RoundCounter -= lowestRoundCounter;
-         poolElementNode = ST_CLASS(poolNodeGetNextPoolElementNodeFromSelection)(poolNode, poolElementNode);
-      } while(poolElementNode != NULL);
+   else if(passDifference > 0) {
+      return(1);
    }
+   COMPARE_KEY_ASCENDING(poolElementNode1->SeqNumber, poolElementNode2->SeqNumber);
+   return(0);
 }
 
 
@@ -294,9 +485,11 @@ static void ST_CLASS(weightedRoundRobinResetRoundCounters)(
 void ST_CLASS(weightedRoundRobinInitializePoolElementNode)(
         struct ST_CLASS(PoolElementNode)* poolElementNode)
 {
-   poolElementNode->RoundCounter   = ST_CLASS(weightedRoundRobinGetCurrentRoundCounter)(
-                                        poolElementNode->OwnerPoolNode);
-   poolElementNode->VirtualCounter = poolElementNode->PolicySettings.Weight;
+   /* A new PE starts at the pool's current pass */
+   struct ST_CLASS(PoolElementNode)* firstPoolElementNode =
+      ST_CLASS(poolNodeGetFirstPoolElementNodeFromSelection)(poolElementNode->OwnerPoolNode);
+   poolElementNode->StridePass = (firstPoolElementNode != NULL) ?
+                                    firstPoolElementNode->StridePass : 0;
 }
 
 
@@ -304,26 +497,9 @@ void ST_CLASS(weightedRoundRobinInitializePoolElementNode)(
 void ST_CLASS(weightedRoundRobinUpdatePoolElementNode)(
         struct ST_CLASS(PoolElementNode)* poolElementNode)
 {
-   if(poolElementNode->VirtualCounter > 1) {
-      poolElementNode->VirtualCounter--;
-   }
-   else {
-      poolElementNode->RoundCounter++;
-      poolElementNode->VirtualCounter = poolElementNode->PolicySettings.Weight;
-   }
-}
-
-
-/* ###### Prepare selection on pool ###################################### */
-void ST_CLASS(weightedRoundRobinPrepareSelection)(
-        struct ST_CLASS(PoolNode)* poolNode)
-{
-   const PoolElementSeqNumberType currentRoundCounter =
-      ST_CLASS(weightedRoundRobinGetCurrentRoundCounter)(poolNode);
-
-   if((PoolElementSeqNumberType)(currentRoundCounter + 2) < currentRoundCounter) {
-      ST_CLASS(weightedRoundRobinResetRoundCounters)(poolNode);
-   }
+   const unsigned int weight = (poolElementNode->PolicySettings.Weight > 0) ?
+                                  poolElementNode->PolicySettings.Weight : 1;
+   poolElementNode->StridePass += WEIGHTED_ROUNDROBIN_STRIDE1 / weight;
 }
 
 
@@ -834,29 +1010,50 @@ static void ST_CLASS(randomizedPriorityLeastUsedDegradationUpdatePoolElementNode
 }
 
 
+/*
+   #######################################################################
+   #### Power of Two Choices Policy                                   ####
+   #######################################################################
+*/
+
+/* ###### Sorting Order ################################################## */
+static int ST_CLASS(powerOfTwoChoicesComparison)(
+   const struct ST_CLASS(PoolElementNode)* poolElementNode1,
+   const struct ST_CLASS(PoolElementNode)* poolElementNode2)
+{
+   /* The selection storage order does not depend on the load. Therefore,
+      load updates do not have to re-insert the PE. */
+   COMPARE_KEY_ASCENDING(poolElementNode1->Identifier, poolElementNode2->Identifier);
+   return(0);
+}
+
+
 const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
 {
    {
       PPT_ROUNDROBIN, "RoundRobin",
+      PPF_STATIC_ORDER|PPF_SELECTION_CURSOR,
       1,
       &ST_CLASS(roundRobinComparison),
-      &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
+      &ST_CLASS(poolPolicySelectPoolElementNodesByCursor),
       NULL,
       NULL,
       NULL
    },
    {
       PPT_WEIGHTED_ROUNDROBIN, "WeightedRoundRobin",
+      0,
       1,
       &ST_CLASS(weightedRoundRobinComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
       &ST_CLASS(weightedRoundRobinInitializePoolElementNode),
       &ST_CLASS(weightedRoundRobinUpdatePoolElementNode),
-      &ST_CLASS(weightedRoundRobinPrepareSelection)
+      NULL
    },
    {
       PPT_RANDOM, "Random",
       0,
+      0,
       &ST_CLASS(randomComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesByValueTree),
       NULL,
@@ -865,24 +1062,27 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_WEIGHTED_RANDOM, "WeightedRandom",
+      PPF_SELECTION_ARRAY|PPF_WEIGHT_TREE,
       0,
       &ST_CLASS(weightedRandomComparison),
-      &ST_CLASS(poolPolicySelectPoolElementNodesByValueTree),
+      &ST_CLASS(poolPolicySelectPoolElementNodesByWeightTree),
       NULL,
       &ST_CLASS(weightedRandomUpdatePoolElementNode),
       NULL
    },
    {
       PPT_WEIGHTED_RANDOM_DPF, "WeightedRandomDPF",
+      PPF_SELECTION_ARRAY|PPF_WEIGHT_TREE,
       0,
       &ST_CLASS(weightedRandomDPFComparison),
-      &ST_CLASS(poolPolicySelectPoolElementNodesByValueTree),
+      &ST_CLASS(poolPolicySelectPoolElementNodesByWeightTree),
       NULL,
       &ST_CLASS(weightedRandomDPFUpdatePoolElementNode),
       NULL
    },
    {
       PPT_PRIORITY, "Priority",
+      0,
       1,
       &ST_CLASS(priorityComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
@@ -893,6 +1093,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
 
    {
       PPT_LEASTUSED, "LeastUsed",
+      0,
       1,
       &ST_CLASS(leastUsedComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
@@ -902,6 +1103,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_LEASTUSED_DPF, "LeastUsedDPF",
+      0,
       1,
       &ST_CLASS(leastUsedDPFComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
@@ -911,6 +1113,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_PRIORITY_LEASTUSED_DPF, "PriorityLeastUsedDPF",
+      0,
       1,
       &ST_CLASS(priorityLeastUsedDPFComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
@@ -920,6 +1123,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_PRIORITY_LEASTUSED_DEGRADATION_DPF, "PriorityLeastUsedDegradationDPF",
+      0,
       1,
       &ST_CLASS(priorityLeastUsedDegradationDPFComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
@@ -929,6 +1133,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_LEASTUSED_DEGRADATION, "LeastUsedDegradation",
+      0,
       1,
       &ST_CLASS(leastUsedDegradationComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
@@ -938,6 +1143,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_LEASTUSED_DEGRADATION_DPF, "LeastUsedDegradationDPF",
+      0,
       1,
       &ST_CLASS(leastUsedDegradationDPFComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
@@ -947,6 +1153,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_PRIORITY_LEASTUSED, "PriorityLeastUsed",
+      0,
       1,
       &ST_CLASS(priorityLeastUsedComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
@@ -956,6 +1163,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_PRIORITY_LEASTUSED_DEGRADATION, "PriorityLeastUsedDegradation",
+      0,
       1,
       &ST_CLASS(priorityLeastUsedDegradationComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
@@ -966,6 +1174,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
 
    {
       PPT_RANDOMIZED_LEASTUSED, "RandomizedLeastUsed",
+      0,
       1,
       &ST_CLASS(randomizedLeastUsedComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesByValueTree),
@@ -975,6 +1184,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_RANDOMIZED_LEASTUSED_DEGRADATION, "RandomizedLeastUsedDegradation",
+      0,
       1,
       &ST_CLASS(randomizedLeastUsedDegradationComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesByValueTree),
@@ -984,6 +1194,7 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_RANDOMIZED_PRIORITY_LEASTUSED, "RandomizedPriorityLeastUsed",
+      0,
       1,
       &ST_CLASS(randomizedPriorityLeastUsedComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesByValueTree),
@@ -993,12 +1204,24 @@ const struct ST_CLASS(PoolPolicy) ST_CLASS(PoolPolicyArray)[] =
    },
    {
       PPT_RANDOMIZED_PRIORITY_LEASTUSED_DEGRADATION, "RandomizedPriorityLeastUsedDegradation",
+      0,
       1,
       &ST_CLASS(randomizedPriorityLeastUsedDegradationComparison),
       &ST_CLASS(poolPolicySelectPoolElementNodesByValueTree),
       NULL,
       &ST_CLASS(randomizedPriorityLeastUsedDegradationUpdatePoolElementNode),
       NULL
+   },
+
+   {
+      PPT_POWER_OF_TWO_CHOICES, "PowerOfTwoChoices",
+      PPF_SELECTION_ARRAY|PPF_STATIC_ORDER,
+      1,
+      &ST_CLASS(powerOfTwoChoicesComparison),
+      &ST_CLASS(poolPolicySelectPoolElementNodesByPowerOfChoices),
+      NULL,
+      NULL,
+      NULL
    }
 };
 
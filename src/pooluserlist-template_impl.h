@@ -146,6 +146,9 @@ struct ST_CLASS(PoolUserNode)* ST_CLASS(poolUserListAddPoolUserNode)(
 
    result = ST_METHOD(Insert)(&poolUserList->PoolUserListStorage,
                               &poolUserNode->PoolUserListStorageNode);
+   if(result == NULL) {
+      return(NULL);   /* Out of memory */
+   }
    if(result == &poolUserNode->PoolUserListStorageNode) {
       return(poolUserNode);
    }
@@ -31,6 +31,7 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 #if defined(SIM_IMPORT) || defined(OMNETPPLIBS_IMPORT)
@@ -41,7 +42,13 @@
 using namespace omnetpp;
 
 #else
+#include <pthread.h>
+#ifdef HAVE_GETRANDOM
+#include <sys/random.h>
+#endif
+
 /*
+   Secure random numbers (for identifiers):
    It is tried to use /dev/urandom as random source first, since
    it provides high-quality random numbers. If /dev/urandom is not
    available, use the clib's random() function with a seed given
@@ -59,8 +66,97 @@ using namespace omnetpp;
 
 static int   RandomSource = RS_TRY_DEVICE;
 static FILE* RandomDevice = NULL;
+
+
+/*
+   Fast random numbers (for pool policies, timer jitter, etc.):
+   Each thread uses its own xoshiro256** generator, seeded by getrandom()
+   (or the secure random source above, if getrandom() is not available).
+   No locking and no system call is necessary after seeding. A forked child
+   process reseeds, in order to not repeat its parent's sequence.
+*/
+struct FastRandomState
+{
+   uint64_t State[4];
+   int      Seeded;
+};
+
+static __thread struct FastRandomState FastRandom;
+static pthread_once_t                  FastRandomOnce = PTHREAD_ONCE_INIT;
+#endif
+
+
+
+#if !defined(SIM_IMPORT) && !defined(OMNETPPLIBS_IMPORT)
+/* ###### Reseed fast generator in forked child process ################## */
+static void fastRandomAtFork(void)
+{
+   FastRandom.Seeded = 0;
+}
+
+
+/* ###### Register fork handler ########################################## */
+static void fastRandomRegisterAtFork(void)
+{
+   pthread_atfork(NULL, NULL, fastRandomAtFork);
+}
+
+
+/* ###### Seed calling thread's fast generator ########################### */
+static void fastRandomSeed(void)
+{
+   int    seeded = 0;
+   size_t i;
+
+   pthread_once(&FastRandomOnce, fastRandomRegisterAtFork);
+
+#ifdef HAVE_GETRANDOM
+   seeded = (getrandom(&FastRandom.State, sizeof(FastRandom.State), 0) ==
+                (ssize_t)sizeof(FastRandom.State));
 #endif
+   if(!seeded) {
+      for(i = 0;i < 4;i++) {
+         FastRandom.State[i] = secureRandom64();
+      }
+   }
+   /* The all-zero state is the only invalid one */
+   if((FastRandom.State[0] | FastRandom.State[1] |
+       FastRandom.State[2] | FastRandom.State[3]) == 0) {
+      FastRandom.State[0] = 1;
+   }
+   FastRandom.Seeded = 1;
+}
+
+
+/* ###### Rotate left #################################################### */
+static inline uint64_t rotl(const uint64_t x, const int k)
+{
+   return((x << k) | (x >> (64 - k)));
+}
+
+
+/* ###### Get next value of calling thread's xoshiro256** generator ###### */
+static inline uint64_t fastRandomNext(void)
+{
+   uint64_t* s = FastRandom.State;
+   uint64_t  result;
+   uint64_t  t;
+
+   if(!FastRandom.Seeded) {
+      fastRandomSeed();
+   }
 
+   result = rotl(s[1] * 5, 7) * 9;
+   t      = s[1] << 17;
+   s[2] ^= s[0];
+   s[3] ^= s[1];
+   s[1] ^= s[2];
+   s[0] ^= s[3];
+   s[2] ^= t;
+   s[3] = rotl(s[3], 45);
+   return(result);
+}
+#endif
 
 
 /* ###### Get 8-bit random value ######################################### */
@@ -77,20 +173,56 @@ uint16_t random16()
 }
 
 
+/* ###### Get 32-bit random value ######################################## */
+uint32_t random32()
+{
+#if defined(SIM_IMPORT) || defined(OMNETPPLIBS_IMPORT)
+#warning Using OMNeT++ random generator instead of time-seeded one!
+   const double value = uniform(getSimulation()->getContextModule()->getRNG(0), 0.0, (double)0xffffffff);
+   return((uint32_t)rint(value));
+#else
+   /* The upper bits of xoshiro256** have the best quality */
+   return((uint32_t)(fastRandomNext() >> 32));
+#endif
+}
+
+
 /* ###### Get 64-bit random value ######################################## */
 uint64_t random64()
 {
+#if defined(SIM_IMPORT) || defined(OMNETPPLIBS_IMPORT)
    return( (((uint64_t)random32()) << 32) | (uint64_t)random32() );
+#else
+   return(fastRandomNext());
+#endif
 }
 
 
-/* ###### Get 32-bit random value ######################################## */
-uint32_t random32()
+/* ###### Fill buffer with random bytes ################################## */
+void randomFill(void* buffer, const size_t length)
+{
+   unsigned char* ptr = (unsigned char*)buffer;
+   size_t         remaining = length;
+   uint64_t       value;
+
+   while(remaining >= sizeof(value)) {
+      value = random64();
+      memcpy(ptr, &value, sizeof(value));
+      ptr       += sizeof(value);
+      remaining -= sizeof(value);
+   }
+   if(remaining > 0) {
+      value = random64();
+      memcpy(ptr, &value, remaining);
+   }
+}
+
+
+/* ###### Get secure 32-bit random value ################################# */
+uint32_t secureRandom32()
 {
 #if defined(SIM_IMPORT) || defined(OMNETPPLIBS_IMPORT)
-#warning Using OMNeT++ random generator instead of time-seeded one!
-   const double value = uniform(getSimulation()->getContextModule()->getRNG(0), 0.0, (double)0xffffffff);
-   return((uint32_t)rint(value));
+   return(random32());
 #else
    uint32_t number;
 
@@ -123,6 +255,13 @@ uint32_t random32()
 }
 
 
+/* ###### Get secure 64-bit random value ################################# */
+uint64_t secureRandom64()
+{
+   return( (((uint64_t)secureRandom32()) << 32) | (uint64_t)secureRandom32() );
+}
+
+
 /* ###### Get double random value ######################################## */
 double randomDouble()
 {
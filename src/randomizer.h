@@ -45,7 +45,7 @@ extern "C" {
 uint8_t random8();
 
 /**
-  * Get162-bit random value.
+  * Get 16-bit random value.
   *
   * @return Random value.
   */
@@ -65,6 +65,32 @@ uint32_t random32();
   */
 uint64_t random64();
 
+/**
+  * Fill buffer with random bytes.
+  *
+  * @param buffer Buffer.
+  * @param length Length of the buffer in bytes.
+  */
+void randomFill(void* buffer, const size_t length);
+
+/**
+  * Get 32-bit random value from a secure random source (i.e. /dev/urandom,
+  * if available). This function is slow and should only be used for
+  * identifiers. Use random32() for everything else.
+  *
+  * @return Random value.
+  */
+uint32_t secureRandom32();
+
+/**
+  * Get 64-bit random value from a secure random source (i.e. /dev/urandom,
+  * if available). This function is slow and should only be used for
+  * identifiers. Use random64() for everything else.
+  *
+  * @return Random value.
+  */
+uint64_t secureRandom64();
+
 /**
   * Get double random value out of interval [0,1).
   *
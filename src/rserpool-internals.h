@@ -53,6 +53,9 @@ struct TagItem;
 #define TAG_RspLib_RegistrarRequestMaxTrials         (TAG_USER + 4005)
 #define TAG_RspLib_RegistrarRequestTimeout           (TAG_USER + 4006)
 #define TAG_RspLib_RegistrarResponseTimeout          (TAG_USER + 4007)
+#define TAG_RspLib_RegistrarMaxOutstandingRequests   (TAG_USER + 4008)
+#define TAG_RspLib_CacheRefreshThreshold             (TAG_USER + 4009)
+#define TAG_RspLib_CacheRefreshRate                  (TAG_USER + 4010)
 
 
 unsigned int rsp_pe_registration_tags(const unsigned char*       poolHandle,
@@ -67,6 +70,11 @@ unsigned int rsp_pe_deregistration_tags(const unsigned char* poolHandle,
                                         const uint32_t       identifier,
                                         const int            flags,
                                         struct TagItem*      tags);
+unsigned int rsp_pe_update_load_tags(const unsigned char*       poolHandle,
+                                     const size_t               poolHandleSize,
+                                     const uint32_t             identifier,
+                                     const struct rsp_loadinfo* rspLoadInfo,
+                                     struct TagItem*            tags);
 unsigned int rsp_pe_failure_tags(const unsigned char* poolHandle,
                                  const size_t         poolHandleSize,
                                  const uint32_t       identifier,
@@ -56,6 +56,8 @@
 #define PPT_PRIORITY_LEASTUSED_DPF                    0xb0002004
 #define PPT_PRIORITY_LEASTUSED_DEGRADATION_DPF        0xb0002005
 
+#define PPT_POWER_OF_TWO_CHOICES                      0xb0003001
+
 
 /*
  * NOTE:
@@ -75,7 +77,8 @@
      ((p) == PPT_RANDOMIZED_LEASTUSED) || \
      ((p) == PPT_RANDOMIZED_LEASTUSED_DEGRADATION) || \
      ((p) == PPT_RANDOMIZED_PRIORITY_LEASTUSED) || \
-     ((p) == PPT_RANDOMIZED_PRIORITY_LEASTUSED_DEGRADATION) )
+     ((p) == PPT_RANDOMIZED_PRIORITY_LEASTUSED_DEGRADATION) || \
+     ((p) == PPT_POWER_OF_TWO_CHOICES) )
 
 
 #define PPV_MIN_WEIGHT                    0
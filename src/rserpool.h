@@ -109,6 +109,7 @@ struct rsp_loadinfo
 #define REGF_DONTWAIT         (1 << 0)   /* Do not wait for Registration Response   */
 #define REGF_CONTROLCHANNEL   (1 << 1)   /* Pool Element has Control Channel        */
 #define REGF_DAEMONMODE       (1 << 2)   /* Daemon mode: don not stop on errors     */
+#define REGF_LOADUPDATE       (1 << 3)   /* Update load by Load Update (custom)     */
 
 #define DEREGF_DONTWAIT       (1 << 0)   /* Do not wait for Deregistration Response */
 
@@ -184,6 +185,10 @@ unsigned int rsp_pe_deregistration(const unsigned char* poolHandle,
                                    const size_t         poolHandleSize,
                                    const uint32_t       identifier,
                                    const int            flags);
+unsigned int rsp_pe_update_load(const unsigned char*       poolHandle,
+                                const size_t               poolHandleSize,
+                                const uint32_t             identifier,
+                                const struct rsp_loadinfo* rspLoadInfo);
 unsigned int rsp_pe_failure(const unsigned char* poolHandle,
                             const size_t         poolHandleSize,
                             const uint32_t       identifier);
@@ -211,6 +216,41 @@ int rsp_getaddrinfo(const unsigned char*  poolHandle,
                     const size_t          items,
                     const unsigned int    staleCacheValue);
 
+/**
+  * Completion callback of rsp_getaddrinfo_async().
+  *
+  * @param result Number of PE entries obtained in case of success; error code (negative) in case of an error.
+  * @param rserpoolAddrInfo First rsp_addrinfo; to be freed by rsp_freeaddrinfo().
+  * @param userData User data given to rsp_getaddrinfo_async().
+  */
+typedef void (*rsp_getaddrinfo_callback_t)(int                  result,
+                                           struct rsp_addrinfo* rserpoolAddrInfo,
+                                           void*                userData);
+
+/**
+  * Perform asynchronous handle resolution. If the handle can be resolved
+  * from the cache, the callback is invoked before this function returns.
+  * Otherwise, the request is sent to the registrar and the callback is
+  * invoked from the rsplib main loop thread. The callback must not block
+  * and must not call blocking rsplib functions like rsp_getaddrinfo().
+  *
+  * @param poolHandle Pool handle.
+  * @param poolHandleSize Pool handle size.
+  * @param items Desired number of PE entries to obtain.
+  * @param staleCacheValue Stale cache value in milliseconds.
+  * @param callback Completion callback.
+  * @param userData User data for completion callback.
+  * @return 0 in case of success (callback will be invoked exactly once); error code (negative) in case of an error.
+  *
+  * @see rsp_getaddrinfo
+  */
+int rsp_getaddrinfo_async(const unsigned char*       poolHandle,
+                          const size_t               poolHandleSize,
+                          const size_t               items,
+                          const unsigned int         staleCacheValue,
+                          rsp_getaddrinfo_callback_t callback,
+                          void*                      userData);
+
 /* Error values for rsp_getaddrinfo() function. */
 #define REAI_NONAME -1   /* Pool Handle is unknown.           */
 #define REAI_MEMORY -2   /* Memory allocation failure.        */
@@ -432,6 +472,51 @@ int rsp_select(int             n,
                fd_set*         exceptfds,
                struct timeval* timeout);
 
+struct epoll_event;
+
+/**
+  * Create epoll instance for RSerPool sockets. Unlike rsp_poll(), the
+  * registrations are persistent and rsp_epoll_wait() only returns the
+  * ready RSerPool sockets. Only level-triggered mode is supported.
+  *
+  * @param flags Flags for epoll_create1(), e.g. EPOLL_CLOEXEC.
+  * @return epoll descriptor in case of success; -1 in case of an error.
+  */
+int rsp_epoll_create(int flags);
+
+/**
+  * Close epoll instance created by rsp_epoll_create().
+  *
+  * @param epfd epoll descriptor.
+  * @return 0 in case of success; -1 in case of an error.
+  */
+int rsp_epoll_close(int epfd);
+
+/**
+  * Add, modify or remove RSerPool socket in epoll instance.
+  *
+  * @param epfd epoll descriptor.
+  * @param op EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL.
+  * @param sd RSerPool socket descriptor.
+  * @param event Events and user data (ignored for EPOLL_CTL_DEL).
+  * @return 0 in case of success; -1 in case of an error.
+  */
+int rsp_epoll_ctl(int epfd, int op, int sd, struct epoll_event* event);
+
+/**
+  * Wait for events on RSerPool sockets of epoll instance.
+  *
+  * @param epfd epoll descriptor.
+  * @param events Array to store events into; data is the user data given to rsp_epoll_ctl().
+  * @param maxevents Size of events array.
+  * @param timeout Timeout in milliseconds; -1 for infinite.
+  * @return Number of events; -1 in case of an error.
+  */
+int rsp_epoll_wait(int                 epfd,
+                   struct epoll_event* events,
+                   int                 maxevents,
+                   int                 timeout);
+
 /**
   * Get RSerPool socket option.
   *
@@ -470,7 +555,7 @@ int rsp_setsockopt(int sd, int level, int optname, const void* optval, socklen_t
   * @param poolHandleSize Size of the pool handle in bytes.
   * @param loadinfo rsp_loadinfo structure describing the pool policy (NULL for default, i.e. Round Robin).
   * @param reregistrationInterval Reregistration interval in milliseconds.
-  * @param flags Flags (Set REGF_DONTWAIT in order to avoid blocking until reception of Registration Response).
+  * @param flags Flags (Set REGF_DONTWAIT in order to avoid blocking until reception of Registration Response; set REGF_LOADUPDATE in order to send a Load Update instead of a reregistration, when only the load of a registered PE has changed).
   * @return 0 in case of success; -1 in case of an error.
   */
 int rsp_register(int                        sd,
@@ -34,32 +34,266 @@
 #include "rserpoolmessageparser.h"
 
 #include <ext_socket.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdatomic.h>
 
 
-/* ###### Constructor #################################################### */
-struct RSerPoolMessage* rserpoolMessageNew(char* buffer, const size_t bufferSize)
+#define RSERPOOL_MESSAGE_POOL_EXTERNAL 0   /* Message with external buffer */
+#define RSERPOOL_MESSAGE_POOL_SMALL    1
+#define RSERPOOL_MESSAGE_POOL_LARGE    2
+#define RSERPOOL_MESSAGE_POOL_CLASSES  3
+#define RSERPOOL_MESSAGE_POOL_NONE     RSERPOOL_MESSAGE_POOL_CLASSES
+
+/* RemoteFreeList value after the owning thread has terminated */
+#define RSERPOOL_MESSAGE_POOL_CLOSED   ((struct RSerPoolMessage*)(uintptr_t)1)
+
+
+/*
+   Each message remembers the pool of the thread that has allocated it
+   (e.g. a response allocated by the ASAP main loop thread but deleted by
+   the pool user's thread). Only the owning thread accesses FreeList,
+   FreeCount and Statistics. Other threads push deleted messages onto the
+   lock-free RemoteFreeList, which the owner takes back as a whole upon
+   its next allocation.
+
+   References counts the owning thread plus all messages of the pool that
+   have not been freed, i.e. also the pooled ones. Therefore, the pool
+   survives its thread until the last outstanding message is deleted.
+*/
+struct RSerPoolMessagePool
+{
+   struct RSerPoolMessage*              FreeList[RSERPOOL_MESSAGE_POOL_CLASSES];
+   size_t                               FreeCount[RSERPOOL_MESSAGE_POOL_CLASSES];
+   struct RSerPoolMessagePoolStatistics Statistics;
+
+   _Atomic(struct RSerPoolMessage*)     RemoteFreeList;
+   atomic_size_t                        References;
+};
+
+static pthread_key_t  gMessagePoolKey;
+static pthread_once_t gMessagePoolKeyOnce = PTHREAD_ONCE_INIT;
+
+static const size_t gMessagePoolBufferSize[RSERPOOL_MESSAGE_POOL_CLASSES] = {
+   0,
+   RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE,
+   RSERPOOL_LARGE_MESSAGE_BUFFER_SIZE
+};
+
+
+/* ###### Drop references to message pool ############################### */
+static void messagePoolRelease(struct RSerPoolMessagePool* messagePool,
+                               const size_t                references)
+{
+   if(atomic_fetch_sub_explicit(&messagePool->References, references,
+                                memory_order_acq_rel) == references) {
+      /* The owning thread has terminated and all messages are freed */
+      CHECK(atomic_load_explicit(&messagePool->RemoteFreeList, memory_order_relaxed) ==
+               RSERPOOL_MESSAGE_POOL_CLOSED);
+      free(messagePool);
+   }
+}
+
+
+/* ###### Take back messages deleted by other threads #################### */
+static void messagePoolTakeRemoteMessages(struct RSerPoolMessagePool* messagePool)
 {
    struct RSerPoolMessage* message;
+   struct RSerPoolMessage* nextMessage;
+   unsigned int            sizeClass;
+   size_t                  freed = 0;
 
-   if(buffer == NULL) {
-      message = (struct RSerPoolMessage*)malloc(sizeof(struct RSerPoolMessage) + bufferSize);
-      if(message != NULL) {
-         memset(message, 0, sizeof(struct RSerPoolMessage));
-         message->Buffer             = (char*)((long)message + (long)sizeof(struct RSerPoolMessage));
-         message->BufferSize         = bufferSize;
-         message->OriginalBufferSize = bufferSize;
+   message = atomic_exchange_explicit(&messagePool->RemoteFreeList, NULL,
+                                      memory_order_acquire);
+   while(message != NULL) {
+      nextMessage = message->NextFreeMessage;
+      sizeClass   = message->PoolSizeClass;
+      messagePool->Statistics.RemoteReturns++;
+      if(messagePool->FreeCount[sizeClass] < RSERPOOL_MESSAGE_POOL_SIZE) {
+         message->NextFreeMessage         = messagePool->FreeList[sizeClass];
+         messagePool->FreeList[sizeClass] = message;
+         messagePool->FreeCount[sizeClass]++;
+      }
+      else {
+         free(message);
+         freed++;
+      }
+      message = nextMessage;
+   }
+   if(freed > 0) {
+      /* The owning thread's reference is still held */
+      atomic_fetch_sub_explicit(&messagePool->References, freed,
+                                memory_order_relaxed);
+   }
+}
+
+
+/* ###### Return message to the pool of another thread ################### */
+static void messagePoolReturnRemoteMessage(struct RSerPoolMessagePool* messagePool,
+                                           struct RSerPoolMessage*     message)
+{
+   struct RSerPoolMessage* head;
+
+   head = atomic_load_explicit(&messagePool->RemoteFreeList, memory_order_relaxed);
+   do {
+      if(head == RSERPOOL_MESSAGE_POOL_CLOSED) {
+         /* The owning thread has terminated */
+         free(message);
+         messagePoolRelease(messagePool, 1);
+         return;
+      }
+      message->NextFreeMessage = head;
+   } while(!atomic_compare_exchange_weak_explicit(&messagePool->RemoteFreeList,
+                                                  &head, message,
+                                                  memory_order_release,
+                                                  memory_order_relaxed));
+}
+
+
+/* ###### Free thread's message pool upon thread termination ############# */
+static void messagePoolDestructor(void* data)
+{
+   struct RSerPoolMessagePool* messagePool = (struct RSerPoolMessagePool*)data;
+   struct RSerPoolMessage*     message;
+   struct RSerPoolMessage*     nextMessage;
+   size_t                      freed = 0;
+   unsigned int                i;
+
+   for(i = 0;i < RSERPOOL_MESSAGE_POOL_CLASSES;i++) {
+      while(messagePool->FreeList[i] != NULL) {
+         message = messagePool->FreeList[i];
+         messagePool->FreeList[i] = message->NextFreeMessage;
+         free(message);
+         freed++;
+      }
+   }
+
+   /* Messages deleted by other threads from now on are freed directly */
+   message = atomic_exchange_explicit(&messagePool->RemoteFreeList,
+                                      RSERPOOL_MESSAGE_POOL_CLOSED,
+                                      memory_order_acquire);
+   while(message != NULL) {
+      nextMessage = message->NextFreeMessage;
+      free(message);
+      freed++;
+      message = nextMessage;
+   }
+
+   messagePoolRelease(messagePool, freed + 1);
+}
+
+
+/* ###### Create key for thread-specific message pools ################### */
+static void messagePoolCreateKey(void)
+{
+   if(pthread_key_create(&gMessagePoolKey, messagePoolDestructor) != 0) {
+      LOG_ERROR
+      logerror("pthread_key_create() failed");
+      LOG_END_FATAL
+   }
+}
+
+
+/* ###### Get calling thread's message pool ############################## */
+static struct RSerPoolMessagePool* messagePoolGet(void)
+{
+   struct RSerPoolMessagePool* messagePool;
+
+   pthread_once(&gMessagePoolKeyOnce, messagePoolCreateKey);
+   messagePool = (struct RSerPoolMessagePool*)pthread_getspecific(gMessagePoolKey);
+   if(messagePool == NULL) {
+      messagePool = (struct RSerPoolMessagePool*)calloc(1, sizeof(struct RSerPoolMessagePool));
+      if(messagePool != NULL) {
+         atomic_init(&messagePool->RemoteFreeList, NULL);
+         atomic_init(&messagePool->References, 1);
+         if(pthread_setspecific(gMessagePoolKey, messagePool) != 0) {
+            free(messagePool);
+            messagePool = NULL;
+         }
       }
    }
+   return(messagePool);
+}
+
+
+/* ###### Get statistics of calling thread's message pool ################ */
+void rserpoolMessageGetPoolStatistics(struct RSerPoolMessagePoolStatistics* statistics)
+{
+   struct RSerPoolMessagePool* messagePool = messagePoolGet();
+   if(messagePool != NULL) {
+      *statistics = messagePool->Statistics;
+   }
    else {
-      message = (struct RSerPoolMessage*)malloc(sizeof(struct RSerPoolMessage));
-      if(message != NULL) {
-         memset(message, 0, sizeof(struct RSerPoolMessage));
-         message->Buffer             = buffer;
-         message->BufferSize         = bufferSize;
-         message->OriginalBufferSize = bufferSize;
+      memset(statistics, 0, sizeof(struct RSerPoolMessagePoolStatistics));
+   }
+}
+
+
+/* ###### Constructor #################################################### */
+struct RSerPoolMessage* rserpoolMessageNew(char* buffer, const size_t bufferSize)
+{
+   struct RSerPoolMessagePool* messagePool = messagePoolGet();
+   struct RSerPoolMessage*     message     = NULL;
+   unsigned int                sizeClass;
+
+   /* ====== Find size class ============================================= */
+   if(buffer != NULL) {
+      sizeClass = RSERPOOL_MESSAGE_POOL_EXTERNAL;
+   }
+   else if(bufferSize <= RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE) {
+      sizeClass = RSERPOOL_MESSAGE_POOL_SMALL;
+   }
+   else if(bufferSize <= RSERPOOL_LARGE_MESSAGE_BUFFER_SIZE) {
+      sizeClass = RSERPOOL_MESSAGE_POOL_LARGE;
+   }
+   else {
+      sizeClass = RSERPOOL_MESSAGE_POOL_NONE;
+   }
+
+   /* ====== Try to reuse message from pool ============================== */
+   if((messagePool != NULL) && (sizeClass != RSERPOOL_MESSAGE_POOL_NONE)) {
+      if((messagePool->FreeList[sizeClass] == NULL) &&
+         (atomic_load_explicit(&messagePool->RemoteFreeList, memory_order_relaxed) != NULL)) {
+         messagePoolTakeRemoteMessages(messagePool);
+      }
+      if(messagePool->FreeList[sizeClass] != NULL) {
+         message = messagePool->FreeList[sizeClass];
+         messagePool->FreeList[sizeClass] = message->NextFreeMessage;
+         messagePool->FreeCount[sizeClass]--;
+         messagePool->Statistics.PoolAllocations++;
       }
    }
 
+   /* ====== Allocate new message ======================================== */
+   if(message == NULL) {
+      message = (struct RSerPoolMessage*)malloc(sizeof(struct RSerPoolMessage) +
+                   ((sizeClass != RSERPOOL_MESSAGE_POOL_NONE) ?
+                       gMessagePoolBufferSize[sizeClass] : bufferSize));
+      if(message == NULL) {
+         return(NULL);
+      }
+      if(messagePool != NULL) {
+         messagePool->Statistics.HeapAllocations++;
+         if(sizeClass != RSERPOOL_MESSAGE_POOL_NONE) {
+            atomic_fetch_add_explicit(&messagePool->References, 1, memory_order_relaxed);
+         }
+      }
+   }
+
+   /* ====== Initialize message ========================================== */
+   /* The buffer itself is not cleared; rserpoolMessage2Packet() will
+      overwrite it. */
+   memset(message, 0, sizeof(struct RSerPoolMessage));
+   if(buffer == NULL) {
+      message->Buffer = (char*)((long)message + (long)sizeof(struct RSerPoolMessage));
+   }
+   else {
+      message->Buffer = buffer;
+   }
+   message->BufferSize         = bufferSize;
+   message->OriginalBufferSize = bufferSize;
+   message->PoolSizeClass      = sizeClass;
+   message->OwnerPool          = (sizeClass != RSERPOOL_MESSAGE_POOL_NONE) ? messagePool : NULL;
    return(message);
 }
 
@@ -67,13 +301,38 @@ struct RSerPoolMessage* rserpoolMessageNew(char* buffer, const size_t bufferSize
 /* ###### Destructor ##################################################### */
 void rserpoolMessageDelete(struct RSerPoolMessage* message)
 {
+   struct RSerPoolMessagePool* ownerPool;
+   unsigned int                sizeClass;
+
    if(message != NULL) {
+      sizeClass = message->PoolSizeClass;
+      ownerPool = message->OwnerPool;
       rserpoolMessageClearAll(message);
       if((message->BufferAutoDelete) && (message->Buffer)) {
          free(message->Buffer);
       }
       message->Buffer     = NULL;
       message->BufferSize = 0;
+
+      /* ====== Return message to its owner's pool ========================== */
+      if(ownerPool != NULL) {
+         /* The owner has created the key, i.e. no pthread_once() here */
+         if(pthread_getspecific(gMessagePoolKey) == ownerPool) {
+            if(ownerPool->FreeCount[sizeClass] < RSERPOOL_MESSAGE_POOL_SIZE) {
+               message->NextFreeMessage       = ownerPool->FreeList[sizeClass];
+               ownerPool->FreeList[sizeClass] = message;
+               ownerPool->FreeCount[sizeClass]++;
+            }
+            else {
+               free(message);
+               atomic_fetch_sub_explicit(&ownerPool->References, 1, memory_order_relaxed);
+            }
+         }
+         else {
+            messagePoolReturnRemoteMessage(ownerPool, message);
+         }
+         return;
+      }
       free(message);
    }
 }
@@ -87,6 +346,8 @@ void rserpoolMessageClearAll(struct RSerPoolMessage* message)
    char*                         buffer;
    size_t                        originalBufferSize;
    bool                          bufferAutoDelete;
+   unsigned int                  poolSizeClass;
+   struct RSerPoolMessagePool*   ownerPool;
    size_t                        i;
 
    if(message != NULL) {
@@ -165,11 +426,15 @@ void rserpoolMessageClearAll(struct RSerPoolMessage* message)
       buffer                      = message->Buffer;
       originalBufferSize          = message->OriginalBufferSize;
       bufferAutoDelete            = message->BufferAutoDelete;
+      poolSizeClass               = message->PoolSizeClass;
+      ownerPool                   = message->OwnerPool;
       memset(message,0,sizeof(struct RSerPoolMessage));
       message->BufferAutoDelete   = bufferAutoDelete;
       message->OriginalBufferSize = originalBufferSize;
       message->BufferSize         = originalBufferSize;
       message->Buffer             = buffer;
+      message->PoolSizeClass      = poolSizeClass;
+      message->OwnerPool          = ownerPool;
    }
 }
 
@@ -193,56 +458,89 @@ bool rserpoolMessageSend(int                      protocol,
                          const unsigned long long timeout,
                          struct RSerPoolMessage*  message)
 {
-   size_t   messageLength;
+   size_t messageLength;
+
+   messageLength = rserpoolMessage2Packet(message);
+   if(messageLength > 0) {
+      return(rserpoolMessageSendPacket(protocol, fd, assocID,
+                                       flags, sctpFlags, timeout,
+                                       message, messageLength));
+   }
+   LOG_ERROR
+   fputs("Unable to create packet for message\n",stdlog);
+   LOG_END
+   return(false);
+}
+
+
+/* ###### Send RSerPoolMessage's packet ################################## */
+bool rserpoolMessageSendPacket(int                      protocol,
+                               int                      fd,
+                               const sctp_assoc_t       assocID,
+                               const int                flags,
+                               const uint16_t           sctpFlags,
+                               const unsigned long long timeout,
+                               struct RSerPoolMessage*  message,
+                               const size_t             messageLength)
+{
    ssize_t  sent;
    uint32_t myPPID;
    size_t   i;
 
-   messageLength = rserpoolMessage2Packet(message);
-   if(messageLength > 0) {
-      myPPID = (protocol == IPPROTO_SCTP) ? message->PPID : 0;
-      sent = sendtoplus(fd,
-                        message->Buffer, messageLength,
+   myPPID = (protocol == IPPROTO_SCTP) ? message->PPID : 0;
+   sent = sendtoplus(fd,
+                     message->Buffer, messageLength,
 #ifdef MSG_NOSIGNAL
-                        flags|MSG_NOSIGNAL,
+                     flags|MSG_NOSIGNAL,
 #else
-                        flags,
+                     flags,
 #endif
-                        message->AddressArray, message->Addresses,
-                        myPPID,
-                        assocID,
-                        0, 0, sctpFlags, timeout);
-      if(sent == (ssize_t)messageLength) {
-         LOG_VERBOSE2
-         fprintf(stdlog, "Successfully sent ASAP message: "
-                 "assoc=%u PPID=$%08x, Type=$%02x\n",
-                 (unsigned int)assocID,
-                 myPPID,
-                 message->Type);
-         LOG_END
-         return(true);
-      }
-      LOG_VERBOSE
-      logerror("sendtoplus() error");
-      if(message->AddressArray) {
-         fputs("Failed to send to addresses:", stdlog);
-         for(i = 0;i < message->Addresses;i++) {
-            fputs("   ", stderr);
-            fputaddress(&message->AddressArray[i].sa, true, stdlog);
-         }
-         fputs("\n", stdlog);
-      }
+                     message->AddressArray, message->Addresses,
+                     myPPID,
+                     assocID,
+                     0, 0, sctpFlags, timeout);
+   if(sent == (ssize_t)messageLength) {
+      LOG_VERBOSE2
+      fprintf(stdlog, "Successfully sent ASAP message: "
+              "assoc=%u PPID=$%08x, Type=$%02x\n",
+              (unsigned int)assocID,
+              myPPID,
+              message->Type);
       LOG_END
+      return(true);
    }
-   else {
-      LOG_ERROR
-      fputs("Unable to create packet for message\n",stdlog);
-      LOG_END
+   LOG_VERBOSE
+   logerror("sendtoplus() error");
+   if(message->AddressArray) {
+      fputs("Failed to send to addresses:", stdlog);
+      for(i = 0;i < message->Addresses;i++) {
+         fputs("   ", stderr);
+         fputaddress(&message->AddressArray[i].sa, true, stdlog);
+      }
+      fputs("\n", stdlog);
    }
+   LOG_END
    return(false);
 }
 
 
+/* ###### Set receiver ID of ENRP message's packet ####################### */
+void rserpoolMessageSetENRPReceiverID(struct RSerPoolMessage*       message,
+                                      const size_t                  messageLength,
+                                      const RegistrarIdentifierType receiverID)
+{
+   struct rserpool_serverparameter* sp;
+
+   CHECK(message->PPID == PPID_ENRP);
+   CHECK(messageLength >= sizeof(struct rserpool_header) +
+                          sizeof(struct rserpool_serverparameter));
+
+   sp = (struct rserpool_serverparameter*)&message->Buffer[sizeof(struct rserpool_header)];
+   sp->sp_receiver_id  = htonl(receiverID);
+   message->ReceiverID = receiverID;
+}
+
+
 /* ###### Try to get space in RSerPoolMessage's buffer ####################### */
 void* getSpace(struct RSerPoolMessage* message,
                const size_t            headerSize)
@@ -44,6 +44,11 @@ extern "C" {
 /* Set internal limit */
 #define MAX_MAX_HANDLE_RESOLUTION_ITEMS 128
 
+/* Buffer sizes of the per-thread RSerPoolMessage pools */
+#define RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE 2048
+#define RSERPOOL_LARGE_MESSAGE_BUFFER_SIZE 65536
+#define RSERPOOL_MESSAGE_POOL_SIZE         16   /* Per size class and thread */
+
 
 #define PORT_ASAP 3863
 #define PORT_ENRP 9901  /* old value: 3864 */
@@ -67,6 +72,7 @@ extern "C" {
 #define AHT_COOKIE_ECHO                (0x0c | AHT_ASAP_MODIFIER)
 #define AHT_BUSINESS_CARD              (0x0d | AHT_ASAP_MODIFIER)
 #define AHT_ERROR                      (0x0e | AHT_ASAP_MODIFIER)
+#define AHT_LOAD_UPDATE                (0x3f | AHT_ASAP_MODIFIER)   /* Custom */
 
 
 #define AHF_REGISTRATION_REJECT        (1 << 0)
@@ -257,6 +263,12 @@ struct rserpool_policy_randomized_priority_leastused_degradation
    uint32_t pp_rplud_loaddeg;
 } __attribute__((packed));
 
+struct rserpool_policy_power_of_two_choices
+{
+   uint32_t pp_p2c_policy;
+   uint32_t pp_p2c_load;
+} __attribute__((packed));
+
 
 struct rserpool_errorcause
 {
@@ -397,12 +409,25 @@ struct RSerPoolMessage
    sctp_assoc_t                                AssocID;
    uint32_t                                    PPID;
    union sockaddr_union                        SourceAddress;
+
+   unsigned int                                PoolSizeClass;
+   struct RSerPoolMessagePool*                 OwnerPool;
+   struct RSerPoolMessage*                     NextFreeMessage;
+};
+
+
+struct RSerPoolMessagePoolStatistics
+{
+   unsigned long long HeapAllocations;
+   unsigned long long PoolAllocations;
+   unsigned long long RemoteReturns;   /* Returned by other threads */
 };
 
 
 
 /**
-  * Constructor.
+  * Constructor. Messages are taken from a per-thread pool, if possible.
+  * Their buffers are not cleared.
   *
   * @param buffer Buffer or NULL if buffer of given bufferSize should be allocated.
   * @param bufferSize Size of buffer.
@@ -411,12 +436,22 @@ struct RSerPoolMessage
 struct RSerPoolMessage* rserpoolMessageNew(char* buffer, const size_t bufferSize);
 
 /**
-  * Destructor.
+  * Destructor. The message is returned to the pool of the thread that
+  * has allocated it, even if another thread deletes it.
   *
   * @param message RSerPoolMessage.
   */
 void rserpoolMessageDelete(struct RSerPoolMessage* message);
 
+/**
+  * Get the RSerPoolMessage allocation statistics of the calling thread.
+  * In steady state, all messages should be obtained from the pool, i.e.
+  * HeapAllocations should not increase any more.
+  *
+  * @param statistics Reference to store statistics to.
+  */
+void rserpoolMessageGetPoolStatistics(struct RSerPoolMessagePoolStatistics* statistics);
+
 /**
   * Clear all fields of the RSerPoolMessage.
   *
@@ -452,6 +487,44 @@ bool rserpoolMessageSend(int                      protocol,
                          const unsigned long long timeout,
                          struct RSerPoolMessage*  message);
 
+/**
+  * Send the packet of an RSerPoolMessage, which has already been created
+  * by rserpoolMessage2Packet(), to file descriptor with given timeout.
+  * This allows to send the same packet to multiple destinations without
+  * re-encoding it.
+  *
+  * @param protocol Protocol (e.g. IPPROTO_SCTP).
+  * @param fd File descriptor to write packet to.
+  * @param assocID Association ID.
+  * @param flags Flags for sendmsg().
+  * @param sctpFlags SCTP flags.
+  * @param timeout Timeout in microseconds.
+  * @param message RSerPoolMessage.
+  * @param messageLength Length of the packet in the message's buffer.
+  * @return true in case of success; false otherwise.
+  */
+bool rserpoolMessageSendPacket(int                      protocol,
+                               int                      fd,
+                               const sctp_assoc_t       assocID,
+                               const int                flags,
+                               const uint16_t           sctpFlags,
+                               const unsigned long long timeout,
+                               struct RSerPoolMessage*  message,
+                               const size_t             messageLength);
+
+/**
+  * Set receiver ID in the packet of an ENRP message, which has already been
+  * created by rserpoolMessage2Packet(). All ENRP messages begin with sender
+  * and receiver ID, i.e. this is the only per-peer field of the packet.
+  *
+  * @param message RSerPoolMessage.
+  * @param messageLength Length of the packet in the message's buffer.
+  * @param receiverID Receiver ID.
+  */
+void rserpoolMessageSetENRPReceiverID(struct RSerPoolMessage*       message,
+                                      const size_t                  messageLength,
+                                      const RegistrarIdentifierType receiverID);
+
 /**
   * For internal usage only!
   */
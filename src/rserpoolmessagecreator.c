@@ -331,6 +331,7 @@ static bool createPolicyParameter(struct RSerPoolMessage*          message,
    struct rserpool_policy_randomized_leastused_degradation*          rlud;
    struct rserpool_policy_randomized_priority_leastused*             rplu;
    struct rserpool_policy_randomized_priority_leastused_degradation* rplud;
+   struct rserpool_policy_power_of_two_choices*                      p2c;
 
    if(beginTLV(message, &tlvPosition, ATT_POOL_POLICY) == false) {
       return(false);
@@ -483,6 +484,14 @@ static bool createPolicyParameter(struct RSerPoolMessage*          message,
           rplud->pp_rplud_load    = htonl(poolPolicySettings->Load);
           rplud->pp_rplud_loaddeg = htonl(poolPolicySettings->LoadDegradation);
        break;
+      case PPT_POWER_OF_TWO_CHOICES:
+          p2c = (struct rserpool_policy_power_of_two_choices*)getSpace(message, sizeof(struct rserpool_policy_power_of_two_choices));
+          if(p2c == NULL) {
+             return(false);
+          }
+          p2c->pp_p2c_policy = htonl(poolPolicySettings->PolicyType);
+          p2c->pp_p2c_load   = htonl(poolPolicySettings->Load);
+       break;
       default:
          LOG_ERROR
          fprintf(stdlog, "Unknown policy #$%02x\n", poolPolicySettings->PolicyType);
@@ -494,22 +503,14 @@ static bool createPolicyParameter(struct RSerPoolMessage*          message,
 }
 
 
-/* ###### Create pool element parameter ################################## */
-static bool createPoolElementParameter(
+/* ###### Create pool element parameter up to policy parameter ########## */
+static bool createPoolElementParameterPrefix(
                struct RSerPoolMessage*                 message,
-               const struct ST_CLASS(PoolElementNode)* poolElement,
-               const bool                              includeRegistratorTransport)
+               const struct ST_CLASS(PoolElementNode)* poolElement)
 {
    size_t                                tlvPosition = 0;
    struct rserpool_poolelementparameter* pep;
 
-   if(poolElement == NULL) {
-      LOG_ERROR
-      fputs("Invalid parameters\n", stdlog);
-      LOG_END_FATAL
-      return(false);
-   }
-
    if(beginTLV(message, &tlvPosition, ATT_POOL_ELEMENT) == false) {
       return(false);
    }
@@ -523,7 +524,26 @@ static bool createPoolElementParameter(
    pep->pep_homeserverid = htonl(poolElement->HomeRegistrarIdentifier);
    pep->pep_reg_life     = htonl(poolElement->RegistrationLife);
 
-   if(createTransportParameter(message, poolElement->UserTransport) == false) {
+   return(createTransportParameter(message, poolElement->UserTransport));
+}
+
+
+/* ###### Create pool element parameter ################################## */
+static bool createPoolElementParameter(
+               struct RSerPoolMessage*                 message,
+               const struct ST_CLASS(PoolElementNode)* poolElement,
+               const bool                              includeRegistratorTransport)
+{
+   const size_t tlvPosition = message->Position;
+
+   if(poolElement == NULL) {
+      LOG_ERROR
+      fputs("Invalid parameters\n", stdlog);
+      LOG_END_FATAL
+      return(false);
+   }
+
+   if(createPoolElementParameterPrefix(message, poolElement) == false) {
       return(false);
    }
 
@@ -542,6 +562,54 @@ static bool createPoolElementParameter(
 }
 
 
+/* ###### Create pool element parameter using cached encoding ########### */
+/*
+   The Pool Element parameter up to the policy parameter (i.e. TLV header,
+   identifier, home registrar, registration life and user transport) only
+   changes upon reregistration or takeover. Its encoding is therefore cached
+   in the PoolElementNode and invalidated by the handlespace management when
+   one of these fields changes. Only the policy parameter, which contains
+   per-selection state, is encoded for every message.
+*/
+static bool createPoolElementParameterFromCache(
+               struct RSerPoolMessage*           message,
+               struct ST_CLASS(PoolElementNode)* poolElement)
+{
+   const size_t tlvPosition = message->Position;
+   char*        encodedParameter;
+   size_t       encodedParameterSize;
+
+   /* ====== Cache miss -> create encoding ================================ */
+   if(poolElement->EncodedParameter == NULL) {
+      if(createPoolElementParameterPrefix(message, poolElement) == false) {
+         return(false);
+      }
+      encodedParameterSize = message->Position - tlvPosition;
+      encodedParameter     = (char*)malloc(encodedParameterSize);
+      if(encodedParameter != NULL) {   /* Caching is optional */
+         memcpy(encodedParameter, &message->Buffer[tlvPosition], encodedParameterSize);
+         poolElement->EncodedParameter     = encodedParameter;
+         poolElement->EncodedParameterSize = encodedParameterSize;
+      }
+   }
+
+   /* ====== Cache hit -> copy encoding =================================== */
+   else {
+      encodedParameter = (char*)getSpace(message, poolElement->EncodedParameterSize);
+      if(encodedParameter == NULL) {
+         return(false);
+      }
+      memcpy(encodedParameter, poolElement->EncodedParameter,
+             poolElement->EncodedParameterSize);
+   }
+
+   if(createPolicyParameter(message, &poolElement->PolicySettings) == false) {
+      return(false);
+   }
+   return(finishTLV(message, tlvPosition));
+}
+
+
 /* ###### Create pool element identifier parameter ####################### */
 static bool createPoolElementIdentifierParameter(
                struct RSerPoolMessage*         message,
@@ -777,6 +845,27 @@ static bool createEndpointUnreachableMessage(struct RSerPoolMessage* message)
 }
 
 
+/* ###### Create load update message ##################################### */
+static bool createLoadUpdateMessage(struct RSerPoolMessage* message)
+{
+   if(beginMessage(message, AHT_LOAD_UPDATE, message->Flags & 0x00, PPID_ASAP) == NULL) {
+      return(false);
+   }
+
+   if(createPoolHandleParameter(message, &message->Handle) == false) {
+      return(false);
+   }
+   if(createPoolElementIdentifierParameter(message, message->Identifier) == false) {
+      return(false);
+   }
+   if(createPolicyParameter(message, &message->PolicySettings) == false) {
+      return(false);
+   }
+
+   return(finishMessage(message));
+}
+
+
 /* ###### Create registration message #################################### */
 static bool createRegistrationMessage(struct RSerPoolMessage* message)
 {
@@ -806,13 +895,8 @@ static bool createRegistrationMessage(struct RSerPoolMessage* message)
 /* ###### Create registration response message ########################### */
 static bool createRegistrationResponseMessage(struct RSerPoolMessage* message)
 {
-   if(message->PoolElementPtr == NULL)  {
-      LOG_ERROR
-      fputs("Invalid parameters\n", stdlog);
-      LOG_END_FATAL
-      return(false);
-   }
-
+   /* Only handle and identifier are needed here: a Registration Response
+      also answers a Load Update, which has no PoolElementPtr. */
    if(beginMessage(message, AHT_REGISTRATION_RESPONSE,
                    message->Flags & AHF_REGISTRATION_REJECT, PPID_ASAP) == NULL) {
       return(false);
@@ -913,8 +997,9 @@ static bool createHandleResolutionResponseMessage(struct RSerPoolMessage* messag
          return(false);
       }
 
+      /* The PEs are handlespace nodes of the registrar here */
       for(i = 0;i < message->PoolElementPtrArraySize;i++) {
-         if(createPoolElementParameter(message, message->PoolElementPtrArray[i], false) == false) {
+         if(createPoolElementParameterFromCache(message, message->PoolElementPtrArray[i]) == false) {
             return(false);
          }
       }
@@ -1472,6 +1557,14 @@ size_t rserpoolMessage2Packet(struct RSerPoolMessage* message)
              return(message->Position);
           }
         break;
+      case AHT_LOAD_UPDATE:
+          LOG_VERBOSE2
+          fputs("Creating LoadUpdate message...\n", stdlog);
+          LOG_END
+          if(createLoadUpdateMessage(message) == true) {
+             return(message->Position);
+          }
+        break;
        case AHT_ERROR:
           LOG_VERBOSE2
           fputs("Creating Error (ASAP) message...\n", stdlog);
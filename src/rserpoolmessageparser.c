@@ -544,6 +544,7 @@ static bool scanPolicyParameter(struct RSerPoolMessage*    message,
    struct rserpool_policy_randomized_leastused_degradation*          rlud;
    struct rserpool_policy_randomized_priority_leastused*             rplu;
    struct rserpool_policy_randomized_priority_leastused_degradation* rplud;
+   struct rserpool_policy_power_of_two_choices*                      p2c;
    uint32_t                                                          policyType;
 
    size_t  tlvPosition = 0;
@@ -952,6 +953,27 @@ static bool scanPolicyParameter(struct RSerPoolMessage*    message,
             return(false);
          }
        break;
+      case PPT_POWER_OF_TWO_CHOICES:
+         if(tlvLength >= sizeof(struct rserpool_policy_power_of_two_choices)) {
+            p2c = (struct rserpool_policy_power_of_two_choices*)getSpace(message, sizeof(struct rserpool_policy_power_of_two_choices));
+            if(p2c == NULL) {
+               return(false);
+            }
+            poolPolicySettings->PolicyType = ntohl(p2c->pp_p2c_policy);
+            poolPolicySettings->Weight     = 0;
+            poolPolicySettings->Load       = ntohl(p2c->pp_p2c_load);
+            LOG_VERBOSE3
+            fprintf(stdlog, "Scanned policy P2C, load=$%06x\n",poolPolicySettings->Load);
+            LOG_END
+         }
+         else {
+            LOG_WARNING
+            fputs("P2C TLV too short\n", stdlog);
+            LOG_END
+            message->Error = RSPERR_INVALID_TLV;
+            return(false);
+         }
+       break;
       default:
          LOG_WARNING
          fprintf(stdlog, "Unsupported policy $%08x\n", policyType);
@@ -1444,6 +1466,22 @@ static bool scanDeregistrationMessage(struct RSerPoolMessage* message)
 }
 
 
+/* ###### Scan load update message ####################################### */
+static bool scanLoadUpdateMessage(struct RSerPoolMessage* message)
+{
+   if(scanPoolHandleParameter(message, &message->Handle) == false) {
+      return(false);
+   }
+   if(scanPoolElementIdentifierParameter(message) == false) {
+      return(false);
+   }
+   if(scanPolicyParameter(message, &message->PolicySettings) == false) {
+      return(false);
+   }
+   return(true);
+}
+
+
 /* ###### Scan registration response message ############################# */
 static bool scanRegistrationResponseMessage(struct RSerPoolMessage* message)
 {
@@ -2126,6 +2164,14 @@ static bool scanMessage(struct RSerPoolMessage* message)
             return(false);
          }
        break;
+      case AHT_LOAD_UPDATE:
+         LOG_VERBOSE2
+         fputs("Scanning LoadUpdate message...\n", stdlog);
+         LOG_END
+         if(scanLoadUpdateMessage(message) == false) {
+            return(false);
+         }
+       break;
       case AHT_REGISTRATION_RESPONSE:
          LOG_VERBOSE2
          fputs("Scanning RegistrationResponse message...\n", stdlog);
@@ -34,47 +34,132 @@
 #include "loglevel.h"
 #include "debug.h"
 
+#include <stddef.h>
+#include <stdatomic.h>
 
-extern struct SimpleRedBlackTree gRSerPoolSocketSet;
-extern struct ThreadSafety       gRSerPoolSocketSetMutex;
+
+/*
+   The RSerPool socket descriptor table is indexed directly by descriptor.
+   Lookups only perform an atomic load of the slot, i.e. they need neither
+   a lock nor a tree walk. Modifications of the table (together with the
+   allocation bitmap) are serialized by gRSerPoolSocketSetMutex. A slot is
+   cleared before its RSerPoolSocket is closed, so lookups after rsp_close()
+   fail. As for POSIX close(), a descriptor must not be closed while it is
+   still in use by another thread.
+   Functions which keep an RSerPoolSocket across a blocking call (e.g.
+   rsp_poll() and rsp_epoll_wait()), where another thread may close it,
+   have to hold a reference instead. The table itself holds one reference.
+   Taking a reference is lock-free as well: the reference counter is only
+   incremented while it is non-zero, and the table slot is checked again
+   afterwards. Since a lookup may therefore still access an RSerPoolSocket
+   after its last reference has been released, the memory of released
+   RSerPoolSockets is kept in a free list for reuse as RSerPoolSockets and
+   only returned to the heap by rserpoolSocketTableDelete().
+*/
+extern struct ThreadSafety              gRSerPoolSocketSetMutex;
+static _Atomic(struct RSerPoolSocket*)* gRSerPoolSocketTable     = NULL;
+static size_t                           gRSerPoolSocketTableSize = 0;
+static struct RSerPoolSocket*           gRSerPoolSocketFreeList  = NULL;   /* Protected by gRSerPoolSocketSetMutex */
 
 
-/* ###### Print function ################################################# */
-void rserpoolSocketPrint(const void* node, FILE* fd)
+/* ###### Create RSerPool socket descriptor table ######################## */
+bool rserpoolSocketTableNew(const size_t entries)
 {
-   const struct RSerPoolSocket* rserpoolSocket = (const struct RSerPoolSocket*)node;
+   size_t i;
 
-   fprintf(fd, "%d ", rserpoolSocket->Descriptor);
+   gRSerPoolSocketTable = (_Atomic(struct RSerPoolSocket*)*)malloc(entries * sizeof(_Atomic(struct RSerPoolSocket*)));
+   if(gRSerPoolSocketTable == NULL) {
+      return(false);
+   }
+   for(i = 0;i < entries;i++) {
+      atomic_init(&gRSerPoolSocketTable[i], NULL);
+   }
+   gRSerPoolSocketTableSize = entries;
+   return(true);
 }
 
 
-/* ###### Comparison function ############################################ */
-int rserpoolSocketComparison(const void* node1, const void* node2)
+/* ###### Delete RSerPool socket descriptor table ######################## */
+void rserpoolSocketTableDelete()
 {
-   const struct RSerPoolSocket* rserpoolSocket1 = (const struct RSerPoolSocket*)node1;
-   const struct RSerPoolSocket* rserpoolSocket2 = (const struct RSerPoolSocket*)node2;
+   struct RSerPoolSocket* rserpoolSocket;
 
-   if(rserpoolSocket1->Descriptor < rserpoolSocket2->Descriptor) {
-      return(-1);
-   }
-   else if(rserpoolSocket1->Descriptor > rserpoolSocket2->Descriptor) {
-      return(1);
+   gRSerPoolSocketTableSize = 0;
+   free(gRSerPoolSocketTable);
+   gRSerPoolSocketTable = NULL;
+
+   while(gRSerPoolSocketFreeList != NULL) {
+      rserpoolSocket          = gRSerPoolSocketFreeList;
+      gRSerPoolSocketFreeList = rserpoolSocket->NextFree;
+      free(rserpoolSocket);
    }
-   return(0);
 }
 
 
-/* ###### Get RSerPool socket for given descriptor ####################### */
-struct RSerPoolSocket* getRSerPoolSocketForDescriptor(int sd)
+/* ###### Allocate RSerPool socket ####################################### */
+/* The RSerPoolSocket is zeroed, its reference counter is 0. */
+struct RSerPoolSocket* rserpoolSocketNew()
 {
+   const size_t           offset = offsetof(struct RSerPoolSocket, NextFree);
    struct RSerPoolSocket* rserpoolSocket;
-   struct RSerPoolSocket  cmpSocket;
 
-   cmpSocket.Descriptor = sd;
    threadSafetyLock(&gRSerPoolSocketSetMutex);
-   rserpoolSocket = (struct RSerPoolSocket*)simpleRedBlackTreeFind(&gRSerPoolSocketSet,
-                                                                   &cmpSocket.Node);
+   rserpoolSocket = gRSerPoolSocketFreeList;
+   if(rserpoolSocket != NULL) {
+      gRSerPoolSocketFreeList = rserpoolSocket->NextFree;
+   }
    threadSafetyUnlock(&gRSerPoolSocketSetMutex);
+
+   if(rserpoolSocket == NULL) {
+      rserpoolSocket = (struct RSerPoolSocket*)malloc(sizeof(struct RSerPoolSocket));
+      if(rserpoolSocket == NULL) {
+         return(NULL);
+      }
+      atomic_init(&rserpoolSocket->ReferenceCount, 0);
+   }
+   /* A stale lookup may still read the reference counter concurrently */
+   memset((char*)rserpoolSocket + offset, 0, sizeof(struct RSerPoolSocket) - offset);
+   return(rserpoolSocket);
+}
+
+
+/* ###### Put RSerPool socket into free list ############################# */
+void rserpoolSocketFree(struct RSerPoolSocket* rserpoolSocket)
+{
+   CHECK(atomic_load_explicit(&rserpoolSocket->ReferenceCount, memory_order_relaxed) == 0);
+   threadSafetyLock(&gRSerPoolSocketSetMutex);
+   rserpoolSocket->NextFree = gRSerPoolSocketFreeList;
+   gRSerPoolSocketFreeList  = rserpoolSocket;
+   threadSafetyUnlock(&gRSerPoolSocketSetMutex);
+}
+
+
+/* ###### Set RSerPool socket for given descriptor ####################### */
+void setRSerPoolSocketForDescriptor(const int              sd,
+                                    struct RSerPoolSocket* rserpoolSocket)
+{
+   CHECK((sd >= 0) && ((size_t)sd < gRSerPoolSocketTableSize));
+   atomic_store_explicit(&gRSerPoolSocketTable[sd], rserpoolSocket,
+                         memory_order_release);
+}
+
+
+/* ###### Find RSerPool socket for given descriptor ###################### */
+struct RSerPoolSocket* findRSerPoolSocketForDescriptor(int sd)
+{
+   if((sd >= 0) && ((size_t)sd < gRSerPoolSocketTableSize)) {
+      return(atomic_load_explicit(&gRSerPoolSocketTable[sd],
+                                  memory_order_acquire));
+   }
+   return(NULL);
+}
+
+
+/* ###### Get RSerPool socket for given descriptor ####################### */
+struct RSerPoolSocket* getRSerPoolSocketForDescriptor(int sd)
+{
+   struct RSerPoolSocket* rserpoolSocket = findRSerPoolSocketForDescriptor(sd);
+
    if(rserpoolSocket == NULL) {
       LOG_ERROR
       fprintf(stdlog, "Bad RSerPool socket descriptor %d\n", sd);
@@ -84,6 +169,96 @@ struct RSerPoolSocket* getRSerPoolSocketForDescriptor(int sd)
 }
 
 
+/* ###### Get RSerPool socket for given descriptor and hold reference #### */
+struct RSerPoolSocket* acquireRSerPoolSocketForDescriptor(int sd)
+{
+   struct RSerPoolSocket* rserpoolSocket;
+   unsigned int           references;
+
+   for(;;) {
+      rserpoolSocket = findRSerPoolSocketForDescriptor(sd);
+      if(rserpoolSocket == NULL) {
+         return(NULL);
+      }
+
+      /* ====== Increment reference counter, unless already released ===== */
+      references = atomic_load_explicit(&rserpoolSocket->ReferenceCount,
+                                        memory_order_relaxed);
+      while( (references > 0) &&
+             (!atomic_compare_exchange_weak_explicit(&rserpoolSocket->ReferenceCount,
+                                                     &references, references + 1,
+                                                     memory_order_acquire,
+                                                     memory_order_relaxed)) ) {
+      }
+
+      /* ====== Check, whether the slot still refers to the socket ======== */
+      /* Otherwise, the socket has been closed and possibly been reused. */
+      if(references > 0) {
+         if(findRSerPoolSocketForDescriptor(sd) == rserpoolSocket) {
+            return(rserpoolSocket);
+         }
+         releaseRSerPoolSocket(rserpoolSocket);
+      }
+   }
+}
+
+
+/* ###### Hold reference to RSerPool socket ############################## */
+/* The caller has to hold a reference already! */
+void holdRSerPoolSocket(struct RSerPoolSocket* rserpoolSocket)
+{
+   CHECK(atomic_fetch_add_explicit(&rserpoolSocket->ReferenceCount, 1,
+                                   memory_order_relaxed) > 0);
+}
+
+
+/* ###### Release reference to RSerPool socket ########################### */
+void releaseRSerPoolSocket(struct RSerPoolSocket* rserpoolSocket)
+{
+   const unsigned int references =
+      atomic_fetch_sub_explicit(&rserpoolSocket->ReferenceCount, 1,
+                                memory_order_acq_rel);
+
+   CHECK(references > 0);
+   if(references == 1) {
+      CHECK(rserpoolSocket->Descriptor < 0);
+      threadSafetyDelete(&rserpoolSocket->Mutex);
+      rserpoolSocketFree(rserpoolSocket);
+   }
+}
+
+
+/* ###### Get next RSerPool socket after given descriptor ################ */
+/* The caller has to hold gRSerPoolSocketSetMutex! */
+static struct RSerPoolSocket* getRSerPoolSocketFromDescriptor(size_t sd)
+{
+   struct RSerPoolSocket* rserpoolSocket;
+
+   for(   ;sd < gRSerPoolSocketTableSize;sd++) {
+      rserpoolSocket = atomic_load_explicit(&gRSerPoolSocketTable[sd],
+                                            memory_order_relaxed);
+      if(rserpoolSocket != NULL) {
+         return(rserpoolSocket);
+      }
+   }
+   return(NULL);
+}
+
+
+/* ###### Get first RSerPool socket ###################################### */
+struct RSerPoolSocket* getFirstRSerPoolSocket()
+{
+   return(getRSerPoolSocketFromDescriptor(0));
+}
+
+
+/* ###### Get next RSerPool socket ####################################### */
+struct RSerPoolSocket* getNextRSerPoolSocket(const struct RSerPoolSocket* rserpoolSocket)
+{
+   return(getRSerPoolSocketFromDescriptor((size_t)rserpoolSocket->Descriptor + 1));
+}
+
+
 /* ###### Wait until there is something to read ########################## */
 bool waitForRead(struct RSerPoolSocket* rserpoolSocket,
                  int                    timeout)
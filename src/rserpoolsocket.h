@@ -42,6 +42,7 @@
 #include "tagitem.h"
 
 #include <ext_socket.h>
+#include <stdatomic.h>
 
 
 #ifdef __cplusplus
@@ -65,10 +66,20 @@ struct PoolElement
    bool                InDaemonMode;
 };
 
-struct RSerPoolSocket
+struct EpollRegistration
 {
-   struct SimpleRedBlackTreeNode Node;
+   struct EpollRegistration*     Next;
+   int                           EpollFD;
+   uint32_t                      Events;
+   uint64_t                      Data;           /* User's epoll_data     */
+   unsigned long long            WaitSequence;   /* Last rsp_epoll_wait() */
+   int                           WaitIndex;      /* Its result index      */
+};
 
+struct RSerPoolSocket
+{
+   atomic_uint                   ReferenceCount;     /* Must be the first member */
+   struct RSerPoolSocket*        NextFree;           /* Free list link           */
    int                           Descriptor;
    struct ThreadSafety           Mutex;
 
@@ -89,15 +100,26 @@ struct RSerPoolSocket
 
    struct IdentifierBitmap*      SessionAllocationBitmap;
    char*                         MessageBuffer;
+
+   struct EpollRegistration*     EpollRegistrations;
 };
 
 #define RSERPOOL_MESSAGE_BUFFER_SIZE 65536
 
 
-void rserpoolSocketPrint(const void* node, FILE* fd);
-int rserpoolSocketComparison(const void* node1, const void* node2);
-
+bool rserpoolSocketTableNew(const size_t entries);
+void rserpoolSocketTableDelete();
+struct RSerPoolSocket* rserpoolSocketNew();
+void rserpoolSocketFree(struct RSerPoolSocket* rserpoolSocket);
+void setRSerPoolSocketForDescriptor(const int              sd,
+                                    struct RSerPoolSocket* rserpoolSocket);
+struct RSerPoolSocket* findRSerPoolSocketForDescriptor(int sd);
 struct RSerPoolSocket* getRSerPoolSocketForDescriptor(int sd);
+struct RSerPoolSocket* acquireRSerPoolSocketForDescriptor(int sd);
+void holdRSerPoolSocket(struct RSerPoolSocket* rserpoolSocket);
+void releaseRSerPoolSocket(struct RSerPoolSocket* rserpoolSocket);
+struct RSerPoolSocket* getFirstRSerPoolSocket();
+struct RSerPoolSocket* getNextRSerPoolSocket(const struct RSerPoolSocket* rserpoolSocket);
 bool waitForRead(struct RSerPoolSocket* rserpoolSocket,
                  int                    timeout);
 void deletePoolElement(struct PoolElement* poolElement,
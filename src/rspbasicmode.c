@@ -52,7 +52,6 @@ static struct ThreadSafety gThreadSafety;
 struct CSPReporter*        gCSPReporter = NULL;
 #endif
 
-struct SimpleRedBlackTree  gRSerPoolSocketSet;
 struct ThreadSafety        gRSerPoolSocketSetMutex;
 struct IdentifierBitmap*   gRSerPoolSocketAllocationBitmap;
 
@@ -139,6 +138,7 @@ int rsp_initialize(struct rsp_info* info)
    threadSafetyNew(&gThreadSafety, "RsplibInstance");
    threadSafetyNew(&gRSerPoolSocketSetMutex, "gRSerPoolSocketSet");
    dispatcherNew(&gDispatcher, lock, unlock, NULL);
+   dispatcherSetEPollMode(&gDispatcher, true);   /* Falls back to poll(), if unavailable */
    gAsapInstance = asapInstanceNew(&gDispatcher,
                                    (info->ri_disable_autoconfig == 0),
                                    (union sockaddr_union*)info->ri_registrar_announce,
@@ -151,14 +151,10 @@ int rsp_initialize(struct rsp_info* info)
          info->ri_build_time = NULL;
       }
 
-      /* ====== Initialize session storage =============================== */
-      simpleRedBlackTreeNew(&gRSerPoolSocketSet,
-                            rserpoolSocketPrint,
-                            rserpoolSocketComparison);
-
       /* ====== Initialize RSerPool Socket descriptor storage ============ */
       gRSerPoolSocketAllocationBitmap = identifierBitmapNew(FD_SETSIZE);
-      if(gRSerPoolSocketAllocationBitmap != NULL) {
+      if( (gRSerPoolSocketAllocationBitmap != NULL) &&
+          (rserpoolSocketTableNew(gRSerPoolSocketAllocationBitmap->Entries)) ) {
          /* ====== Map stdin, stdout, stderr file descriptors ============ */
          CHECK(rsp_mapsocket(STDOUT_FILENO, STDOUT_FILENO) == STDOUT_FILENO);
          CHECK(rsp_mapsocket(STDIN_FILENO,  STDIN_FILENO)  == STDIN_FILENO);
@@ -258,8 +254,8 @@ void rsp_cleanup()
       threadSafetyDelete(&gRSerPoolSocketSetMutex);
       threadSafetyDelete(&gThreadSafety);
 
-      /* ====== Remove socket set ======================================== */
-      simpleRedBlackTreeDelete(&gRSerPoolSocketSet);
+      /* ====== Remove socket table ====================================== */
+      rserpoolSocketTableDelete();
       identifierBitmapDelete(gRSerPoolSocketAllocationBitmap);
       gRSerPoolSocketAllocationBitmap = NULL;
 
@@ -380,6 +376,32 @@ static unsigned int convertPoolElementNode(
 }
 
 
+/* ###### Convert handle resolution result ############################## */
+static int makeAddrInfoList(const unsigned int    hresResult,
+                            void**                addrInfoArray,
+                            const size_t          addrInfos,
+                            struct rsp_addrinfo** rspAddrInfo)
+{
+   size_t n;
+
+   *rspAddrInfo = NULL;
+   if(hresResult == RSPERR_OKAY) {
+      if(addrInfos > 0) {
+         for(n = 0;n < addrInfos - 1;n++) {
+            ((struct rsp_addrinfo*)addrInfoArray[n])->ai_next =
+               (struct rsp_addrinfo*)addrInfoArray[n + 1];
+         }
+         *rspAddrInfo = (struct rsp_addrinfo*)addrInfoArray[0];
+      }
+      return(addrInfos);
+   }
+   else if(hresResult == RSPERR_NOT_FOUND) {
+      return(REAI_NONAME);
+   }
+   return(REAI_SYSTEM);
+}
+
+
 /* ###### Handle resolution ############################################## */
 int rsp_getaddrinfo_tags(const unsigned char*  poolHandle,
                          const size_t          poolHandleSize,
@@ -393,7 +415,6 @@ int rsp_getaddrinfo_tags(const unsigned char*  poolHandle,
    size_t            addrInfos;
    unsigned int      hresResult;
    int               result;
-   size_t            n;
 
    *rspAddrInfo = NULL;
    if(gAsapInstance) {
@@ -407,24 +428,8 @@ int rsp_getaddrinfo_tags(const unsigned char*  poolHandle,
                       &addrInfos,
                       convertPoolElementNode,
                       1000ULL * staleCacheValue);
-      if(hresResult == RSPERR_OKAY) {
-         if(addrInfos > 0) {
-            for(n = 0;n < addrInfos - 1;n++) {
-               ((struct rsp_addrinfo*)addrInfoArray[n])->ai_next =
-                  (struct rsp_addrinfo*)addrInfoArray[n + 1];
-            }
-            *rspAddrInfo = (struct rsp_addrinfo*)addrInfoArray[0];
-         }
-         return(addrInfos);
-      }
-      else {
-         if(hresResult == RSPERR_NOT_FOUND) {
-            result = REAI_NONAME;
-         }
-         else {
-            result = REAI_SYSTEM;
-         }
-      }
+      result = makeAddrInfoList(hresResult, (void**)&addrInfoArray, addrInfos,
+                                rspAddrInfo);
    }
    else {
       LOG_ERROR
@@ -437,6 +442,74 @@ int rsp_getaddrinfo_tags(const unsigned char*  poolHandle,
 }
 
 
+/* Context of rsp_getaddrinfo_async() call */
+struct AsyncHandleResolution
+{
+   rsp_getaddrinfo_callback_t Callback;
+   void*                      UserData;
+};
+
+
+/* ###### Asynchronous handle resolution completion ###################### */
+static void asyncHandleResolutionCompleted(unsigned int hresResult,
+                                           void**       addrInfoArray,
+                                           size_t       addrInfos,
+                                           void*        userData)
+{
+   struct AsyncHandleResolution* asyncHandleResolution = (struct AsyncHandleResolution*)userData;
+   struct rsp_addrinfo*          rspAddrInfo;
+   int                           result;
+
+   result = makeAddrInfoList(hresResult, addrInfoArray, addrInfos, &rspAddrInfo);
+   asyncHandleResolution->Callback(result, rspAddrInfo,
+                                   asyncHandleResolution->UserData);
+   free(asyncHandleResolution);
+}
+
+
+/* ###### Asynchronous handle resolution ################################# */
+int rsp_getaddrinfo_async(const unsigned char*       poolHandle,
+                          const size_t               poolHandleSize,
+                          const size_t               items,
+                          const unsigned int         staleCacheValue,
+                          rsp_getaddrinfo_callback_t callback,
+                          void*                      userData)
+{
+   struct AsyncHandleResolution* asyncHandleResolution;
+   struct PoolHandle             myPoolHandle;
+   unsigned int                  hresResult;
+
+   if(gAsapInstance == NULL) {
+      LOG_ERROR
+      fputs("rsplib is not initialized\n", stdlog);
+      LOG_END
+      return(REAI_SYSTEM);
+   }
+
+   asyncHandleResolution = (struct AsyncHandleResolution*)malloc(sizeof(struct AsyncHandleResolution));
+   if(asyncHandleResolution == NULL) {
+      return(REAI_MEMORY);
+   }
+   asyncHandleResolution->Callback = callback;
+   asyncHandleResolution->UserData = userData;
+
+   poolHandleNew(&myPoolHandle, poolHandle, poolHandleSize);
+   hresResult = asapInstanceHandleResolutionAsync(
+                   gAsapInstance,
+                   &myPoolHandle,
+                   max(1, min((size_t)items, MAX_MAX_HANDLE_RESOLUTION_ITEMS)),
+                   convertPoolElementNode,
+                   1000ULL * staleCacheValue,
+                   asyncHandleResolutionCompleted,
+                   asyncHandleResolution);
+   if(hresResult != RSPERR_OKAY) {
+      free(asyncHandleResolution);
+      return(REAI_MEMORY);
+   }
+   return(0);
+}
+
+
 /* ###### Handle resolution ############################################## */
 int rsp_getaddrinfo(const unsigned char*  poolHandle,
                     const size_t          poolHandleSize,
@@ -593,6 +666,52 @@ unsigned int rsp_pe_deregistration(const unsigned char* poolHandle,
 }
 
 
+/* ###### Update pool element's load ##################################### */
+unsigned int rsp_pe_update_load_tags(const unsigned char*       poolHandle,
+                                     const size_t               poolHandleSize,
+                                     const uint32_t             identifier,
+                                     const struct rsp_loadinfo* rspLoadInfo,
+                                     struct TagItem*            tags)
+{
+   struct PoolHandle         myPoolHandle;
+   struct PoolPolicySettings myPolicySettings;
+   unsigned int              result;
+
+   if(gAsapInstance) {
+      poolHandleNew(&myPoolHandle, poolHandle, poolHandleSize);
+
+      poolPolicySettingsNew(&myPolicySettings);
+      myPolicySettings.PolicyType      = rspLoadInfo->rli_policy;
+      myPolicySettings.Weight          = rspLoadInfo->rli_weight;
+      myPolicySettings.WeightDPF       = rspLoadInfo->rli_weight_dpf;
+      myPolicySettings.Load            = rspLoadInfo->rli_load;
+      myPolicySettings.LoadDegradation = rspLoadInfo->rli_load_degradation;
+      myPolicySettings.LoadDPF         = rspLoadInfo->rli_load_dpf;
+
+      result = asapInstanceUpdateLoad(gAsapInstance, &myPoolHandle, identifier,
+                                      &myPolicySettings);
+   }
+   else {
+      result = RSPERR_NOT_INITIALIZED;
+      LOG_ERROR
+      fputs("rsplib is not initialized\n", stdlog);
+      LOG_END
+   }
+   return(result);
+}
+
+
+/* ###### Update pool element's load ##################################### */
+unsigned int rsp_pe_update_load(const unsigned char*       poolHandle,
+                                const size_t               poolHandleSize,
+                                const uint32_t             identifier,
+                                const struct rsp_loadinfo* rspLoadInfo)
+{
+   return(rsp_pe_update_load_tags(poolHandle, poolHandleSize, identifier,
+                                  rspLoadInfo, NULL));
+}
+
+
 /* ###### Report pool element failure #################################### */
 unsigned int rsp_pe_failure_tags(const unsigned char* poolHandle,
                                  const size_t         poolHandleSize,
@@ -40,10 +40,23 @@
 #include "sessioncontrol.h"
 #include "componentstatusreporter.h"
 
+#if defined(HAVE_EPOLL) && defined(HAVE_EVENTFD) && defined(HAVE_KERNEL_SCTP)
+#define RSP_EPOLL_SUPPORTED
+#include <stdatomic.h>
+#include <sys/epoll.h>
+
+/* Kernel epoll data: RSerPool socket descriptor, lowest bit set for the
+   notification event FD */
+#define EPOLL_DATA_SOCKET(sd)       ((uint64_t)(sd) << 1)
+#define EPOLL_DATA_NOTIFICATION(sd) (((uint64_t)(sd) << 1) | 1)
+#define EPOLL_DATA_DESCRIPTOR(data) ((int)((data) >> 1))
+
+static _Atomic unsigned long long gEpollWaitSequence = 0;
+#endif
+
 
 extern struct ASAPInstance*      gAsapInstance;
 extern struct Dispatcher         gDispatcher;
-extern struct SimpleRedBlackTree gRSerPoolSocketSet;
 extern struct ThreadSafety       gRSerPoolSocketSetMutex;
 extern struct IdentifierBitmap*  gRSerPoolSocketAllocationBitmap;
 
@@ -56,6 +69,10 @@ extern struct IdentifierBitmap*  gRSerPoolSocketAllocationBitmap;
    }
 
 
+static void removeEpollRegistrations(struct RSerPoolSocket* rserpoolSocket,
+                                     const int              epfd);
+
+
 /* ###### Configure notifications of SCTP socket ############################# */
 static bool configureSCTPSocket(struct RSerPoolSocket* rserpoolSocket,
                                 int                    sd,
@@ -126,7 +143,7 @@ int rsp_socket_internal(int domain, int type, int protocol, int customFD)
    setNonBlocking(fd);
 
    /* ====== Initialize RSerPool socket entry ============================ */
-   rserpoolSocket = (struct RSerPoolSocket*)malloc(sizeof(struct RSerPoolSocket));
+   rserpoolSocket = rserpoolSocketNew();
    if(rserpoolSocket == NULL) {
       close(fd);
       errno = ENOMEM;
@@ -136,7 +153,7 @@ int rsp_socket_internal(int domain, int type, int protocol, int customFD)
    /* ====== Allocate message buffer ===================================== */
    rserpoolSocket->MsgBuffer = messageBufferNew(RSERPOOL_MESSAGE_BUFFER_SIZE, true);
    if(rserpoolSocket->MsgBuffer == NULL) {
-      free(rserpoolSocket);
+      rserpoolSocketFree(rserpoolSocket);
       close(fd);
       errno = ENOMEM;
       return(-1);
@@ -146,18 +163,21 @@ int rsp_socket_internal(int domain, int type, int protocol, int customFD)
    rserpoolSocket->SessionAllocationBitmap = identifierBitmapNew(SESSION_SETSIZE);
    if(rserpoolSocket->SessionAllocationBitmap == NULL) {
       free(rserpoolSocket->MsgBuffer);
-      free(rserpoolSocket);
+      rserpoolSocketFree(rserpoolSocket);
       close(fd);
       errno = ENOMEM;
       return(-1);
    }
    CHECK(identifierBitmapAllocateSpecificID(rserpoolSocket->SessionAllocationBitmap, 0) == 0);
+   /* Delay reuse of session IDs, to avoid confusing a new session with
+      a recently closed one */
+   identifierBitmapSetNextFit(rserpoolSocket->SessionAllocationBitmap, true);
 
    threadSafetyNew(&rserpoolSocket->Mutex, "RSerPoolSocket");
    threadSafetyNew(&rserpoolSocket->SessionSetMutex, "SessionSet");
-   simpleRedBlackTreeNodeNew(&rserpoolSocket->Node);
    sessionStorageNew(&rserpoolSocket->SessionSet);
    rserpoolSocket->Socket                             = fd;
+   rserpoolSocket->EpollRegistrations                 = NULL;
    rserpoolSocket->SocketDomain                       = domain;
    rserpoolSocket->SocketType                         = type;
    rserpoolSocket->SocketProtocol                     = protocol;
@@ -184,7 +204,7 @@ int rsp_socket_internal(int domain, int type, int protocol, int customFD)
    /* ====== Configure SCTP socket ======================================= */
    if(!configureSCTPSocket(rserpoolSocket, fd, 0)) {
       free(rserpoolSocket->MsgBuffer);
-      free(rserpoolSocket);
+      rserpoolSocketFree(rserpoolSocket);
       close(fd);
       return(-1);
    }
@@ -194,7 +214,8 @@ int rsp_socket_internal(int domain, int type, int protocol, int customFD)
    rserpoolSocket->Descriptor = identifierBitmapAllocateID(gRSerPoolSocketAllocationBitmap);
    if(rserpoolSocket->Descriptor >= 0) {
       /* ====== Add RSerPool socket entry ================================ */
-      CHECK(simpleRedBlackTreeInsert(&gRSerPoolSocketSet, &rserpoolSocket->Node) == &rserpoolSocket->Node);
+      atomic_store_explicit(&rserpoolSocket->ReferenceCount, 1, memory_order_relaxed);
+      setRSerPoolSocketForDescriptor(rserpoolSocket->Descriptor, rserpoolSocket);
    }
    threadSafetyUnlock(&gRSerPoolSocketSetMutex);
 
@@ -202,7 +223,7 @@ int rsp_socket_internal(int domain, int type, int protocol, int customFD)
    if(rserpoolSocket->Descriptor < 0) {
       identifierBitmapDelete(rserpoolSocket->SessionAllocationBitmap);
       free(rserpoolSocket->MsgBuffer);
-      free(rserpoolSocket);
+      rserpoolSocketFree(rserpoolSocket);
       close(fd);
       errno = EMFILE;
       return(-1);
@@ -267,9 +288,12 @@ int rsp_close(int sd)
       session = nextSession;
    }
 
+   /* ====== Remove from epoll instances ================================= */
+   removeEpollRegistrations(rserpoolSocket, -1);
+
    /* ====== Delete RSerPool socket entry ================================ */
    threadSafetyLock(&gRSerPoolSocketSetMutex);
-   CHECK(simpleRedBlackTreeRemove(&gRSerPoolSocketSet, &rserpoolSocket->Node) == &rserpoolSocket->Node);
+   setRSerPoolSocketForDescriptor(sd, NULL);
    identifierBitmapFreeID(gRSerPoolSocketAllocationBitmap, sd);
    rserpoolSocket->Descriptor = -1;
    threadSafetyUnlock(&gRSerPoolSocketSetMutex);
@@ -291,8 +315,9 @@ int rsp_close(int sd)
    }
    threadSafetyDelete(&rserpoolSocket->SessionSetMutex);
    threadSafetyUnlock(&rserpoolSocket->Mutex);
-   threadSafetyDelete(&rserpoolSocket->Mutex);
-   free(rserpoolSocket);
+
+   /* Freed here, unless still in use by rsp_poll() or rsp_epoll_wait() */
+   releaseRSerPoolSocket(rserpoolSocket);
    return(0);
 }
 
@@ -309,13 +334,13 @@ int rsp_mapsocket(int sd, int toSD)
    }
 
    /* ====== Initialize RSerPool socket entry ============================ */
-   rserpoolSocket = (struct RSerPoolSocket*)malloc(sizeof(struct RSerPoolSocket));
+   rserpoolSocket = rserpoolSocketNew();
    if(rserpoolSocket == NULL) {
       errno = ENOMEM;
       return(-1);
    }
-   memset(rserpoolSocket, 0, sizeof(struct RSerPoolSocket));
-   rserpoolSocket->Socket = sd;
+   threadSafetyNew(&rserpoolSocket->Mutex, "RSerPoolSocket");
+   rserpoolSocket->Socket         = sd;
    sessionStorageNew(&rserpoolSocket->SessionSet);
    notificationQueueNew(&rserpoolSocket->Notifications);
 
@@ -329,13 +354,15 @@ int rsp_mapsocket(int sd, int toSD)
    }
    if(rserpoolSocket->Descriptor >= 0) {
       /* ====== Add RSerPool socket entry ================================ */
-      CHECK(simpleRedBlackTreeInsert(&gRSerPoolSocketSet, &rserpoolSocket->Node) == &rserpoolSocket->Node);
+      atomic_store_explicit(&rserpoolSocket->ReferenceCount, 1, memory_order_relaxed);
+      setRSerPoolSocketForDescriptor(rserpoolSocket->Descriptor, rserpoolSocket);
    }
    threadSafetyUnlock(&gRSerPoolSocketSetMutex);
 
    /* ====== Has there been a problem? =================================== */
    if(rserpoolSocket->Descriptor < 0) {
-      free(rserpoolSocket);
+      threadSafetyDelete(&rserpoolSocket->Mutex);
+      rserpoolSocketFree(rserpoolSocket);
       errno = EMFILE;
       return(-1);
    }
@@ -351,14 +378,17 @@ int rsp_unmapsocket(int sd)
    GET_RSERPOOL_SOCKET(rserpoolSocket, sd)
 
    if(rserpoolSocket->SessionAllocationBitmap == NULL) {
+      threadSafetyLock(&rserpoolSocket->Mutex);
+      removeEpollRegistrations(rserpoolSocket, -1);
       threadSafetyLock(&gRSerPoolSocketSetMutex);
-      CHECK(simpleRedBlackTreeRemove(&gRSerPoolSocketSet, &rserpoolSocket->Node) == &rserpoolSocket->Node);
+      setRSerPoolSocketForDescriptor(sd, NULL);
       identifierBitmapFreeID(gRSerPoolSocketAllocationBitmap, sd);
       rserpoolSocket->Descriptor = -1;
       threadSafetyUnlock(&gRSerPoolSocketSetMutex);
       sessionStorageDelete(&rserpoolSocket->SessionSet);
       notificationQueueDelete(&rserpoolSocket->Notifications);
-      free(rserpoolSocket);
+      threadSafetyUnlock(&rserpoolSocket->Mutex);
+      releaseRSerPoolSocket(rserpoolSocket);
    }
    else {
       errno = EBADF;
@@ -372,6 +402,7 @@ int rsp_unmapsocket(int sd)
 int rsp_poll(struct pollfd* ufds, unsigned int nfds, int timeout)
 {
    struct RSerPoolSocket* rserpoolSocket;
+   struct RSerPoolSocket* rserpoolSockets[FD_SETSIZE];
    int                    fdbackup[FD_SETSIZE];
    int                    result;
    unsigned int           i;
@@ -383,10 +414,13 @@ int rsp_poll(struct pollfd* ufds, unsigned int nfds, int timeout)
    }
 
    /* ====== Collect data for poll() call ================================ */
+   /* Another thread may close a socket during ext_poll(). Therefore, a
+      reference is held until the results have been handled. */
    result = 0;
    for(i = 0;i < nfds;i++) {
       fdbackup[i] = ufds[i].fd;
-      rserpoolSocket = getRSerPoolSocketForDescriptor(ufds[i].fd);
+      rserpoolSocket = acquireRSerPoolSocketForDescriptor(ufds[i].fd);
+      rserpoolSockets[i] = rserpoolSocket;
       if(rserpoolSocket != NULL) {
          threadSafetyLock(&rserpoolSocket->Mutex);
          ufds[i].fd      = rserpoolSocket->Socket;
@@ -399,6 +433,9 @@ int rsp_poll(struct pollfd* ufds, unsigned int nfds, int timeout)
          threadSafetyUnlock(&rserpoolSocket->Mutex);
       }
       else {
+         LOG_ERROR
+         fprintf(stdlog, "Bad RSerPool socket descriptor %d\n", fdbackup[i]);
+         LOG_END_FATAL
          ufds[i].fd = -1;
       }
    }
@@ -411,32 +448,37 @@ int rsp_poll(struct pollfd* ufds, unsigned int nfds, int timeout)
 
    /* ====== Handle results ============================================== */
    for(i = 0;i < nfds;i++) {
-      rserpoolSocket = getRSerPoolSocketForDescriptor(fdbackup[i]);
-      if((rserpoolSocket != NULL) && (rserpoolSocket->SessionAllocationBitmap != NULL)) {
+      rserpoolSocket = rserpoolSockets[i];
+      if(rserpoolSocket != NULL) {
          threadSafetyLock(&rserpoolSocket->Mutex);
 
-         /* ======= Check for control channel data ======================= */
-         if(ufds[i].revents & POLLIN) {
-            LOG_VERBOSE4
-            fprintf(stdlog, "RSerPool socket %d (socket %d) has <read> flag set -> Check, if it has to be handled by rsplib...\n",
-                     rserpoolSocket->Descriptor, rserpoolSocket->Socket);
-            LOG_END
-            if(handleControlChannelAndNotifications(rserpoolSocket)) {
+         /* Skip mapped system sockets and sockets closed in the meantime */
+         if( (rserpoolSocket->Descriptor >= 0) &&
+             (rserpoolSocket->SessionAllocationBitmap != NULL) ) {
+            /* ======= Check for control channel data ==================== */
+            if(ufds[i].revents & POLLIN) {
                LOG_VERBOSE4
-               fprintf(stdlog, "RSerPool socket %d (socket %d) had <read> event for rsplib only. Clearing <read> flag\n",
+               fprintf(stdlog, "RSerPool socket %d (socket %d) has <read> flag set -> Check, if it has to be handled by rsplib...\n",
                         rserpoolSocket->Descriptor, rserpoolSocket->Socket);
                LOG_END
-               ufds[i].revents &= ~POLLIN;
+               if(handleControlChannelAndNotifications(rserpoolSocket)) {
+                  LOG_VERBOSE4
+                  fprintf(stdlog, "RSerPool socket %d (socket %d) had <read> event for rsplib only. Clearing <read> flag\n",
+                           rserpoolSocket->Descriptor, rserpoolSocket->Socket);
+                  LOG_END
+                  ufds[i].revents &= ~POLLIN;
+               }
             }
-         }
 
-         /* ====== Set <read> flag for RSerPool notifications? =========== */
-         if((ufds[i].events & POLLIN) &&
-            (notificationQueueHasData(&rserpoolSocket->Notifications))) {
-            ufds[i].revents |= POLLIN;
+            /* ====== Set <read> flag for RSerPool notifications? ======== */
+            if((ufds[i].events & POLLIN) &&
+               (notificationQueueHasData(&rserpoolSocket->Notifications))) {
+               ufds[i].revents |= POLLIN;
+            }
          }
 
          threadSafetyUnlock(&rserpoolSocket->Mutex);
+         releaseRSerPoolSocket(rserpoolSocket);
       }
       ufds[i].fd = fdbackup[i];
    }
@@ -503,6 +545,332 @@ int rsp_select(int n, fd_set* readfds, fd_set* writefds, fd_set* exceptfds,
 }
 
 
+/* ###### Find epoll registration of RSerPool socket ##################### */
+#ifdef RSP_EPOLL_SUPPORTED
+static struct EpollRegistration* findEpollRegistration(struct RSerPoolSocket* rserpoolSocket,
+                                                       const int              epfd)
+{
+   struct EpollRegistration* registration = rserpoolSocket->EpollRegistrations;
+
+   while(registration != NULL) {
+      if(registration->EpollFD == epfd) {
+         break;
+      }
+      registration = registration->Next;
+   }
+   return(registration);
+}
+
+
+/* ###### Check, if notifications have to be watched ##################### */
+static bool epollWatchesNotifications(struct RSerPoolSocket* rserpoolSocket,
+                                      const uint32_t         events)
+{
+   /* Mapped system sockets do not get notifications */
+   return((events & EPOLLIN) && (rserpoolSocket->SessionAllocationBitmap != NULL));
+}
+
+
+/* ###### Update kernel epoll entry of notification event FD ############# */
+static int epollUpdateNotifications(struct RSerPoolSocket* rserpoolSocket,
+                                    const int              epfd,
+                                    const uint32_t         oldEvents,
+                                    const uint32_t         newEvents)
+{
+   struct epoll_event kernelEvent;
+   const bool         oldWatch = epollWatchesNotifications(rserpoolSocket, oldEvents);
+   const bool         newWatch = epollWatchesNotifications(rserpoolSocket, newEvents);
+   int                eventFD;
+
+   if(oldWatch == newWatch) {
+      return(0);
+   }
+   eventFD = notificationQueueGetEventFD(&rserpoolSocket->Notifications);
+   if(eventFD < 0) {
+      return(-1);
+   }
+   if(newWatch) {
+      kernelEvent.events   = EPOLLIN;
+      kernelEvent.data.u64 = EPOLL_DATA_NOTIFICATION(rserpoolSocket->Descriptor);
+      return(epoll_ctl(epfd, EPOLL_CTL_ADD, eventFD, &kernelEvent));
+   }
+   return(epoll_ctl(epfd, EPOLL_CTL_DEL, eventFD, NULL));
+}
+#endif
+
+
+/* ###### Remove epoll registrations of RSerPool socket ################## */
+/* The caller has to hold the RSerPool socket's mutex! epfd < 0 removes
+   all registrations. */
+static void removeEpollRegistrations(struct RSerPoolSocket* rserpoolSocket,
+                                     const int              epfd)
+{
+#ifdef RSP_EPOLL_SUPPORTED
+   struct EpollRegistration** registrationPtr = &rserpoolSocket->EpollRegistrations;
+   struct EpollRegistration*  registration;
+
+   while((registration = *registrationPtr) != NULL) {
+      if((epfd < 0) || (registration->EpollFD == epfd)) {
+         epoll_ctl(registration->EpollFD, EPOLL_CTL_DEL, rserpoolSocket->Socket, NULL);
+         epollUpdateNotifications(rserpoolSocket, registration->EpollFD,
+                                  registration->Events, 0);
+         *registrationPtr = registration->Next;
+         free(registration);
+      }
+      else {
+         registrationPtr = &registration->Next;
+      }
+   }
+#endif
+}
+
+
+/* ###### Create epoll instance ########################################## */
+int rsp_epoll_create(int flags)
+{
+#ifdef RSP_EPOLL_SUPPORTED
+   return(epoll_create1(flags));
+#else
+   errno = ENOSYS;
+   return(-1);
+#endif
+}
+
+
+/* ###### Close epoll instance ########################################### */
+int rsp_epoll_close(int epfd)
+{
+#ifdef RSP_EPOLL_SUPPORTED
+   struct RSerPoolSocket*  rserpoolSocket;
+   struct RSerPoolSocket** rserpoolSocketArray = NULL;
+   size_t                  rserpoolSockets     = 0;
+   size_t                  i;
+
+   /* ====== Collect RSerPool sockets ==================================== */
+   /* rsp_close() obtains gRSerPoolSocketSetMutex while holding the
+      RSerPool socket's mutex. To avoid a lock-order inversion, hold a
+      reference to each socket and lock them after releasing the set. */
+   threadSafetyLock(&gRSerPoolSocketSetMutex);
+   rserpoolSocket = getFirstRSerPoolSocket();
+   while(rserpoolSocket != NULL) {
+      rserpoolSockets++;
+      rserpoolSocket = getNextRSerPoolSocket(rserpoolSocket);
+   }
+   if(rserpoolSockets > 0) {
+      rserpoolSocketArray = (struct RSerPoolSocket**)malloc(rserpoolSockets * sizeof(struct RSerPoolSocket*));
+      if(rserpoolSocketArray == NULL) {
+         threadSafetyUnlock(&gRSerPoolSocketSetMutex);
+         errno = ENOMEM;
+         return(-1);
+      }
+      i = 0;
+      rserpoolSocket = getFirstRSerPoolSocket();
+      while(rserpoolSocket != NULL) {
+         holdRSerPoolSocket(rserpoolSocket);
+         rserpoolSocketArray[i++] = rserpoolSocket;
+         rserpoolSocket = getNextRSerPoolSocket(rserpoolSocket);
+      }
+   }
+   threadSafetyUnlock(&gRSerPoolSocketSetMutex);
+
+   /* ====== Remove registrations ======================================== */
+   for(i = 0;i < rserpoolSockets;i++) {
+      threadSafetyLock(&rserpoolSocketArray[i]->Mutex);
+      removeEpollRegistrations(rserpoolSocketArray[i], epfd);
+      threadSafetyUnlock(&rserpoolSocketArray[i]->Mutex);
+      releaseRSerPoolSocket(rserpoolSocketArray[i]);
+   }
+   free(rserpoolSocketArray);
+   return(close(epfd));
+#else
+   errno = ENOSYS;
+   return(-1);
+#endif
+}
+
+
+/* ###### Add, modify or remove RSerPool socket in epoll instance ######## */
+int rsp_epoll_ctl(int epfd, int op, int sd, struct epoll_event* event)
+{
+#ifdef RSP_EPOLL_SUPPORTED
+   struct RSerPoolSocket*    rserpoolSocket;
+   struct EpollRegistration* registration;
+   struct epoll_event        kernelEvent;
+   int                       result = -1;
+
+   GET_RSERPOOL_SOCKET(rserpoolSocket, sd);
+   if( (op != EPOLL_CTL_DEL) &&
+       ( (event == NULL) || (event->events & (EPOLLET|EPOLLONESHOT)) ) ) {
+      errno = EINVAL;
+      return(-1);
+   }
+
+   threadSafetyLock(&rserpoolSocket->Mutex);
+   registration = findEpollRegistration(rserpoolSocket, epfd);
+   switch(op) {
+      case EPOLL_CTL_ADD:
+         if(registration != NULL) {
+            errno = EEXIST;
+            break;
+         }
+         registration = (struct EpollRegistration*)malloc(sizeof(struct EpollRegistration));
+         if(registration == NULL) {
+            errno = ENOMEM;
+            break;
+         }
+         kernelEvent.events   = event->events;
+         kernelEvent.data.u64 = EPOLL_DATA_SOCKET(sd);
+         if(epoll_ctl(epfd, EPOLL_CTL_ADD, rserpoolSocket->Socket, &kernelEvent) < 0) {
+            free(registration);
+            break;
+         }
+         if(epollUpdateNotifications(rserpoolSocket, epfd, 0, event->events) < 0) {
+            epoll_ctl(epfd, EPOLL_CTL_DEL, rserpoolSocket->Socket, NULL);
+            free(registration);
+            break;
+         }
+         registration->EpollFD      = epfd;
+         registration->Events       = event->events;
+         registration->Data         = event->data.u64;
+         registration->WaitSequence = 0;
+         registration->WaitIndex    = 0;
+         registration->Next         = rserpoolSocket->EpollRegistrations;
+         rserpoolSocket->EpollRegistrations = registration;
+         result = 0;
+       break;
+      case EPOLL_CTL_MOD:
+         if(registration == NULL) {
+            errno = ENOENT;
+            break;
+         }
+         kernelEvent.events   = event->events;
+         kernelEvent.data.u64 = EPOLL_DATA_SOCKET(sd);
+         if( (epoll_ctl(epfd, EPOLL_CTL_MOD, rserpoolSocket->Socket, &kernelEvent) < 0) ||
+             (epollUpdateNotifications(rserpoolSocket, epfd,
+                                       registration->Events, event->events) < 0) ) {
+            break;
+         }
+         registration->Events = event->events;
+         registration->Data   = event->data.u64;
+         result = 0;
+       break;
+      case EPOLL_CTL_DEL:
+         if(registration == NULL) {
+            errno = ENOENT;
+            break;
+         }
+         removeEpollRegistrations(rserpoolSocket, epfd);
+         result = 0;
+       break;
+      default:
+         errno = EINVAL;
+       break;
+   }
+   threadSafetyUnlock(&rserpoolSocket->Mutex);
+   return(result);
+#else
+   errno = ENOSYS;
+   return(-1);
+#endif
+}
+
+
+/* ###### Wait for events on RSerPool sockets of epoll instance ########## */
+int rsp_epoll_wait(int                 epfd,
+                   struct epoll_event* events,
+                   int                 maxevents,
+                   int                 timeout)
+{
+#ifdef RSP_EPOLL_SUPPORTED
+   struct RSerPoolSocket*    rserpoolSocket;
+   struct EpollRegistration* registration;
+   struct epoll_event        kernelEvent;
+   unsigned long long        sequence;
+   unsigned long long        now;
+   const unsigned long long  timeoutTimeStamp = (timeout > 0) ? getMicroTime() + (1000ULL * timeout) : 0;
+   uint32_t                  revents;
+   int                       result;
+   int                       ready;
+   int                       i;
+
+   sequence = atomic_fetch_add(&gEpollWaitSequence, 1) + 1;
+   for(;;) {
+      result = epoll_wait(epfd, events, maxevents, timeout);
+      if(result <= 0) {
+         return(result);
+      }
+
+      /* ====== Translate kernel events into RSerPool socket events ====== */
+      /* The results are compacted in-place: entry "ready" is never behind
+         the kernel event currently processed. */
+      ready = 0;
+      for(i = 0;i < result;i++) {
+         kernelEvent    = events[i];
+         rserpoolSocket = acquireRSerPoolSocketForDescriptor(EPOLL_DATA_DESCRIPTOR(kernelEvent.data.u64));
+         if(rserpoolSocket == NULL) {
+            continue;   /* Already closed */
+         }
+
+         threadSafetyLock(&rserpoolSocket->Mutex);
+         /* A socket closed in the meantime has no registrations any more */
+         registration = findEpollRegistration(rserpoolSocket, epfd);
+         if(registration != NULL) {
+            revents = 0;
+            if(kernelEvent.data.u64 == EPOLL_DATA_SOCKET(rserpoolSocket->Descriptor)) {
+               revents = kernelEvent.events;
+               /* ====== Check for control channel data ================= */
+               if( (revents & EPOLLIN) &&
+                   (rserpoolSocket->SessionAllocationBitmap != NULL) &&
+                   (handleControlChannelAndNotifications(rserpoolSocket)) ) {
+                  revents &= ~EPOLLIN;
+               }
+            }
+            /* ====== Set <read> flag for RSerPool notifications? ======== */
+            if( (registration->Events & EPOLLIN) &&
+                (notificationQueueHasData(&rserpoolSocket->Notifications)) ) {
+               revents |= EPOLLIN;
+            }
+
+            if(revents != 0) {
+               if(registration->WaitSequence == sequence) {
+                  /* Socket and notification event FD were both ready */
+                  events[registration->WaitIndex].events |= revents;
+               }
+               else {
+                  registration->WaitSequence = sequence;
+                  registration->WaitIndex    = ready;
+                  events[ready].events       = revents;
+                  events[ready].data.u64     = registration->Data;
+                  ready++;
+               }
+            }
+         }
+         threadSafetyUnlock(&rserpoolSocket->Mutex);
+         releaseRSerPoolSocket(rserpoolSocket);
+      }
+      if(ready > 0) {
+         return(ready);
+      }
+
+      /* ====== Only internal events -> wait for the remaining time ====== */
+      if(timeout > 0) {
+         now = getMicroTime();
+         if(now >= timeoutTimeStamp) {
+            return(0);
+         }
+         timeout = (int)((timeoutTimeStamp - now + 999ULL) / 1000ULL);
+      }
+      else if(timeout == 0) {
+         return(0);
+      }
+   }
+#else
+   errno = ENOSYS;
+   return(-1);
+#endif
+}
+
+
 /* ###### Bind RSerPool socket ########################################### */
 int rsp_bind(int sd, const struct sockaddr* addrs, int addrcnt)
 {
@@ -560,6 +928,7 @@ int rsp_register_tags(int                        sd,
    struct PoolHandle      cmpPoolHandle;
    union sockaddr_union   socketName;
    socklen_t              socketNameLen;
+   bool                   loadUpdateOnly;
    GET_RSERPOOL_SOCKET(rserpoolSocket, sd);
 
    threadSafetyLock(&rserpoolSocket->Mutex);
@@ -602,13 +971,30 @@ int rsp_register_tags(int                        sd,
 
       /* ====== Update registration information ========================== */
       threadSafetyLock(&rserpoolSocket->PoolElement->Mutex);
+      /* If only the policy information has changed, a load update is
+         sufficient. Otherwise, a full reregistration is necessary. Load
+         Update is not part of RFC 5352, so the caller has to request it. */
+      loadUpdateOnly = (flags & REGF_LOADUPDATE) &&
+                       (rserpoolSocket->PoolElement->Identifier != 0x00000000) &&
+                       (rserpoolSocket->PoolElement->LoadInfo.rli_policy == loadinfo->rli_policy) &&
+                       (rserpoolSocket->PoolElement->ReregistrationInterval == reregistrationInterval);
       rserpoolSocket->PoolElement->LoadInfo               = *loadinfo;
       rserpoolSocket->PoolElement->ReregistrationInterval = reregistrationInterval;
       rserpoolSocket->PoolElement->RegistrationLife       = 3 * rserpoolSocket->PoolElement->ReregistrationInterval;
+      if(loadUpdateOnly) {
+         loadUpdateOnly = (rsp_pe_update_load_tags(
+                              (unsigned char*)&rserpoolSocket->PoolElement->Handle.Handle,
+                              rserpoolSocket->PoolElement->Handle.Size,
+                              rserpoolSocket->PoolElement->Identifier,
+                              &rserpoolSocket->PoolElement->LoadInfo,
+                              tags) == RSPERR_OKAY);
+      }
       threadSafetyUnlock(&rserpoolSocket->PoolElement->Mutex);
 
       /* ====== Schedule reregistration as soon as possible ============== */
-      timerRestart(&rserpoolSocket->PoolElement->ReregistrationTimer, 0);
+      if(!loadUpdateOnly) {
+         timerRestart(&rserpoolSocket->PoolElement->ReregistrationTimer, 0);
+      }
    }
 
    /* ====== Registration of a new pool element ========================== */
@@ -1740,11 +2126,11 @@ size_t getSessionStatus(struct ComponentAssociation** caeArray,
 
    /* ====== Obtain locks ================================================ */
    sessions = 0;
-   rserpoolSocket = (struct RSerPoolSocket*)simpleRedBlackTreeGetFirst(&gRSerPoolSocketSet);
+   rserpoolSocket = getFirstRSerPoolSocket();
    while(rserpoolSocket != NULL) {
       threadSafetyLock(&rserpoolSocket->SessionSetMutex);
       sessions += sessionStorageGetElements(&rserpoolSocket->SessionSet);
-      rserpoolSocket = (struct RSerPoolSocket*)simpleRedBlackTreeGetNext(&gRSerPoolSocketSet, &rserpoolSocket->Node);
+      rserpoolSocket = getNextRSerPoolSocket(rserpoolSocket);
    }
 
    /* ====== Get status ================================================== */
@@ -1764,7 +2150,7 @@ size_t getSessionStatus(struct ComponentAssociation** caeArray,
       }
       gotLocation = false;
 
-      rserpoolSocket = (struct RSerPoolSocket*)simpleRedBlackTreeGetFirst(&gRSerPoolSocketSet);
+      rserpoolSocket = getFirstRSerPoolSocket();
       while(rserpoolSocket != NULL) {
          session = sessionStorageGetFirstSession(&rserpoolSocket->SessionSet);
          while(session != NULL) {
@@ -1802,7 +2188,7 @@ size_t getSessionStatus(struct ComponentAssociation** caeArray,
                gotLocation = true;
             }
          }
-         rserpoolSocket = (struct RSerPoolSocket*)simpleRedBlackTreeGetNext(&gRSerPoolSocketSet, &rserpoolSocket->Node);
+         rserpoolSocket = getNextRSerPoolSocket(rserpoolSocket);
       }
 
       if(gotLocation == false) {
@@ -1817,10 +2203,10 @@ size_t getSessionStatus(struct ComponentAssociation** caeArray,
    }
 
    /* ====== Release locks ===============================================*/
-   rserpoolSocket = (struct RSerPoolSocket*)simpleRedBlackTreeGetFirst(&gRSerPoolSocketSet);
+   rserpoolSocket = getFirstRSerPoolSocket();
    while(rserpoolSocket != NULL) {
       threadSafetyUnlock(&rserpoolSocket->SessionSetMutex);
-      rserpoolSocket = (struct RSerPoolSocket*)simpleRedBlackTreeGetNext(&gRSerPoolSocketSet, &rserpoolSocket->Node);
+      rserpoolSocket = getNextRSerPoolSocket(rserpoolSocket);
    }
    threadSafetyUnlock(&gRSerPoolSocketSetMutex);
 
@@ -518,6 +518,8 @@ void registrarHandleASAPDeregistration(struct Registrar*       registrar,
       delPoolNode                      = *(poolElementNode->OwnerPoolNode);
       delPoolElementNode               = *poolElementNode;
       delPoolElementNode.OwnerPoolNode = &delPoolNode;
+      delPoolElementNode.EncodedParameter     = NULL;   /* Owned by original node */
+      delPoolElementNode.EncodedParameterSize = 0;
       delPoolElementNode.RegistratorTransport = transportAddressBlockDuplicate(poolElementNode->RegistratorTransport);
       delPoolElementNode.UserTransport        = transportAddressBlockDuplicate(poolElementNode->UserTransport);
       if((delPoolElementNode.UserTransport != NULL) &&
@@ -598,6 +600,174 @@ void registrarHandleASAPDeregistration(struct Registrar*       registrar,
 }
 
 
+/* ###### Schedule propagation of a PE's new policy information ########## */
+static void registrarScheduleLoadUpdatePropagation(
+               struct Registrar*                 registrar,
+               struct ST_CLASS(PoolElementNode)* poolElementNode)
+{
+   struct RegistrarPendingLoadUpdate* pendingLoadUpdateArray;
+   size_t                             capacity;
+
+   /* ====== PE is already pending -> coalesce updates =================== */
+   if(poolElementNode->Flags & PENF_PENDING) {
+      return;
+   }
+
+   /* ====== Enqueue PE ================================================== */
+   if(registrar->PendingLoadUpdates >= registrar->PendingLoadUpdateCapacity) {
+      capacity = (registrar->PendingLoadUpdateCapacity > 0) ?
+                    2 * registrar->PendingLoadUpdateCapacity : 64;
+      pendingLoadUpdateArray = (struct RegistrarPendingLoadUpdate*)realloc(
+                                  registrar->PendingLoadUpdateArray,
+                                  capacity * sizeof(struct RegistrarPendingLoadUpdate));
+      if(pendingLoadUpdateArray == NULL) {
+         /* Unable to batch -> propagate immediately */
+         registrarSendENRPHandleUpdate(registrar, poolElementNode, PNUP_ADD_PE);
+         return;
+      }
+      registrar->PendingLoadUpdateArray    = pendingLoadUpdateArray;
+      registrar->PendingLoadUpdateCapacity = capacity;
+   }
+   registrar->PendingLoadUpdateArray[registrar->PendingLoadUpdates].Handle     = poolElementNode->OwnerPoolNode->Handle;
+   registrar->PendingLoadUpdateArray[registrar->PendingLoadUpdates].Identifier = poolElementNode->Identifier;
+   registrar->PendingLoadUpdates++;
+   poolElementNode->Flags |= PENF_PENDING;
+
+   if(!timerIsRunning(&registrar->LoadUpdatePropagationTimer)) {
+      timerStart(&registrar->LoadUpdatePropagationTimer,
+                 getMicroTime() + registrar->LoadUpdatePropagationInterval);
+   }
+}
+
+
+/* ###### Propagate pending load updates to peers ######################## */
+void registrarHandleLoadUpdatePropagationTimer(struct Dispatcher* dispatcher,
+                                               struct Timer*      timer,
+                                               void*              userData)
+{
+   struct Registrar*                 registrar = (struct Registrar*)userData;
+   struct ST_CLASS(PoolElementNode)* poolElementNode;
+   size_t                            i;
+
+   LOG_VERBOSE2
+   fprintf(stdlog, "Propagating %u pending load updates\n",
+           (unsigned int)registrar->PendingLoadUpdates);
+   LOG_END
+
+   for(i = 0;i < registrar->PendingLoadUpdates;i++) {
+      /* The PE may have been removed in the meantime */
+      poolElementNode = ST_CLASS(poolHandlespaceManagementFindPoolElement)(
+                           &registrar->Handlespace,
+                           &registrar->PendingLoadUpdateArray[i].Handle,
+                           registrar->PendingLoadUpdateArray[i].Identifier);
+      if((poolElementNode != NULL) && (poolElementNode->Flags & PENF_PENDING)) {
+         poolElementNode->Flags &= ~PENF_PENDING;
+         registrarSendENRPHandleUpdate(registrar, poolElementNode, PNUP_ADD_PE);
+#ifdef ENABLE_REGISTRAR_STATISTICS
+         registrar->Stats.LoadUpdatePropagationCount++;
+#endif
+      }
+   }
+   registrar->PendingLoadUpdates = 0;
+}
+
+
+/* ###### Handle ASAP Load Update ######################################## */
+void registrarHandleASAPLoadUpdate(struct Registrar*       registrar,
+                                   const int               fd,
+                                   const sctp_assoc_t      assocID,
+                                   struct RSerPoolMessage* message)
+{
+   struct ST_CLASS(PoolElementNode)* poolElementNode;
+   struct PoolPolicySettings         updatedPolicySettings;
+
+   LOG_VERBOSE2
+   fputs("Load update for ", stdlog);
+   poolHandlePrint(&message->Handle, stdlog);
+   fprintf(stdlog, "/$%08x\n", message->Identifier);
+   LOG_END
+
+   /* The Load Update is answered by a Registration Response. In case of
+      rejection, the PE falls back to a full reregistration. */
+   message->Type  = AHT_REGISTRATION_RESPONSE;
+   message->Flags = 0x00;
+   message->Error = RSPERR_OKAY;
+
+   /* ====== Only the PE's own association may update it ================= */
+   poolElementNode = ST_CLASS(poolHandlespaceManagementFindPoolElement)(
+                        &registrar->Handlespace,
+                        &message->Handle,
+                        message->Identifier);
+   if(poolElementNode == NULL) {
+      LOG_VERBOSE
+      fprintf(stdlog, "Load update for non-existing pool element $%08x of pool ",
+              message->Identifier);
+      poolHandlePrint(&message->Handle, stdlog);
+      fputs(" -> rejecting it\n", stdlog);
+      LOG_END
+      message->Error = RSPERR_NOT_FOUND;
+   }
+   else if((poolElementNode->ConnectionSocketDescriptor != fd) ||
+           (poolElementNode->ConnectionAssocID != assocID)) {
+      LOG_WARNING
+      fprintf(stdlog, "Load update for pool element $%08x of pool ",
+              message->Identifier);
+      poolHandlePrint(&message->Handle, stdlog);
+      fprintf(stdlog, " from foreign assoc %u -> rejecting it\n",
+              (unsigned int)assocID);
+      LOG_END
+      message->Error = RSPERR_INVALID_REGISTRATOR;
+   }
+
+   /* ====== Update policy information =================================== */
+   else {
+      /* The distance has been obtained upon registration */
+      updatedPolicySettings          = message->PolicySettings;
+      updatedPolicySettings.Distance = poolElementNode->PolicySettings.Distance;
+      message->Error = ST_CLASS(poolHandlespaceManagementUpdatePoolElementPolicySettings)(
+                          &registrar->Handlespace,
+                          poolElementNode,
+                          &updatedPolicySettings,
+                          getMicroTime());
+      if(message->Error == RSPERR_OKAY) {
+#ifdef ENABLE_REGISTRAR_STATISTICS
+         registrar->Stats.LoadUpdateCount++;
+#endif
+         /* ====== Send update to peers ================================= */
+         if(poolElementNode->Flags & PENF_UPDATED) {
+            if(registrar->LoadUpdatePropagationInterval > 0) {
+               registrarScheduleLoadUpdatePropagation(registrar, poolElementNode);
+            }
+            else {
+               registrarSendENRPHandleUpdate(registrar, poolElementNode, PNUP_ADD_PE);
+            }
+         }
+      }
+      else {
+         LOG_WARNING
+         fprintf(stdlog, "Failed to update load of pool element $%08x of pool ",
+                 message->Identifier);
+         poolHandlePrint(&message->Handle, stdlog);
+         fputs(": ", stdlog);
+         rserpoolErrorPrint(message->Error, stdlog);
+         fputs("\n", stdlog);
+         LOG_END
+      }
+   }
+
+   /* ====== Send response =============================================== */
+   if(message->Error != RSPERR_OKAY) {
+      message->Flags |= AHF_REGISTRATION_REJECT;
+   }
+   if(rserpoolMessageSend(IPPROTO_SCTP, fd, assocID, 0, 0, 0, message) == false) {
+      LOG_WARNING
+      logerror("Sending RegistrationResponse for load update failed");
+      LOG_END
+      sendabort(fd, assocID);
+   }
+}
+
+
 /* ###### Handle ASAP Handle Resolution ################################## */
 void registrarHandleASAPHandleResolution(struct Registrar*       registrar,
                                          const int               fd,
@@ -26,6 +26,12 @@
  * Contact: thomas.dreibholz@gmail.com
  */
 
+#ifdef HAVE_RECVMMSG
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   /* for recvmmsg() */
+#endif
+#endif
+
 #include "rspregistrar.h"
 
 
@@ -37,6 +43,7 @@ void registrarDumpHandlespace(struct Registrar* registrar)
    fputs("\n", stdlog);
    ST_CLASS(poolHandlespaceManagementPrint)(&registrar->Handlespace, stdlog,
             PNNPO_POOLS_INDEX|PNNPO_POOLS_SELECTION|PNNPO_POOLS_TIMER|PENPO_USERTRANSPORT|PENPO_POLICYINFO|PENPO_POLICYSTATE|PENPO_UR_REPORTS|PENPO_HOME_PR);
+   ST_CLASS(poolHandlespaceManagementPrintAllocatorStatistics)(&registrar->Handlespace, stdlog);
    fputs("**********************************************\n", stdlog);
 }
 
@@ -103,6 +110,9 @@ void registrarHandleMessage(struct Registrar*       registrar,
          case AHT_DEREGISTRATION:
             registrarHandleASAPDeregistration(registrar, sd, message->AssocID, message);
           break;
+         case AHT_LOAD_UPDATE:
+            registrarHandleASAPLoadUpdate(registrar, sd, message->AssocID, message);
+          break;
          case AHT_ENDPOINT_KEEP_ALIVE_ACK:
             registrarHandleASAPEndpointKeepAliveAck(registrar, sd, message->AssocID, message);
           break;
@@ -167,24 +177,238 @@ void registrarHandleMessage(struct Registrar*       registrar,
 }
 
 
+/* ###### Handle received packet ######################################### */
+static void registrarHandlePacket(struct Registrar*     registrar,
+                                  const int             fd,
+                                  char*                 buffer,
+                                  const size_t          bufferSize,
+                                  const ssize_t         received,
+                                  const int             flags,
+                                  union sockaddr_union* remoteAddress,
+                                  uint32_t              ppid,
+                                  const sctp_assoc_t    assocID)
+{
+   struct RSerPoolMessage*  message;
+   union sctp_notification* notification;
+   unsigned int             result;
+
+   if(!(flags & MSG_NOTIFICATION)) {
+      if(!( (((ppid == PPID_ASAP) && (fd != registrar->ASAPSocket)) ||
+             ((ppid == PPID_ENRP) && (fd != registrar->ENRPUnicastSocket))) )) {
+
+         if(fd == registrar->ENRPMulticastInputSocket) {
+            /* ENRP via UDP -> Set PPID so that rserpoolPacket2Message can
+               correctly decode the packet */
+            ppid = PPID_ENRP;
+         }
+
+         result = rserpoolPacket2Message(buffer,
+                                         remoteAddress, assocID, ppid,
+                                         received, bufferSize, &message);
+         if(message != NULL) {
+            if((result == RSPERR_OKAY) && (message->Error == RSPERR_OKAY)) {
+               message->BufferAutoDelete = false;
+               LOG_VERBOSE3
+               fprintf(stdlog, "Got %u bytes message from ", (unsigned int)message->BufferSize);
+               fputaddress((struct sockaddr*)remoteAddress, true, stdlog);
+               fprintf(stdlog, ", assoc #%u, PPID $%x\n",
+                        (unsigned int)message->AssocID, message->PPID);
+               LOG_END
+
+               registrarHandleMessage(registrar, message, fd);
+            }
+            else if( (message->Error != RSPERR_UNRECOGNIZED_PARAMETER_SILENT) &&
+                     ( (fd == registrar->ASAPSocket) || (fd == registrar->ENRPUnicastSocket) ) &&
+                     (message->Type != AHT_ERROR) &&
+                     (message->Type != EHT_ERROR) ) {
+               LOG_WARNING
+               fprintf(stdlog, "Sending %s Error message in reply to message type $%02x: ",
+                       (message->PPID == PPID_ASAP) ? "ASAP" : "ENRP",
+                       message->Type & 0xff);
+               rserpoolErrorPrint(message->Error, stdlog);
+               fputs("\n", stdlog);
+               LOG_END
+               if((ppid == PPID_ASAP) || (ppid == PPID_ENRP)) {
+                  if(message->OffendingParameterTLV) {
+                     message->ErrorCauseParameterTLV           = (char*)memdup(message->OffendingParameterTLV, message->OffendingParameterTLVLength);
+                     message->ErrorCauseParameterTLVLength     = message->OffendingParameterTLVLength;
+                     message->ErrorCauseParameterTLVAutoDelete = true;
+                  }
+
+                  /* For ASAP or ENRP messages, we can reply
+                     error message */
+                  if(message->PPID == PPID_ASAP) {
+                     message->Type = AHT_ERROR;
+                  }
+                  else if(message->PPID == PPID_ENRP) {
+                     message->Type = EHT_ERROR;
+                  }
+                  rserpoolMessageSend(IPPROTO_SCTP,
+                                      fd, assocID, 0, 0, 0, message);
+               }
+            }
+            rserpoolMessageDelete(message);
+         }
+      }
+      else {
+         LOG_WARNING
+         fprintf(stdlog, "Received PPID $%08x on wrong socket -> Sending ABORT to assoc %u!\n",
+                 ppid, (unsigned int)assocID);
+         LOG_END
+         sendabort(fd, assocID);
+      }
+   }
+   else {
+      notification = (union sctp_notification*)buffer;
+      switch(notification->sn_header.sn_type) {
+         case SCTP_ASSOC_CHANGE:
+            if(notification->sn_assoc_change.sac_state == SCTP_COMM_LOST) {
+               LOG_ACTION
+               fprintf(stdlog, "Association communication lost for socket %d, assoc %u\n",
+                       registrar->ASAPSocket,
+                       (unsigned int)notification->sn_assoc_change.sac_assoc_id);
+
+               LOG_END
+               registrarRemovePoolElementsOfConnection(registrar, fd,
+                                                       notification->sn_assoc_change.sac_assoc_id);
+            }
+            else if(notification->sn_assoc_change.sac_state == SCTP_SHUTDOWN_COMP) {
+               LOG_ACTION
+               fprintf(stdlog, "Association shutdown completed for socket %d, assoc %u\n",
+                       registrar->ASAPSocket,
+                       (unsigned int)notification->sn_assoc_change.sac_assoc_id);
+
+               LOG_END
+               registrarRemovePoolElementsOfConnection(registrar, fd,
+                                                       notification->sn_assoc_change.sac_assoc_id);
+            }
+            break;
+         case SCTP_SHUTDOWN_EVENT:
+            LOG_ACTION
+            fprintf(stdlog, "Shutdown event for socket %d, assoc %u\n",
+                    registrar->ASAPSocket,
+                    (unsigned int)notification->sn_shutdown_event.sse_assoc_id);
+
+            LOG_END
+            registrarRemovePoolElementsOfConnection(registrar, fd,
+                                                    notification->sn_shutdown_event.sse_assoc_id);
+            break;
+      }
+   }
+}
+
+
+/* ###### Read and handle one message #################################### */
+static ssize_t registrarReadMessage(struct Registrar*     registrar,
+                                    const int             fd,
+                                    struct MessageBuffer* messageBuffer)
+{
+   union sockaddr_union remoteAddress;
+   socklen_t            remoteAddressLength;
+   int                  flags;
+   uint32_t             ppid;
+   sctp_assoc_t         assocID;
+   unsigned short       streamID;
+   ssize_t              received;
+
+   flags               = 0;
+   remoteAddressLength = sizeof(remoteAddress);
+   received = messageBufferRead(messageBuffer, fd, &flags,
+                                (struct sockaddr*)&remoteAddress,
+                                &remoteAddressLength,
+                                &ppid, &assocID, &streamID, 0);
+   if(received > 0) {
+      registrarHandlePacket(registrar, fd,
+                            messageBuffer->Buffer, messageBuffer->BufferSize,
+                            received, flags, &remoteAddress, ppid, assocID);
+   }
+   return(received);
+}
+
+
+#ifdef HAVE_RECVMMSG
+/* ###### Read and handle a batch of UDP messages via recvmmsg() ######### */
+static ssize_t registrarReadUDPMessages(struct Registrar*   registrar,
+                                        const int           fd,
+                                        const unsigned int  maxMessages,
+                                        unsigned int*       messages)
+{
+   struct mmsghdr       msgs[REGISTRAR_UDP_BATCH_SIZE];
+   struct iovec         iov[REGISTRAR_UDP_BATCH_SIZE];
+   union sockaddr_union remoteAddress[REGISTRAR_UDP_BATCH_SIZE];
+   unsigned int         batchSize;
+   unsigned int         i;
+   int                  received;
+
+   batchSize = min(maxMessages, REGISTRAR_UDP_BATCH_SIZE);
+   CHECK(batchSize > 0);
+   for(i = 0;i < batchSize;i++) {
+      iov[i].iov_base                = &registrar->UDPBatchBuffer[i * REGISTRAR_RSERPOOL_MESSAGE_BUFFER_SIZE];
+      iov[i].iov_len                 = REGISTRAR_RSERPOOL_MESSAGE_BUFFER_SIZE;
+      msgs[i].msg_hdr.msg_name       = &remoteAddress[i];
+      msgs[i].msg_hdr.msg_namelen    = sizeof(remoteAddress[i]);
+      msgs[i].msg_hdr.msg_iov        = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen     = 1;
+      msgs[i].msg_hdr.msg_control    = NULL;
+      msgs[i].msg_hdr.msg_controllen = 0;
+      msgs[i].msg_hdr.msg_flags      = 0;
+      msgs[i].msg_len                = 0;
+   }
+
+   received = recvmmsg(fd, (struct mmsghdr*)&msgs, batchSize, MSG_DONTWAIT, NULL);
+   for(i = 0;i < (unsigned int)max(received, 0);i++) {
+      if(msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+         LOG_WARNING
+         fprintf(stdlog, "Dropping truncated %u bytes UDP message\n", msgs[i].msg_len);
+         LOG_END
+         continue;
+      }
+      registrarHandlePacket(registrar, fd,
+                            (char*)iov[i].iov_base, REGISTRAR_RSERPOOL_MESSAGE_BUFFER_SIZE,
+                            msgs[i].msg_len, 0, &remoteAddress[i], 0, 0);
+   }
+   *messages = (unsigned int)max(received, 0);
+   return((received < 0) ? MBRead_Error : received);
+}
+#endif
+
+
+#ifdef ENABLE_REGISTRAR_STATISTICS
+/* ###### Update message intake statistics ############################### */
+static void registrarUpdateIntakeStatistics(struct Registrar*  registrar,
+                                            const unsigned int messages,
+                                            const bool         budgetExhausted)
+{
+   registrar->Stats.IntakeWakeupCount++;
+   registrar->Stats.IntakeMessageCount += messages;
+   if(messages > registrar->Stats.IntakeMaxBatchSize) {
+      registrar->Stats.IntakeMaxBatchSize = messages;
+   }
+   if(messages == 0) {
+      registrar->Stats.IntakeEmptyWakeupCount++;
+   }
+   if(budgetExhausted) {
+      registrar->Stats.IntakeBudgetExhaustedCount++;
+   }
+}
+#endif
+
+
 /* ###### Handle events on sockets ####################################### */
 void registrarHandleSocketEvent(struct Dispatcher* dispatcher,
                                 int                fd,
                                 unsigned int       eventMask,
                                 void*              userData)
 {
-   struct Registrar*        registrar = (struct Registrar*)userData;
-   struct RSerPoolMessage*  message;
-   union sctp_notification* notification;
-   union sockaddr_union     remoteAddress;
-   socklen_t                remoteAddressLength;
-   struct MessageBuffer*    messageBuffer;
-   int                      flags;
-   uint32_t                 ppid;
-   sctp_assoc_t             assocID;
-   unsigned short           streamID;
-   ssize_t                  received;
-   unsigned int             result;
+   struct Registrar*     registrar = (struct Registrar*)userData;
+   struct MessageBuffer* messageBuffer;
+   unsigned int          messages;
+   unsigned int          reads;
+#ifdef HAVE_RECVMMSG
+   unsigned int          requested;
+   unsigned int          batch;
+#endif
+   ssize_t               received;
 
    CHECK((fd == registrar->ASAPSocket) ||
          (fd == registrar->ENRPUnicastSocket) ||
@@ -203,120 +427,48 @@ void registrarHandleSocketEvent(struct Dispatcher* dispatcher,
       messageBuffer = registrar->UDPMessageBuffer;
    }
 
-   flags               = 0;
-   remoteAddressLength = sizeof(remoteAddress);
-   received = messageBufferRead(messageBuffer, fd, &flags,
-                                (struct sockaddr*)&remoteAddress,
-                                &remoteAddressLength,
-                                &ppid, &assocID, &streamID, 0);
-   if(received > 0) {
-      if(!(flags & MSG_NOTIFICATION)) {
-         if(!( (((ppid == PPID_ASAP) && (fd != registrar->ASAPSocket)) ||
-                ((ppid == PPID_ENRP) && (fd != registrar->ENRPUnicastSocket))) )) {
-
-            if(fd == registrar->ENRPMulticastInputSocket) {
-               /* ENRP via UDP -> Set PPID so that rserpoolPacket2Message can
-                  correctly decode the packet */
-               ppid = PPID_ENRP;
-            }
-
-            result = rserpoolPacket2Message(messageBuffer->Buffer,
-                                            &remoteAddress, assocID, ppid,
-                                            received, messageBuffer->BufferSize, &message);
-            if(message != NULL) {
-               if((result == RSPERR_OKAY) && (message->Error == RSPERR_OKAY)) {
-                  message->BufferAutoDelete = false;
-                  LOG_VERBOSE3
-                  fprintf(stdlog, "Got %u bytes message from ", (unsigned int)message->BufferSize);
-                  fputaddress((struct sockaddr*)&remoteAddress, true, stdlog);
-                  fprintf(stdlog, ", assoc #%u, PPID $%x\n",
-                           (unsigned int)message->AssocID, message->PPID);
-                  LOG_END
-
-                  registrarHandleMessage(registrar, message, fd);
-               }
-               else if( (message->Error != RSPERR_UNRECOGNIZED_PARAMETER_SILENT) &&
-                        ( (fd == registrar->ASAPSocket) || (fd == registrar->ENRPUnicastSocket) ) &&
-                        (message->Type != AHT_ERROR) &&
-                        (message->Type != EHT_ERROR) ) {
-                  LOG_WARNING
-                  fprintf(stdlog, "Sending %s Error message in reply to message type $%02x: ",
-                          (message->PPID == PPID_ASAP) ? "ASAP" : "ENRP",
-                          message->Type & 0xff);
-                  rserpoolErrorPrint(message->Error, stdlog);
-                  fputs("\n", stdlog);
-                  LOG_END
-                  if((ppid == PPID_ASAP) || (ppid == PPID_ENRP)) {
-                     if(message->OffendingParameterTLV) {
-                        message->ErrorCauseParameterTLV           = (char*)memdup(message->OffendingParameterTLV, message->OffendingParameterTLVLength);
-                        message->ErrorCauseParameterTLVLength     = message->OffendingParameterTLVLength;
-                        message->ErrorCauseParameterTLVAutoDelete = true;
-                     }
-
-                     /* For ASAP or ENRP messages, we can reply
-                        error message */
-                     if(message->PPID == PPID_ASAP) {
-                        message->Type = AHT_ERROR;
-                     }
-                     else if(message->PPID == PPID_ENRP) {
-                        message->Type = EHT_ERROR;
-                     }
-                     rserpoolMessageSend(IPPROTO_SCTP,
-                                         fd, assocID, 0, 0, 0, message);
-                  }
-               }
-               rserpoolMessageDelete(message);
-            }
-         }
-         else {
-            LOG_WARNING
-            fprintf(stdlog, "Received PPID $%08x on wrong socket -> Sending ABORT to assoc %u!\n",
-                    ppid, (unsigned int)assocID);
-            LOG_END
-            sendabort(fd, assocID);
+   /* ====== Read messages until EAGAIN or budget is exhausted ========== */
+   messages = 0;
+   reads    = 0;
+   while(reads < registrar->MaxMessagesPerWakeup) {
+#ifdef HAVE_RECVMMSG
+      if( (fd == registrar->ENRPMulticastInputSocket) &&
+          (registrar->UDPBatchBuffer != NULL) ) {
+         requested = min(registrar->MaxMessagesPerWakeup - reads,
+                         REGISTRAR_UDP_BATCH_SIZE);
+         received  = registrarReadUDPMessages(registrar, fd, requested, &batch);
+         reads    += max(batch, 1);
+         messages += batch;
+         if(batch == requested) {
+            continue;   /* Full batch -> the socket may have more messages */
          }
       }
-      else {
-         notification = (union sctp_notification*)messageBuffer->Buffer;
-         switch(notification->sn_header.sn_type) {
-            case SCTP_ASSOC_CHANGE:
-               if(notification->sn_assoc_change.sac_state == SCTP_COMM_LOST) {
-                  LOG_ACTION
-                  fprintf(stdlog, "Association communication lost for socket %d, assoc %u\n",
-                          registrar->ASAPSocket,
-                          (unsigned int)notification->sn_assoc_change.sac_assoc_id);
-
-                  LOG_END
-                  registrarRemovePoolElementsOfConnection(registrar, fd,
-                                                          notification->sn_assoc_change.sac_assoc_id);
-               }
-               else if(notification->sn_assoc_change.sac_state == SCTP_SHUTDOWN_COMP) {
-                  LOG_ACTION
-                  fprintf(stdlog, "Association shutdown completed for socket %d, assoc %u\n",
-                          registrar->ASAPSocket,
-                          (unsigned int)notification->sn_assoc_change.sac_assoc_id);
-
-                  LOG_END
-                  registrarRemovePoolElementsOfConnection(registrar, fd,
-                                                          notification->sn_assoc_change.sac_assoc_id);
-               }
-               break;
-            case SCTP_SHUTDOWN_EVENT:
-               LOG_ACTION
-               fprintf(stdlog, "Shutdown event for socket %d, assoc %u\n",
-                       registrar->ASAPSocket,
-                       (unsigned int)notification->sn_shutdown_event.sse_assoc_id);
-
-               LOG_END
-               registrarRemovePoolElementsOfConnection(registrar, fd,
-                                                       notification->sn_shutdown_event.sse_assoc_id);
-               break;
+      else
+#endif
+      {
+         received = registrarReadMessage(registrar, fd, messageBuffer);
+         reads++;
+         if(received > 0) {
+            messages++;
+            continue;
+         }
+         else if(received == MBRead_Partial) {
+            continue;
          }
       }
+      if( (received < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) ) {
+         LOG_WARNING
+         logerror("Unable to read from registrar socket");
+         LOG_END
+      }
+      break;
    }
-   else if(received != MBRead_Partial) {
-      LOG_WARNING
-      logerror("Unable to read from registrar socket");
-      LOG_END
-   }
+
+   LOG_VERBOSE3
+   fprintf(stdlog, "Handled %u message(s) from socket %d\n", messages, fd);
+   LOG_END
+#ifdef ENABLE_REGISTRAR_STATISTICS
+   registrarUpdateIntakeStatistics(registrar, messages,
+                                   (reads >= registrar->MaxMessagesPerWakeup));
+#endif
 }
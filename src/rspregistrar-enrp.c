@@ -382,90 +382,101 @@ void registrarSendENRPHandleUpdate(struct Registrar*                 registrar,
    struct ST_CLASS(PeerListNode)* peerListNode;
 #endif
    struct ST_CLASS(PeerListNode)* betterPeerListNode = NULL;
-   struct RSerPoolMessage*        message;
+   struct RSerPoolMessage*        message = registrar->HandleUpdateMessage;
+   size_t                         messageLength;
+
+   rserpoolMessageClearAll(message);
+   message->Type                     = EHT_HANDLE_UPDATE;
+   message->Flags                    = 0x00;
+   message->Action                   = action;
+   message->SenderID                 = registrar->ServerID;
+   message->Handle                   = poolElementNode->OwnerPoolNode->Handle;
+   message->PoolElementPtr           = poolElementNode;
+   message->PoolElementPtrAutoDelete = false;
 
-   message = rserpoolMessageNew(NULL, 65536);
-   if(message != NULL) {
-      message->Type                     = EHT_HANDLE_UPDATE;
-      message->Flags                    = 0x00;
-      message->Action                   = action;
-      message->SenderID                 = registrar->ServerID;
-      message->Handle                   = poolElementNode->OwnerPoolNode->Handle;
-      message->PoolElementPtr           = poolElementNode;
-      message->PoolElementPtrAutoDelete = false;
-
-      LOG_VERBOSE
-      fputs("Sending HandleUpdate for ", stdlog);
-      poolHandlePrint(&poolElementNode->OwnerPoolNode->Handle, stdlog);
-      fprintf(stdlog, "/$%08x, action $%04x\n", poolElementNode->Identifier, action);
-      LOG_END
-      LOG_VERBOSE2
-      fputs("Updated pool element: ", stdlog);
-      ST_CLASS(poolElementNodePrint)(poolElementNode, stdlog, PENPO_FULL);
-      fputs("\n", stdlog);
-      LOG_END
+   LOG_VERBOSE
+   fputs("Sending HandleUpdate for ", stdlog);
+   poolHandlePrint(&poolElementNode->OwnerPoolNode->Handle, stdlog);
+   fprintf(stdlog, "/$%08x, action $%04x\n", poolElementNode->Identifier, action);
+   LOG_END
+   LOG_VERBOSE2
+   fputs("Updated pool element: ", stdlog);
+   ST_CLASS(poolElementNodePrint)(poolElementNode, stdlog, PENPO_FULL);
+   fputs("\n", stdlog);
+   LOG_END
 
-      /* ====== Takeover suggestion ====================================== */
-      if( (action == PNUP_ADD_PE) &&
-          (registrar->ENRPSupportTakeoverSuggestion) &&
-          (poolElementNode->HomeRegistrarIdentifier == registrar->ServerID) ) {
-         betterPeerListNode = ST_CLASS(peerListManagementGetUsefulPeerForPE)(&registrar->Peers, poolElementNode->Identifier);
-         if(betterPeerListNode) {
-            LOG_ACTION
-            fprintf(stdlog, "Found better peer $%08x for PE $%08x\n",
-                    betterPeerListNode->Identifier, poolElementNode->Identifier);
-            LOG_END
-         }
+   /* ====== Takeover suggestion ========================================= */
+   if( (action == PNUP_ADD_PE) &&
+       (registrar->ENRPSupportTakeoverSuggestion) &&
+       (poolElementNode->HomeRegistrarIdentifier == registrar->ServerID) ) {
+      betterPeerListNode = ST_CLASS(peerListManagementGetUsefulPeerForPE)(&registrar->Peers, poolElementNode->Identifier);
+      if(betterPeerListNode) {
+         LOG_ACTION
+         fprintf(stdlog, "Found better peer $%08x for PE $%08x\n",
+                 betterPeerListNode->Identifier, poolElementNode->Identifier);
+         LOG_END
       }
-      /* ================================================================= */
+   }
+   /* ==================================================================== */
 
 #ifdef ENABLE_REGISTRAR_STATISTICS
-      registrarWriteActionLog(registrar, "Send", "ENRP", "Update", ((message->Action == PNUP_ADD_PE) ? "AddPE" : "DelPE"), 0, 0, 0,
-                              &message->Handle, message->PoolElementPtr->Identifier, message->SenderID, message->ReceiverID, 0, 0);
+   registrarWriteActionLog(registrar, "Send", "ENRP", "Update", ((message->Action == PNUP_ADD_PE) ? "AddPE" : "DelPE"), 0, 0, 0,
+                           &message->Handle, message->PoolElementPtr->Identifier, message->SenderID, message->ReceiverID, 0, 0);
 #endif
 
+   /* ====== Create packet only once ===================================== */
+   /* The packets for the peers only differ in the receiver ID. */
+   messageLength = rserpoolMessage2Packet(message);
+   if(messageLength == 0) {
+      LOG_ERROR
+      fputs("Unable to create HandleUpdate packet\n", stdlog);
+      LOG_END
+      return;
+   }
+
 #ifndef MSG_SEND_TO_ALL
-      peerListNode = ST_CLASS(peerListManagementGetFirstPeerListNodeFromIndexStorage)(&registrar->Peers);
-      while(peerListNode != NULL) {
-         message->ReceiverID   = peerListNode->Identifier;
-         message->AddressArray = peerListNode->AddressBlock->AddressArray;
-         message->Addresses    = peerListNode->AddressBlock->Addresses;
-         LOG_VERBOSE
-         fprintf(stdlog, "Sending HandleUpdate to unicast peer $%08x...\n",
-                 peerListNode->Identifier);
-         LOG_END
-         rserpoolMessageSend(IPPROTO_SCTP,
-                             registrar->ENRPUnicastSocket,
-                             0, 0, 0, 0,
-                             message);
-         peerListNode = ST_CLASS(peerListManagementGetNextPeerListNodeFromIndexStorage)(
-                           &registrar->Peers, peerListNode);
-      }
+   peerListNode = ST_CLASS(peerListManagementGetFirstPeerListNodeFromIndexStorage)(&registrar->Peers);
+   while(peerListNode != NULL) {
+      rserpoolMessageSetENRPReceiverID(message, messageLength, peerListNode->Identifier);
+      message->AddressArray = peerListNode->AddressBlock->AddressArray;
+      message->Addresses    = peerListNode->AddressBlock->Addresses;
+      LOG_VERBOSE
+      fprintf(stdlog, "Sending HandleUpdate to unicast peer $%08x...\n",
+              peerListNode->Identifier);
+      LOG_END
+      rserpoolMessageSendPacket(IPPROTO_SCTP,
+                                registrar->ENRPUnicastSocket,
+                                0, 0, 0, 0,
+                                message, messageLength);
+      peerListNode = ST_CLASS(peerListManagementGetNextPeerListNodeFromIndexStorage)(
+                        &registrar->Peers, peerListNode);
+   }
 #else
 #warning Using MSG_SEND_TO_ALL!
-      rserpoolMessageSend(IPPROTO_SCTP,
-                          registrar->ENRPUnicastSocket,
-                          0,
-                          MSG_SEND_TO_ALL, 0, 0, message);
-#endif
-
-      if(betterPeerListNode) {
-         message->Flags |= EHF_TAKEOVER_SUGGESTED;
-         message->ReceiverID   = betterPeerListNode->Identifier;
-         message->AddressArray = betterPeerListNode->AddressBlock->AddressArray;
-         message->Addresses    = betterPeerListNode->AddressBlock->Addresses;
-         LOG_VERBOSE1
-         fprintf(stdlog, "Sending HandleUpdate to unicast peer $%08x with TakeoverSuggested flag...\n",
-                 betterPeerListNode->Identifier);
-         LOG_END
-         rserpoolMessageSend(IPPROTO_SCTP,
+   rserpoolMessageSendPacket(IPPROTO_SCTP,
                              registrar->ENRPUnicastSocket,
-                             0, 0, 0, 0,
-                             message);
-      }
+                             0,
+                             MSG_SEND_TO_ALL, 0, 0,
+                             message, messageLength);
+#endif
 
-      rserpoolMessageDelete(message);
+   if(betterPeerListNode) {
+      message->Flags |= EHF_TAKEOVER_SUGGESTED;
+      message->ReceiverID   = betterPeerListNode->Identifier;
+      message->AddressArray = betterPeerListNode->AddressBlock->AddressArray;
+      message->Addresses    = betterPeerListNode->AddressBlock->Addresses;
+      LOG_VERBOSE1
+      fprintf(stdlog, "Sending HandleUpdate to unicast peer $%08x with TakeoverSuggested flag...\n",
+              betterPeerListNode->Identifier);
+      LOG_END
+      rserpoolMessageSend(IPPROTO_SCTP,
+                          registrar->ENRPUnicastSocket,
+                          0, 0, 0, 0,
+                          message);
    }
+
+   /* Do not keep a reference to the PE in the reused message */
+   message->PoolElementPtr = NULL;
 }
 
 
@@ -537,7 +548,7 @@ void registrarSendENRPListRequest(struct Registrar*           registrar,
 {
    struct RSerPoolMessage* message;
 
-   message = rserpoolMessageNew(NULL, 65536);
+   message = rserpoolMessageNew(NULL, RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE);
    if(message) {
       message->Type         = EHT_LIST_REQUEST;
       message->PPID         = PPID_ENRP;
@@ -747,7 +758,7 @@ void registrarSendENRPHandleTableRequest(struct Registrar*           registrar,
 {
    struct RSerPoolMessage* message;
 
-   message = rserpoolMessageNew(NULL, 65536);
+   message = rserpoolMessageNew(NULL, RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE);
    if(message) {
       message->Type         = EHT_HANDLE_TABLE_REQUEST;
       message->PPID         = PPID_ENRP;
@@ -101,10 +101,29 @@ struct Registrar* registrarNew(const RegistrarIdentifierType serverID,
          free(registrar);
          return(NULL);
       }
+      /* HandleUpdates are sent for every handlespace change. Their
+         message is therefore allocated only once and reused. */
+      registrar->HandleUpdateMessage = rserpoolMessageNew(NULL, REGISTRAR_RSERPOOL_MESSAGE_BUFFER_SIZE);
+      if(registrar->HandleUpdateMessage == NULL) {
+         messageBufferDelete(registrar->ENRPUnicastMessageBuffer);
+         messageBufferDelete(registrar->ASAPMessageBuffer);
+         messageBufferDelete(registrar->UDPMessageBuffer);
+         free(registrar);
+         return(NULL);
+      }
+
+      /* The recvmmsg() batch buffer is optional: without it, the UDP
+         socket is read message by message. */
+      registrar->UDPBatchBuffer = NULL;
+#ifdef HAVE_RECVMMSG
+      if(enrpMulticastInputSocket >= 0) {
+         registrar->UDPBatchBuffer = (char*)malloc(REGISTRAR_UDP_BATCH_SIZE * REGISTRAR_RSERPOOL_MESSAGE_BUFFER_SIZE);
+      }
+#endif
 
       registrar->ServerID = serverID;
       if(registrar->ServerID == 0) {
-         registrar->ServerID = random32();
+         registrar->ServerID = secureRandom32();
       }
 
       dispatcherNew(&registrar->StateMachine, NULL, NULL, NULL);
@@ -135,6 +154,13 @@ struct Registrar* registrarNew(const RegistrarIdentifierType serverID,
                &registrar->StateMachine,
                registrarHandlePeerEvent,
                (void*)registrar);
+      timerNew(&registrar->LoadUpdatePropagationTimer,
+               &registrar->StateMachine,
+               registrarHandleLoadUpdatePropagationTimer,
+               (void*)registrar);
+      registrar->PendingLoadUpdateArray    = NULL;
+      registrar->PendingLoadUpdates        = 0;
+      registrar->PendingLoadUpdateCapacity = 0;
 
       registrar->InStartupPhase                = true;
       registrar->MentorServerID                = 0;
@@ -169,6 +195,8 @@ struct Registrar* registrarNew(const RegistrarIdentifierType serverID,
 
       registrar->MaxHRRate                             = REGISTRAR_DEFAULT_MAX_HR_RATE;
       registrar->MaxEURate                             = REGISTRAR_DEFAULT_MAX_EU_RATE;
+      registrar->MaxMessagesPerWakeup                  = REGISTRAR_DEFAULT_MAX_MESSAGES_PER_WAKEUP;
+      registrar->LoadUpdatePropagationInterval         = REGISTRAR_DEFAULT_LOAD_UPDATE_PROPAGATION_INTERVAL;
 
 #ifdef ENABLE_REGISTRAR_STATISTICS
       registrar->ActionLogFile                         = actionLogFile;
@@ -189,6 +217,13 @@ struct Registrar* registrarNew(const RegistrarIdentifierType serverID,
       registrar->Stats.SynchronizationCount            = 0;
       registrar->Stats.HandleUpdateCount               = 0;
       registrar->Stats.EndpointKeepAliveCount          = 0;
+      registrar->Stats.IntakeWakeupCount               = 0;
+      registrar->Stats.IntakeEmptyWakeupCount          = 0;
+      registrar->Stats.IntakeMessageCount              = 0;
+      registrar->Stats.IntakeBudgetExhaustedCount      = 0;
+      registrar->Stats.IntakeMaxBatchSize              = 0;
+      registrar->Stats.LoadUpdateCount                 = 0;
+      registrar->Stats.LoadUpdatePropagationCount      = 0;
       registrar->Stats.NeedsWeightedStatValues         = needsWeightedStatValues;
       initWeightedStatValue(&registrar->Stats.PoolsCount, registrar->Stats.ActionLogStartTime);
       initWeightedStatValue(&registrar->Stats.PoolElementsCount, registrar->Stats.ActionLogStartTime);
@@ -339,6 +374,11 @@ void registrarDelete(struct Registrar* registrar)
       timerDelete(&registrar->ENRPAnnounceTimer);
       timerDelete(&registrar->HandlespaceActionTimer);
       timerDelete(&registrar->PeerActionTimer);
+      timerDelete(&registrar->LoadUpdatePropagationTimer);
+      if(registrar->PendingLoadUpdateArray) {
+         free(registrar->PendingLoadUpdateArray);
+         registrar->PendingLoadUpdateArray = NULL;
+      }
       if(registrar->ENRPMulticastOutputSocket >= 0) {
          ext_close(registrar->ENRPMulticastOutputSocket);
          registrar->ENRPMulticastOutputSocket = -1;
@@ -361,12 +401,18 @@ void registrarDelete(struct Registrar* registrar)
          registrar->ASAPSocket = -1;
       }
       dispatcherDelete(&registrar->StateMachine);
+      rserpoolMessageDelete(registrar->HandleUpdateMessage);
+      registrar->HandleUpdateMessage = NULL;
       messageBufferDelete(registrar->ENRPUnicastMessageBuffer);
       registrar->ENRPUnicastMessageBuffer = NULL;
       messageBufferDelete(registrar->ASAPMessageBuffer);
       registrar->ASAPMessageBuffer = NULL;
       messageBufferDelete(registrar->UDPMessageBuffer);
       registrar->UDPMessageBuffer = NULL;
+      if(registrar->UDPBatchBuffer) {
+         free(registrar->UDPBatchBuffer);
+         registrar->UDPBatchBuffer = NULL;
+      }
       free(registrar);
    }
 }
@@ -557,7 +603,8 @@ void registrarPrintScalarStatistics(struct Registrar* registrar,
                                     FILE*             fh,
                                     const char*       objectName)
 {
-   const unsigned long long now = getMicroTime();
+   const unsigned long long             now = getMicroTime();
+   struct RSerPoolMessagePoolStatistics messagePoolStatistics;
 
    fputs("run 1 \"scenario\"\n", fh);
    fprintf(fh, "scalar \"%s\" \"Registrar Total Registrations\"        %8llu\n", objectName, registrar->Stats.RegistrationCount);
@@ -569,6 +616,24 @@ void registrarPrintScalarStatistics(struct Registrar* registrar,
    fprintf(fh, "scalar \"%s\" \"Registrar Total Handle Updates\"       %8llu\n", objectName, registrar->Stats.HandleUpdateCount);
    fprintf(fh, "scalar \"%s\" \"Registrar Total Endpoint Keep Alives\" %8llu\n", objectName, registrar->Stats.EndpointKeepAliveCount);
 
+   fprintf(fh, "scalar \"%s\" \"Registrar Total Intake Wakeups\"               %8llu\n", objectName, registrar->Stats.IntakeWakeupCount);
+   fprintf(fh, "scalar \"%s\" \"Registrar Total Empty Intake Wakeups\"         %8llu\n", objectName, registrar->Stats.IntakeEmptyWakeupCount);
+   fprintf(fh, "scalar \"%s\" \"Registrar Total Intake Messages\"              %8llu\n", objectName, registrar->Stats.IntakeMessageCount);
+   fprintf(fh, "scalar \"%s\" \"Registrar Total Intake Budget Exhaustions\"    %8llu\n", objectName, registrar->Stats.IntakeBudgetExhaustedCount);
+   fprintf(fh, "scalar \"%s\" \"Registrar Maximum Intake Batch Size\"          %8u\n",   objectName, registrar->Stats.IntakeMaxBatchSize);
+   fprintf(fh, "scalar \"%s\" \"Registrar Average Intake Batch Size\"          %1.6f\n", objectName,
+           (registrar->Stats.IntakeWakeupCount > 0) ?
+              (double)registrar->Stats.IntakeMessageCount / (double)registrar->Stats.IntakeWakeupCount : 0.0);
+
+   fprintf(fh, "scalar \"%s\" \"Registrar Total Load Updates\"                 %8llu\n", objectName, registrar->Stats.LoadUpdateCount);
+   fprintf(fh, "scalar \"%s\" \"Registrar Total Load Update Propagations\"     %8llu\n", objectName, registrar->Stats.LoadUpdatePropagationCount);
+
+   /* The registrar's main loop runs in the calling thread */
+   rserpoolMessageGetPoolStatistics(&messagePoolStatistics);
+   fprintf(fh, "scalar \"%s\" \"Registrar Message Heap Allocations\"           %8llu\n", objectName, messagePoolStatistics.HeapAllocations);
+   fprintf(fh, "scalar \"%s\" \"Registrar Message Pool Allocations\"           %8llu\n", objectName, messagePoolStatistics.PoolAllocations);
+   fprintf(fh, "scalar \"%s\" \"Registrar Message Remote Returns\"             %8llu\n", objectName, messagePoolStatistics.RemoteReturns);
+
    fprintf(fh, "scalar \"%s\" \"Registrar Average Number Of Pools\"               %1.6f\n", objectName, averageWeightedStatValue(&registrar->Stats.PoolsCount, now));
    fprintf(fh, "scalar \"%s\" \"Registrar Average Number Of Pool Elements\"       %1.6f\n", objectName, averageWeightedStatValue(&registrar->Stats.PoolElementsCount, now));
    fprintf(fh, "scalar \"%s\" \"Registrar Average Number Of Owned Pool Elements\" %1.6f\n", objectName, averageWeightedStatValue(&registrar->Stats.OwnedPoolElementsCount, now));
@@ -58,7 +58,9 @@ bool registrarPoolUserHasPermissionFor(struct Registrar*               registrar
 
    ST_CLASS(poolUserNodeNew)(nextPoolUserNode, fd, assocID);
    poolUserNode = ST_CLASS(poolUserListAddOrUpdatePoolUserNode)(&registrar->PoolUsers, &nextPoolUserNode);
-   CHECK(poolUserNode != NULL);
+   if(poolUserNode == NULL) {
+      return(true);   /* Out of memory, see above */
+   }
 
    now = getMicroTime();
    switch(action) {
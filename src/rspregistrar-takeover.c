@@ -151,7 +151,7 @@ void registrarSendENRPInitTakeoverToAllPeers(struct Registrar*             regis
    struct ST_CLASS(PeerListNode)* peerListNode;
    struct RSerPoolMessage*        message;
 
-   message = rserpoolMessageNew(NULL, 65536);
+   message = rserpoolMessageNew(NULL, RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE);
    if(message != NULL) {
       message->Type         = EHT_INIT_TAKEOVER;
       message->Flags        = 0x00;
@@ -262,7 +262,7 @@ void registrarSendENRPInitTakeoverAck(struct Registrar*             registrar,
 {
    struct RSerPoolMessage* message;
 
-   message = rserpoolMessageNew(NULL, 65536);
+   message = rserpoolMessageNew(NULL, RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE);
    if(message != NULL) {
       message->Type         = EHT_INIT_TAKEOVER_ACK;
       message->AssocID      = assocID;
@@ -424,7 +424,7 @@ static void registrarSendENRPTakeoverServer(struct Registrar*             regist
 {
    struct RSerPoolMessage* message;
 
-   message = rserpoolMessageNew(NULL, 65536);
+   message = rserpoolMessageNew(NULL, RSERPOOL_SMALL_MESSAGE_BUFFER_SIZE);
    if(message) {
       message->Type                = EHT_TAKEOVER_SERVER;
       message->PPID                = PPID_ENRP;
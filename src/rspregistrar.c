@@ -317,6 +317,7 @@ int main(int argc, char** argv)
    bool                          quiet;
 
    bool                          useIPv6;
+   bool                          useEPoll;
    const char*                   daemonPIDFile;
 
    unsigned int                  run;
@@ -358,6 +359,11 @@ start:
    serverID                      = 0;
    quiet                         = false;
    useIPv6                       = checkIPv6();
+#ifdef HAVE_EPOLL
+   useEPoll                      = true;
+#else
+   useEPoll                      = false;
+#endif
    daemonPIDFile                 = NULL;
    asapUnicastAddressParameter   = "auto";
    asapUnicastSocket             = -1;
@@ -407,12 +413,16 @@ start:
                (!(strncmp(argv[i], "-peermaxtimenoresponse=", 23))) ||
                (!(strncmp(argv[i], "-mentordiscoverytimeout=", 19))) ||
                (!(strncmp(argv[i], "-takeoverexpiryinterval=", 24))) ||
+               (!(strncmp(argv[i], "-loadupdatepropagationinterval=", 31))) ||
                (!(strcmp(argv[i], "-supporttakeoversuggestion"))) ||
                (!(strncmp(argv[i], "-maxincrement=", 14))) ||
                (!(strncmp(argv[i], "-maxhresitems=", 14))) ||
                (!(strncmp(argv[i], "-maxhrrate=", 11))) ||
                (!(strncmp(argv[i], "-maxeurate=", 11))) ||
-               (!(strncmp(argv[i], "-maxelementsperhtrequest=", 25))) ) {
+               (!(strncmp(argv[i], "-maxmessagesperwakeup=", 22))) ||
+               (!(strncmp(argv[i], "-maxelementsperhtrequest=", 25))) ||
+               (!(strncmp(argv[i], "-dispatcher=", 12))) ||
+               (!(strncmp(argv[i], "-timerstorage=", 14))) ) {
          /* to be handled later */
       }
       else if(!(strncmp(argv[i], "-asap=",6))) {
@@ -557,18 +567,19 @@ start:
 #endif
       else {
          fprintf(stderr, "ERROR: Invalid argument <%s>!\n", argv[i]);
-         fprintf(stderr, "Usage: %s {-asap=auto|address:port{,address}...} {[-asapannounce=auto|address:port}]} {-enrp=auto|address:port{,address}...} {[-enrpannounce=auto|address:port}]} {-logfile=file|-logappend=file|-logquiet} {-loglevel=level} {-logcolor=on|off} "
+         fprintf(stderr, "Usage: %s {-asap=auto|address:port{,address}...} {[-asapannounce=auto|address:port}]} {-enrp=auto|address:port{,address}...} {[-enrpannounce=auto|address:port}]} {-logfile=file|-logappend=file|-logquiet} {-loglevel=level} {-logcolor=on|off} {-logasync=on|off} "
 #ifdef ENABLE_CSP
             "{-cspserver=address} {-cspinterval=milliseconds} "
 #endif
             "{-identifier=registrar identifier} "
             "{-disable-ipv6} {-quiet} "
             "{-autoclosetimeout=seconds} {-serverannouncecycle=milliseconds} "
-            "{-maxbadpereports=reports} {-maxeurate=rate} {-maxhrrate=rate} "
+            "{-maxbadpereports=reports} {-maxeurate=rate} {-maxhrrate=rate} {-maxmessagesperwakeup=messages} "
             "{-endpointkeepalivetransmissioninterval=milliseconds} {-endpointkeepalivetimeoutinterval=milliseconds} "
             "{-minaddressscope=loopback|sitelocal|global} "
             "{-peerheartbeatcycle=milliseconds} {-peermaxtimelastheard=milliseconds} {-peermaxtimenoresponse=milliseconds} "
             "{-supporttakeoversuggestion} {-takeoverexpiryinterval=milliseconds} {-mentorhuntinterval=milliseconds} "
+            "{-loadupdatepropagationinterval=milliseconds} "
 #ifdef ENABLE_REGISTRAR_STATISTICS
             "{-actionlogfile=file} {-statsfile=file} {-statsinterval=millisecs} {-scalar=file} {-object=ID} "
 #endif
@@ -787,6 +798,12 @@ start:
             registrar->TakeoverExpiryInterval = 60000000;
          }
       }
+      else if(!(strncmp(argv[i], "-loadupdatepropagationinterval=", 31))) {
+         registrar->LoadUpdatePropagationInterval = 1000ULL * atol((char*)&argv[i][31]);
+         if(registrar->LoadUpdatePropagationInterval > 60000000) {
+            registrar->LoadUpdatePropagationInterval = 60000000;
+         }
+      }
       else if(!(strncmp(argv[i], "-announcettl=", 13))) {
          registrar->AnnounceTTL = atol((char*)&argv[i][13]);
          if(registrar->AnnounceTTL < 1) {
@@ -802,9 +819,41 @@ start:
       else if(!(strncmp(argv[i], "-maxeurate=", 11))) {
          registrar->MaxEURate = atof((const char*)&argv[i][11]);
       }
+      else if(!(strncmp(argv[i], "-maxmessagesperwakeup=", 22))) {
+         const long maxMessages = atol((const char*)&argv[i][22]);
+         registrar->MaxMessagesPerWakeup = (maxMessages >= 1) ? (unsigned int)maxMessages : 1;
+      }
       else if(!(strcmp(argv[i], "-supporttakeoversuggestion"))) {
          registrar->ENRPSupportTakeoverSuggestion = true;
       }
+      else if(!(strncmp(argv[i], "-dispatcher=", 12))) {
+         if(!(strcmp((const char*)&argv[i][12], "poll"))) {
+            useEPoll = false;
+         }
+         else if(!(strcmp((const char*)&argv[i][12], "epoll"))) {
+            useEPoll = true;
+         }
+         else {
+            fputs("ERROR: Bad argument for -dispatcher!\n", stderr);
+            exit(1);
+         }
+      }
+      else if(!(strncmp(argv[i], "-timerstorage=", 14))) {
+         if(!(strcmp((const char*)&argv[i][14], "tree"))) {
+            dispatcherSetTimingWheelMode(&registrar->StateMachine, 0);
+         }
+         else if(!(strcmp((const char*)&argv[i][14], "wheel"))) {
+            dispatcherSetTimingWheelMode(&registrar->StateMachine, TIMINGWHEEL_DEFAULT_TICK);
+         }
+         else {
+            fputs("ERROR: Bad argument for -timerstorage!\n", stderr);
+            exit(1);
+         }
+      }
+   }
+   if( (useEPoll) &&
+       (dispatcherSetEPollMode(&registrar->StateMachine, true) == false) ) {
+      fputs("NOTE: epoll() is not available, using poll()!\n", stderr);
    }
 #ifndef FAST_BREAK
    installBreakDetector();
@@ -870,6 +919,9 @@ start:
       }
 #endif
       printf("Daemon Mode:            %s\n", (daemonPIDFile == NULL) ? "off" : daemonPIDFile);
+      printf("Dispatcher:             %s\n", dispatcherIsInEPollMode(&registrar->StateMachine) ? "epoll" : "poll");
+      printf("Timer Storage:          %s\n", dispatcherIsInTimingWheelMode(&registrar->StateMachine) ? "timing wheel" : "red-black tree");
+      printf("Messages per Wakeup:    %u\n", registrar->MaxMessagesPerWakeup);
 
       puts("\nASAP Parameters:");
       printf("   Distance Step:                               %ums\n",   (unsigned int)registrar->DistanceStep);
@@ -888,6 +940,7 @@ start:
       printf("   Mentor Hunt Timeout:                         %lldms\n", registrar->MentorDiscoveryTimeout / 1000);
       printf("   Takeover Expiry Interval:                    %lldms\n", registrar->TakeoverExpiryInterval / 1000);
       printf("   Support for Takeover Suggestion:             %s\n", registrar->ENRPSupportTakeoverSuggestion ? "on" : "off");
+      printf("   Load Update Propagation Interval:            %lldms\n", registrar->LoadUpdatePropagationInterval / 1000);
       puts("Security Parameters:");
       printf("   Max Handle Resolution Rate:                  ");
       if(registrar->MaxHRRate > 0.0) {
@@ -917,6 +970,19 @@ start:
 
    /* ====== Main loop =================================================== */
    while(!breakDetected()) {
+      if(dispatcherIsInEPollMode(&registrar->StateMachine)) {
+         result = dispatcherEPollEventLoop(&registrar->StateMachine, 500);
+         if((result < 0) && (errno != EINTR)) {
+            perror("epoll_wait() failed");
+            break;
+         }
+         if( (endTimeStamp > 0) && (endTimeStamp <= getMicroTime()) ) {
+            puts("Shutdown by timer!");
+            break;
+         }
+         continue;
+      }
+
       dispatcherGetPollParameters(&registrar->StateMachine,
                                   (struct pollfd*)&ufds, &nfds, &timeout,
                                   &pollTimeStamp);
@@ -78,6 +78,9 @@
 #define REGISTRAR_DEFAULT_SUPPORT_TAKEOVER_SUGGESTION                   false
 #define REGISTRAR_DEFAULT_MAX_HR_RATE                                    -1.0   /* unlimited */
 #define REGISTRAR_DEFAULT_MAX_EU_RATE                                    -1.0   /* unlimited */
+#define REGISTRAR_DEFAULT_MAX_MESSAGES_PER_WAKEUP                          64
+#define REGISTRAR_UDP_BATCH_SIZE                                           16
+#define REGISTRAR_DEFAULT_LOAD_UPDATE_PROPAGATION_INTERVAL                  0   /* immediately */
 
 
 #ifdef ENABLE_REGISTRAR_STATISTICS
@@ -99,6 +102,15 @@ struct RegistrarStatistics
    unsigned long long                         HandleUpdateCount;
    unsigned long long                         EndpointKeepAliveCount;
 
+   unsigned long long                         IntakeWakeupCount;
+   unsigned long long                         IntakeEmptyWakeupCount;
+   unsigned long long                         IntakeMessageCount;
+   unsigned long long                         IntakeBudgetExhaustedCount;
+   unsigned int                               IntakeMaxBatchSize;
+
+   unsigned long long                         LoadUpdateCount;
+   unsigned long long                         LoadUpdatePropagationCount;
+
    bool                                       NeedsWeightedStatValues;
    struct WeightedStatValue                   PoolsCount;
    struct WeightedStatValue                   PoolElementsCount;
@@ -108,6 +120,13 @@ struct RegistrarStatistics
 #endif
 
 
+struct RegistrarPendingLoadUpdate
+{
+   struct PoolHandle                          Handle;
+   PoolElementIdentifierType                  Identifier;
+};
+
+
 struct Registrar
 {
    RegistrarIdentifierType                    ServerID;
@@ -117,8 +136,13 @@ struct Registrar
    struct ST_CLASS(PeerListManagement)        Peers;
    struct Timer                               HandlespaceActionTimer;
    struct Timer                               PeerActionTimer;
+   struct Timer                               LoadUpdatePropagationTimer;
+   struct RegistrarPendingLoadUpdate*         PendingLoadUpdateArray;
+   size_t                                     PendingLoadUpdates;
+   size_t                                     PendingLoadUpdateCapacity;
    struct ST_CLASS(PoolUserList)              PoolUsers;
    struct MessageBuffer*                      UDPMessageBuffer;
+   char*                                      UDPBatchBuffer;
 
    int                                        ASAPAnnounceSocket;
    int                                        ASAPAnnounceSocketFamily;
@@ -137,6 +161,7 @@ struct Registrar
    int                                        ENRPUnicastSocket;
    struct FDCallback                          ENRPUnicastSocketFDCallback;
    struct MessageBuffer*                      ENRPUnicastMessageBuffer;
+   struct RSerPoolMessage*                    HandleUpdateMessage;
    bool                                       ENRPAnnounceViaMulticast;
    struct Timer                               ENRPAnnounceTimer;
    bool                                       ENRPSupportTakeoverSuggestion;
@@ -163,6 +188,8 @@ struct Registrar
    unsigned long long                         TakeoverExpiryInterval;
    double                                     MaxHRRate;
    double                                     MaxEURate;
+   unsigned int                               MaxMessagesPerWakeup;
+   unsigned long long                         LoadUpdatePropagationInterval;
 
 #ifdef ENABLE_CSP
    struct CSPReporter                         CSPReporter;
@@ -284,6 +311,13 @@ void registrarHandleASAPHandleResolution(struct Registrar*       registrar,
                                          const int               fd,
                                          const sctp_assoc_t      assocID,
                                          struct RSerPoolMessage* message);
+void registrarHandleASAPLoadUpdate(struct Registrar*       registrar,
+                                   const int               fd,
+                                   const sctp_assoc_t      assocID,
+                                   struct RSerPoolMessage* message);
+void registrarHandleLoadUpdatePropagationTimer(struct Dispatcher* dispatcher,
+                                               struct Timer*      timer,
+                                               void*              userData);
 
 /* ====== Monitoring =================================== */
 void registrarHandleASAPEndpointKeepAliveAck(struct Registrar*       registrar,
@@ -167,6 +167,9 @@ start:
          else if(!(strcmp((const char*)&argv[i][8], "RandomizedLeastUsed"))) {
             loadInfo.rli_policy = PPT_RANDOMIZED_LEASTUSED;
          }
+         else if(!(strcmp((const char*)&argv[i][8], "PowerOfTwoChoices"))) {
+            loadInfo.rli_policy = PPT_POWER_OF_TWO_CHOICES;
+         }
          else if(sscanf((const char*)&argv[i][8], "LeastUsedDegradation:%lf", &degradation) == 1) {
             loadInfo.rli_load_degradation = (unsigned int)rint(degradation * (double)PPV_MAX_LOAD_DEGRADATION);
             if(loadInfo.rli_load_degradation > PPV_MAX_LOAD_DEGRADATION) {
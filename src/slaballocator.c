@@ -0,0 +1,232 @@
+/* --------------------------------------------------------------------------
+ *
+ *              //===//   //=====   //===//   //=====  //   //      //
+ *             //    //  //        //    //  //       //   //=/  /=//
+ *            //===//   //=====   //===//   //====   //   //  //  //
+ *           //   \\         //  //             //  //   //  //  //
+ *          //     \\  =====//  //        =====//  //   //      //  Version V
+ *
+ * ------------- An Open Source RSerPool Simulation for OMNeT++ -------------
+ *
+ * Copyright (C) 2003-2026 by Thomas Dreibholz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: thomas.dreibholz@gmail.com
+ */
+
+#include "slaballocator.h"
+#include "tdtypes.h"
+#include "debug.h"
+
+#include <string.h>
+
+
+/* ###### Get size class for given object size ########################### */
+static struct SlabAllocatorClass* slabAllocatorGetClass(struct SlabAllocator* slabAllocator,
+                                                        const size_t          size)
+{
+   size_t i;
+
+   /* Classes are sorted by size, and there are only a few of them. */
+   for(i = 0;i < slabAllocator->Classes;i++) {
+      if(size <= slabAllocator->Class[i].ObjectSize) {
+         return(&slabAllocator->Class[i]);
+      }
+   }
+   return(NULL);
+}
+
+
+/* ###### Initialize ##################################################### */
+void slabAllocatorNew(struct SlabAllocator* slabAllocator,
+                      const size_t*         classSizes,
+                      const size_t          classes,
+                      const size_t          objectsPerSlab)
+{
+   size_t objectSize;
+   size_t i, j;
+
+   CHECK(classes <= SLABALLOCATOR_MAX_CLASSES);
+   slabAllocator->Classes          = 0;
+   slabAllocator->ObjectsPerSlab   = (objectsPerSlab > 0) ? objectsPerSlab : SLABALLOCATOR_OBJECTS_PER_SLAB;
+   slabAllocator->LargeInUse       = 0;
+   slabAllocator->LargeAllocations = 0;
+   slabAllocator->Failures         = 0;
+
+   for(i = 0;i < classes;i++) {
+      /* ====== Round up to alignment, at least a free list pointer ====== */
+      objectSize = (classSizes[i] < sizeof(void*)) ? sizeof(void*) : classSizes[i];
+      objectSize = (objectSize + SLABALLOCATOR_ALIGNMENT - 1) & ~((size_t)SLABALLOCATOR_ALIGNMENT - 1);
+
+      /* ====== Insertion sort by size, skipping duplicates ============== */
+      for(j = 0;j < slabAllocator->Classes;j++) {
+         if(slabAllocator->Class[j].ObjectSize >= objectSize) {
+            break;
+         }
+      }
+      if((j < slabAllocator->Classes) && (slabAllocator->Class[j].ObjectSize == objectSize)) {
+         continue;
+      }
+      memmove(&slabAllocator->Class[j + 1], &slabAllocator->Class[j],
+              (slabAllocator->Classes - j) * sizeof(struct SlabAllocatorClass));
+      slabAllocator->Class[j].ObjectSize  = objectSize;
+      slabAllocator->Class[j].FreeList    = NULL;
+      slabAllocator->Class[j].Slabs       = NULL;
+      slabAllocator->Class[j].SlabCount   = 0;
+      slabAllocator->Class[j].InUse       = 0;
+      slabAllocator->Class[j].PeakInUse   = 0;
+      slabAllocator->Class[j].Allocations = 0;
+      slabAllocator->Class[j].Frees       = 0;
+      slabAllocator->Classes++;
+   }
+}
+
+
+/* ###### Invalidate ##################################################### */
+void slabAllocatorDelete(struct SlabAllocator* slabAllocator)
+{
+   struct SlabAllocatorSlab* slab;
+   size_t                    i;
+
+   for(i = 0;i < slabAllocator->Classes;i++) {
+      while(slabAllocator->Class[i].Slabs != NULL) {
+         slab = slabAllocator->Class[i].Slabs;
+         slabAllocator->Class[i].Slabs = slab->Next;
+         free(slab);
+      }
+      slabAllocator->Class[i].FreeList  = NULL;
+      slabAllocator->Class[i].SlabCount = 0;
+      slabAllocator->Class[i].InUse     = 0;
+   }
+   slabAllocator->Classes = 0;
+}
+
+
+/* ###### Add a new slab to a size class ################################# */
+static bool slabAllocatorGrow(struct SlabAllocator*      slabAllocator,
+                              struct SlabAllocatorClass* slabClass)
+{
+   struct SlabAllocatorSlab* slab;
+   char*                     object;
+   size_t                    headerSize;
+   size_t                    i;
+
+   headerSize = (sizeof(struct SlabAllocatorSlab) + SLABALLOCATOR_ALIGNMENT - 1) &
+                   ~((size_t)SLABALLOCATOR_ALIGNMENT - 1);
+   slab = (struct SlabAllocatorSlab*)malloc(headerSize +
+                                            (slabAllocator->ObjectsPerSlab * slabClass->ObjectSize));
+   if(slab == NULL) {
+      return(false);
+   }
+   slab->Next       = slabClass->Slabs;
+   slabClass->Slabs = slab;
+   slabClass->SlabCount++;
+
+   /* ====== Put the new objects into the free list ===================== */
+   object = (char*)slab + headerSize;
+   for(i = 0;i < slabAllocator->ObjectsPerSlab;i++) {
+      *((void**)object)   = slabClass->FreeList;
+      slabClass->FreeList = (void*)object;
+      object += slabClass->ObjectSize;
+   }
+   return(true);
+}
+
+
+/* ###### Allocate object ################################################ */
+void* slabAllocatorAllocate(struct SlabAllocator* slabAllocator,
+                            const size_t          size)
+{
+   struct SlabAllocatorClass* slabClass = slabAllocatorGetClass(slabAllocator, size);
+   void*                      object;
+
+   if(slabClass == NULL) {
+      object = malloc(size);
+      if(object != NULL) {
+         slabAllocator->LargeInUse++;
+         slabAllocator->LargeAllocations++;
+      }
+      else {
+         slabAllocator->Failures++;
+      }
+      return(object);
+   }
+
+   if(slabClass->FreeList == NULL) {
+      if(!slabAllocatorGrow(slabAllocator, slabClass)) {
+         slabAllocator->Failures++;
+         return(NULL);
+      }
+   }
+   object              = slabClass->FreeList;
+   slabClass->FreeList = *((void**)object);
+   slabClass->InUse++;
+   slabClass->Allocations++;
+   if(slabClass->InUse > slabClass->PeakInUse) {
+      slabClass->PeakInUse = slabClass->InUse;
+   }
+   return(object);
+}
+
+
+/* ###### Free object #################################################### */
+void slabAllocatorFree(struct SlabAllocator* slabAllocator,
+                       void*                 object,
+                       const size_t          size)
+{
+   struct SlabAllocatorClass* slabClass;
+
+   if(object != NULL) {
+      slabClass = slabAllocatorGetClass(slabAllocator, size);
+      if(slabClass == NULL) {
+         CHECK(slabAllocator->LargeInUse > 0);
+         slabAllocator->LargeInUse--;
+         free(object);
+      }
+      else {
+         CHECK(slabClass->InUse > 0);
+         *((void**)object)   = slabClass->FreeList;
+         slabClass->FreeList = object;
+         slabClass->InUse--;
+         slabClass->Frees++;
+      }
+   }
+}
+
+
+/* ###### Print allocation statistics #################################### */
+void slabAllocatorPrintStatistics(const struct SlabAllocator* slabAllocator,
+                                  FILE*                       fd)
+{
+   const struct SlabAllocatorClass* slabClass;
+   size_t                           i;
+
+   fprintf(fd, "Slab allocator: %u size classes, %u objects/slab\n",
+           (unsigned int)slabAllocator->Classes, (unsigned int)slabAllocator->ObjectsPerSlab);
+   for(i = 0;i < slabAllocator->Classes;i++) {
+      slabClass = &slabAllocator->Class[i];
+      fprintf(fd, " - %5u bytes: slabs=%u inUse=%u peak=%u allocs=%llu frees=%llu\n",
+              (unsigned int)slabClass->ObjectSize,
+              (unsigned int)slabClass->SlabCount,
+              (unsigned int)slabClass->InUse,
+              (unsigned int)slabClass->PeakInUse,
+              slabClass->Allocations,
+              slabClass->Frees);
+   }
+   fprintf(fd, " - large:       inUse=%u allocs=%llu\n",
+           (unsigned int)slabAllocator->LargeInUse,
+           slabAllocator->LargeAllocations);
+   fprintf(fd, " - failures:    %llu\n", slabAllocator->Failures);
+}
@@ -0,0 +1,141 @@
+/* --------------------------------------------------------------------------
+ *
+ *              //===//   //=====   //===//   //=====  //   //      //
+ *             //    //  //        //    //  //       //   //=/  /=//
+ *            //===//   //=====   //===//   //====   //   //  //  //
+ *           //   \\         //  //             //  //   //  //  //
+ *          //     \\  =====//  //        =====//  //   //      //  Version V
+ *
+ * ------------- An Open Source RSerPool Simulation for OMNeT++ -------------
+ *
+ * Copyright (C) 2003-2026 by Thomas Dreibholz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: thomas.dreibholz@gmail.com
+ */
+
+#ifndef SLABALLOCATOR_H
+#define SLABALLOCATOR_H
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+   Slab allocator with size classes:
+   Objects of a size class are carved out of slabs of
+   SLABALLOCATOR_OBJECTS_PER_SLAB objects and recycled through a free list.
+   Slabs are returned to the system only by slabAllocatorDelete().
+   Requests larger than the largest size class are passed to malloc().
+   The allocator is not thread-safe; it is protected by the lock of its
+   owner (e.g. the handlespace).
+*/
+#define SLABALLOCATOR_MAX_CLASSES       8
+#define SLABALLOCATOR_OBJECTS_PER_SLAB 64
+#define SLABALLOCATOR_ALIGNMENT        16
+
+
+struct SlabAllocatorSlab
+{
+   struct SlabAllocatorSlab* Next;
+};
+
+struct SlabAllocatorClass
+{
+   size_t                    ObjectSize;
+   void*                     FreeList;
+   struct SlabAllocatorSlab* Slabs;
+
+   size_t                    SlabCount;
+   size_t                    InUse;
+   size_t                    PeakInUse;
+   unsigned long long        Allocations;
+   unsigned long long        Frees;
+};
+
+struct SlabAllocator
+{
+   struct SlabAllocatorClass Class[SLABALLOCATOR_MAX_CLASSES];
+   size_t                    Classes;
+   size_t                    ObjectsPerSlab;
+
+   size_t                    LargeInUse;
+   unsigned long long        LargeAllocations;
+   unsigned long long        Failures;
+};
+
+
+/**
+  * Constructor. Size classes may be given in any order; duplicates are
+  * merged.
+  *
+  * @param slabAllocator SlabAllocator.
+  * @param classSizes Array of object sizes for the size classes.
+  * @param classes Number of size classes (at most SLABALLOCATOR_MAX_CLASSES).
+  * @param objectsPerSlab Number of objects per slab (0 for default).
+  */
+void slabAllocatorNew(struct SlabAllocator* slabAllocator,
+                      const size_t*         classSizes,
+                      const size_t          classes,
+                      const size_t          objectsPerSlab);
+
+/**
+  * Destructor. All slabs are freed; objects still in use become invalid.
+  *
+  * @param slabAllocator SlabAllocator.
+  */
+void slabAllocatorDelete(struct SlabAllocator* slabAllocator);
+
+/**
+  * Allocate object.
+  *
+  * @param slabAllocator SlabAllocator.
+  * @param size Object size.
+  * @return Object or NULL in case of error.
+  */
+void* slabAllocatorAllocate(struct SlabAllocator* slabAllocator,
+                            const size_t          size);
+
+/**
+  * Free object.
+  *
+  * @param slabAllocator SlabAllocator.
+  * @param object Object (may be NULL).
+  * @param size Object size, as given to slabAllocatorAllocate().
+  */
+void slabAllocatorFree(struct SlabAllocator* slabAllocator,
+                       void*                 object,
+                       const size_t          size);
+
+/**
+  * Print allocation statistics.
+  *
+  * @param slabAllocator SlabAllocator.
+  * @param fd File to write statistics to (e.g. stdout, stdlog, ...).
+  */
+void slabAllocatorPrintStatistics(const struct SlabAllocator* slabAllocator,
+                                  FILE*                       fd);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
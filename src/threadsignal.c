@@ -68,6 +68,13 @@ void threadSignalFire(struct ThreadSignal* threadSignal)
 }
 
 
+/* ###### Send signal to all waiting threads ############################# */
+void threadSignalFireAll(struct ThreadSignal* threadSignal)
+{
+   pthread_cond_broadcast(&threadSignal->Condition);
+}
+
+
 /* ###### Wait for signal ################################################ */
 void threadSignalWait(struct ThreadSignal* threadSignal)
 {
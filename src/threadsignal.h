@@ -81,6 +81,13 @@ void threadSignalUnlock(struct ThreadSignal* threadSignal);
   */
 void threadSignalFire(struct ThreadSignal* threadSignal);
 
+/**
+  * Fire signal to all waiting threads.
+  *
+  * @param threadSignal ThreadSignal.
+  */
+void threadSignalFireAll(struct ThreadSignal* threadSignal);
+
 /**
   * Wait for signal.
   *
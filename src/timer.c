@@ -48,6 +48,8 @@ void timerNew(struct Timer*      timer,
               void*              userData)
 {
    simpleRedBlackTreeNodeNew(&timer->Node);
+   doubleLinkedRingListNodeNew(&timer->WheelNode);
+   timer->WheelLevel = 0;
    timer->Master    = dispatcher;
    timer->TimeStamp = 0;
    timer->Callback  = callback;
@@ -60,6 +62,7 @@ void timerDelete(struct Timer* timer)
 {
    timerStop(timer);
    simpleRedBlackTreeNodeDelete(&timer->Node);
+   doubleLinkedRingListNodeDelete(&timer->WheelNode);
    timer->Master    = NULL;
    timer->TimeStamp = 0;
    timer->Callback  = NULL;
@@ -73,14 +76,19 @@ void timerStart(struct Timer*            timer,
 {
    struct SimpleRedBlackTreeNode* result;
 
-   CHECK(!simpleRedBlackTreeNodeIsLinked(&timer->Node));
+   CHECK(!timerIsRunning(timer));
    timer->TimeStamp = timeStamp;
 
    dispatcherLock(timer->Master);
-   result = simpleRedBlackTreeInsert(&timer->Master->TimerStorage,
-                                     &timer->Node);
-   CHECK(result == &timer->Node);
-   timer->Master->AddRemove = true;
+   if(timer->Master->TimerWheel != NULL) {
+      timingWheelInsert(timer->Master->TimerWheel, timer);
+   }
+   else {
+      result = simpleRedBlackTreeInsert(&timer->Master->TimerStorage,
+                                        &timer->Node);
+      CHECK(result == &timer->Node);
+      timer->Master->AddRemove = true;
+   }
    dispatcherUnlock(timer->Master);
 }
 
@@ -97,7 +105,8 @@ void timerRestart(struct Timer*            timer,
 /* ###### Check, if timer is running ##################################### */
 bool timerIsRunning(struct Timer* timer)
 {
-   return(simpleRedBlackTreeNodeIsLinked(&timer->Node));
+   return(simpleRedBlackTreeNodeIsLinked(&timer->Node) ||
+          timingWheelTimerIsLinked(timer));
 }
 
 
@@ -106,7 +115,11 @@ void timerStop(struct Timer* timer)
 {
    struct SimpleRedBlackTreeNode* result;
    dispatcherLock(timer->Master);
-   if(simpleRedBlackTreeNodeIsLinked(&timer->Node)) {
+   if(timingWheelTimerIsLinked(timer)) {
+      timingWheelRemove(timer->Master->TimerWheel, timer);
+      timer->TimeStamp = 0;
+   }
+   else if(simpleRedBlackTreeNodeIsLinked(&timer->Node)) {
       result = simpleRedBlackTreeRemove(&timer->Master->TimerStorage,
                                         &timer->Node);
       CHECK(result == &timer->Node);
@@ -41,6 +41,7 @@
 #include "tdtypes.h"
 #include "dispatcher.h"
 #include "simpleredblacktree.h"
+#include "doublelinkedringlist.h"
 
 
 #ifdef __cplusplus
@@ -51,6 +52,8 @@ extern "C" {
 struct Timer
 {
    struct SimpleRedBlackTreeNode Node;
+   struct DoubleLinkedRingListNode   WheelNode;
+   unsigned int                      WheelLevel;
 
    struct Dispatcher*                Master;
    unsigned long long                TimeStamp;
@@ -0,0 +1,333 @@
+/* --------------------------------------------------------------------------
+ *
+ *              //===//   //=====   //===//   //       //   //===//
+ *             //    //  //        //    //  //       //   //    //
+ *            //===//   //=====   //===//   //       //   //===<<
+ *           //   \\         //  //        //       //   //    //
+ *          //     \\  =====//  //        //=====  //   //===//   Version III
+ *
+ * ------------- An Efficient RSerPool Prototype Implementation -------------
+ *
+ * Copyright (C) 2002-2026 by Thomas Dreibholz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: thomas.dreibholz@gmail.com
+ */
+
+#include "tdtypes.h"
+#include "loglevel.h"
+#include "timingwheel.h"
+#include "timer.h"
+
+#include <stddef.h>
+
+
+#define getTimerFromWheelNode(node) \
+   ((struct Timer*)((char*)(node) - offsetof(struct Timer, WheelNode)))
+
+
+/* ###### Constructor #################################################### */
+void timingWheelNew(struct TimingWheel*      timingWheel,
+                    const unsigned long long tickLength,
+                    const unsigned long long now)
+{
+   unsigned int i, j;
+
+   CHECK(tickLength > 0);
+   timingWheel->TickLength  = tickLength;
+   timingWheel->CurrentTick = now / tickLength;
+   timingWheel->Timers      = 0;
+   for(i = 0;i <= TIMINGWHEEL_LEVELS;i++) {
+      timingWheel->LevelTimers[i] = 0;
+   }
+   doubleLinkedRingListNew(&timingWheel->Expired);
+   for(i = 0;i < TIMINGWHEEL_ROOT_SLOTS;i++) {
+      doubleLinkedRingListNew(&timingWheel->RootSlot[i]);
+   }
+   for(i = 0;i < TIMINGWHEEL_LEVELS;i++) {
+      for(j = 0;j < TIMINGWHEEL_LEVEL_SLOTS;j++) {
+         doubleLinkedRingListNew(&timingWheel->LevelSlot[i][j]);
+      }
+   }
+}
+
+
+/* ###### Destructor ##################################################### */
+void timingWheelDelete(struct TimingWheel* timingWheel)
+{
+   unsigned int i, j;
+
+   CHECK(timingWheel->Timers == 0);
+   doubleLinkedRingListDelete(&timingWheel->Expired);
+   for(i = 0;i < TIMINGWHEEL_ROOT_SLOTS;i++) {
+      doubleLinkedRingListDelete(&timingWheel->RootSlot[i]);
+   }
+   for(i = 0;i < TIMINGWHEEL_LEVELS;i++) {
+      for(j = 0;j < TIMINGWHEEL_LEVEL_SLOTS;j++) {
+         doubleLinkedRingListDelete(&timingWheel->LevelSlot[i][j]);
+      }
+   }
+   timingWheel->TickLength  = 0;
+   timingWheel->CurrentTick = 0;
+}
+
+
+/* ###### Check whether timing wheel is empty ############################ */
+bool timingWheelIsEmpty(const struct TimingWheel* timingWheel)
+{
+   return(timingWheel->Timers == 0);
+}
+
+
+/* ###### Check whether timer is linked into a timing wheel ############## */
+bool timingWheelTimerIsLinked(const struct Timer* timer)
+{
+   return(timer->WheelNode.Next != NULL);
+}
+
+
+/* ###### Link timer into slot for its expiry tick ####################### */
+static void timingWheelLink(struct TimingWheel* timingWheel,
+                            struct Timer*       timer)
+{
+   unsigned long long expiryTick;
+   unsigned long long delta;
+   unsigned int       level;
+   unsigned int       shift;
+
+   /* Round up: a timer must never fire before its time stamp. */
+   expiryTick = (timer->TimeStamp / timingWheel->TickLength) +
+                   ((timer->TimeStamp % timingWheel->TickLength) ? 1 : 0);
+   if(expiryTick < timingWheel->CurrentTick) {
+      /* Already expired -> handle with the next tick */
+      expiryTick = timingWheel->CurrentTick;
+   }
+   delta = expiryTick - timingWheel->CurrentTick;
+
+   /* ====== Root level ================================================= */
+   if(delta < TIMINGWHEEL_ROOT_SLOTS) {
+      timer->WheelLevel = 0;
+      doubleLinkedRingListAddTail(&timingWheel->RootSlot[expiryTick & TIMINGWHEEL_ROOT_MASK],
+                                  &timer->WheelNode);
+   }
+
+   /* ====== Higher levels ============================================== */
+   else {
+      shift = TIMINGWHEEL_ROOT_BITS;
+      for(level = 1;level < TIMINGWHEEL_LEVELS;level++) {
+         if(delta < (1ULL << (shift + TIMINGWHEEL_LEVEL_BITS))) {
+            break;
+         }
+         shift += TIMINGWHEEL_LEVEL_BITS;
+      }
+      if(level == TIMINGWHEEL_LEVELS) {
+         /* Beyond the range of the wheel -> put into the last slot
+            of the top level. It will be re-linked by cascading. */
+         level = TIMINGWHEEL_LEVELS;
+         if(delta >= (1ULL << (shift + TIMINGWHEEL_LEVEL_BITS))) {
+            expiryTick = timingWheel->CurrentTick +
+                            (1ULL << (shift + TIMINGWHEEL_LEVEL_BITS)) - 1;
+         }
+      }
+      timer->WheelLevel = level;
+      doubleLinkedRingListAddTail(
+         &timingWheel->LevelSlot[level - 1][(expiryTick >> shift) & TIMINGWHEEL_LEVEL_MASK],
+         &timer->WheelNode);
+   }
+   timingWheel->LevelTimers[timer->WheelLevel]++;
+}
+
+
+/* ###### Unlink timer from its slot ##################################### */
+static void timingWheelUnlink(struct TimingWheel* timingWheel,
+                              struct Timer*       timer)
+{
+   if(timer->WheelLevel <= TIMINGWHEEL_LEVELS) {
+      CHECK(timingWheel->LevelTimers[timer->WheelLevel] > 0);
+      timingWheel->LevelTimers[timer->WheelLevel]--;
+   }
+   doubleLinkedRingListRemNode(&timer->WheelNode);
+}
+
+
+/* ###### Insert timer ################################################### */
+void timingWheelInsert(struct TimingWheel* timingWheel,
+                       struct Timer*       timer)
+{
+   CHECK(!timingWheelTimerIsLinked(timer));
+   timingWheelLink(timingWheel, timer);
+   timingWheel->Timers++;
+}
+
+
+/* ###### Remove timer ################################################### */
+void timingWheelRemove(struct TimingWheel* timingWheel,
+                       struct Timer*       timer)
+{
+   CHECK(timingWheelTimerIsLinked(timer));
+   timingWheelUnlink(timingWheel, timer);
+   CHECK(timingWheel->Timers > 0);
+   timingWheel->Timers--;
+}
+
+
+/* ###### Move all timers of a higher-level slot one level down ########## */
+static void timingWheelCascade(struct TimingWheel*          timingWheel,
+                               struct DoubleLinkedRingList* slot)
+{
+   struct DoubleLinkedRingListNode* node;
+   struct Timer*                    timer;
+
+   while(slot->Node.Next != &slot->Node) {
+      node  = slot->Node.Next;
+      timer = getTimerFromWheelNode(node);
+      timingWheelUnlink(timingWheel, timer);
+      timingWheelLink(timingWheel, timer);
+   }
+}
+
+
+/* ###### Handle current tick ############################################ */
+static void timingWheelHandleTick(struct TimingWheel* timingWheel)
+{
+   struct DoubleLinkedRingList* slot;
+   struct Timer*                timer;
+   unsigned long long           tick;
+   unsigned int                 shift;
+   unsigned int                 level;
+
+   /* ====== Cascade timers from higher levels ========================== */
+   tick = timingWheel->CurrentTick;
+   if((tick & TIMINGWHEEL_ROOT_MASK) == 0) {
+      shift = TIMINGWHEEL_ROOT_BITS;
+      for(level = 1;level <= TIMINGWHEEL_LEVELS;level++) {
+         if(timingWheel->LevelTimers[level] > 0) {
+            timingWheelCascade(timingWheel,
+               &timingWheel->LevelSlot[level - 1][(tick >> shift) & TIMINGWHEEL_LEVEL_MASK]);
+         }
+         if(((tick >> shift) & TIMINGWHEEL_LEVEL_MASK) != 0) {
+            break;
+         }
+         shift += TIMINGWHEEL_LEVEL_BITS;
+      }
+   }
+
+   /* ====== Move all timers of the current slot to the expired list ==== */
+   slot = &timingWheel->RootSlot[tick & TIMINGWHEEL_ROOT_MASK];
+   while(slot->Node.Next != &slot->Node) {
+      timer = getTimerFromWheelNode(slot->Node.Next);
+      timingWheelUnlink(timingWheel, timer);
+      timer->WheelLevel = TIMINGWHEEL_EXPIRED_LEVEL;
+      doubleLinkedRingListAddTail(&timingWheel->Expired, &timer->WheelNode);
+   }
+   timingWheel->CurrentTick++;
+}
+
+
+/* ###### Get next expired timer ######################################### */
+struct Timer* timingWheelGetNextExpiredTimer(struct TimingWheel*      timingWheel,
+                                             const unsigned long long now)
+{
+   const unsigned long long nowTick = now / timingWheel->TickLength;
+   struct Timer*            timer;
+
+   while(timingWheel->Expired.Node.Next == &timingWheel->Expired.Node) {
+      if(timingWheel->CurrentTick > nowTick) {
+         return(NULL);
+      }
+      if(timingWheel->Timers == 0) {
+         /* Nothing to do -> skip idle ticks */
+         timingWheel->CurrentTick = nowTick + 1;
+         return(NULL);
+      }
+      timingWheelHandleTick(timingWheel);
+   }
+
+   timer = getTimerFromWheelNode(timingWheel->Expired.Node.Next);
+   timingWheelRemove(timingWheel, timer);
+   return(timer);
+}
+
+
+/* ###### Get time stamp of next relevant tick ########################### */
+unsigned long long timingWheelGetNextTimeStamp(const struct TimingWheel* timingWheel)
+{
+   unsigned long long tick;
+   unsigned long long boundary;
+   unsigned int       i;
+
+   if(timingWheel->Timers == 0) {
+      return(~0ULL);
+   }
+   if(timingWheel->Expired.Node.Next != &timingWheel->Expired.Node) {
+      return(0);
+   }
+
+   /* ====== Next boundary requiring a cascade ========================== */
+   boundary = ~0ULL;
+   for(i = 1;i <= TIMINGWHEEL_LEVELS;i++) {
+      if(timingWheel->LevelTimers[i] > 0) {
+         if((timingWheel->CurrentTick & TIMINGWHEEL_ROOT_MASK) == 0) {
+            boundary = timingWheel->CurrentTick;
+         }
+         else {
+            boundary = (timingWheel->CurrentTick | TIMINGWHEEL_ROOT_MASK) + 1;
+         }
+         break;
+      }
+   }
+
+   /* ====== Next non-empty root slot =================================== */
+   if(timingWheel->LevelTimers[0] > 0) {
+      for(i = 0;i < TIMINGWHEEL_ROOT_SLOTS;i++) {
+         tick = timingWheel->CurrentTick + i;
+         if(tick >= boundary) {
+            break;
+         }
+         if(timingWheel->RootSlot[tick & TIMINGWHEEL_ROOT_MASK].Node.Next !=
+               &timingWheel->RootSlot[tick & TIMINGWHEEL_ROOT_MASK].Node) {
+            return(tick * timingWheel->TickLength);
+         }
+      }
+   }
+   CHECK(boundary != ~0ULL);
+   return(boundary * timingWheel->TickLength);
+}
+
+
+/* ###### Get any timer ################################################## */
+struct Timer* timingWheelGetAnyTimer(struct TimingWheel* timingWheel)
+{
+   unsigned int i, j;
+
+   if(timingWheel->Timers > 0) {
+      if(timingWheel->Expired.Node.Next != &timingWheel->Expired.Node) {
+         return(getTimerFromWheelNode(timingWheel->Expired.Node.Next));
+      }
+      for(i = 0;i < TIMINGWHEEL_ROOT_SLOTS;i++) {
+         if(timingWheel->RootSlot[i].Node.Next != &timingWheel->RootSlot[i].Node) {
+            return(getTimerFromWheelNode(timingWheel->RootSlot[i].Node.Next));
+         }
+      }
+      for(i = 0;i < TIMINGWHEEL_LEVELS;i++) {
+         for(j = 0;j < TIMINGWHEEL_LEVEL_SLOTS;j++) {
+            if(timingWheel->LevelSlot[i][j].Node.Next != &timingWheel->LevelSlot[i][j].Node) {
+               return(getTimerFromWheelNode(timingWheel->LevelSlot[i][j].Node.Next));
+            }
+         }
+      }
+   }
+   return(NULL);
+}
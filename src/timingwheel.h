@@ -0,0 +1,163 @@
+/* --------------------------------------------------------------------------
+ *
+ *              //===//   //=====   //===//   //       //   //===//
+ *             //    //  //        //    //  //       //   //    //
+ *            //===//   //=====   //===//   //       //   //===<<
+ *           //   \\         //  //        //       //   //    //
+ *          //     \\  =====//  //        //=====  //   //===//   Version III
+ *
+ * ------------- An Efficient RSerPool Prototype Implementation -------------
+ *
+ * Copyright (C) 2002-2026 by Thomas Dreibholz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: thomas.dreibholz@gmail.com
+ */
+
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include "tdtypes.h"
+#include "doublelinkedringlist.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+struct Timer;
+
+
+/*
+   Hashed hierarchical timing wheel (Varghese/Lauck):
+   The root level has TIMINGWHEEL_ROOT_SLOTS slots of one tick each.
+   Each of the TIMINGWHEEL_LEVELS higher levels has TIMINGWHEEL_LEVEL_SLOTS
+   slots, each covering a full turn of the level below. Timers are cascaded
+   down when the root level wraps around. Start, stop and restart are O(1).
+*/
+#define TIMINGWHEEL_ROOT_BITS                8
+#define TIMINGWHEEL_LEVEL_BITS               6
+#define TIMINGWHEEL_ROOT_SLOTS    (1 << TIMINGWHEEL_ROOT_BITS)
+#define TIMINGWHEEL_LEVEL_SLOTS   (1 << TIMINGWHEEL_LEVEL_BITS)
+#define TIMINGWHEEL_ROOT_MASK     (TIMINGWHEEL_ROOT_SLOTS - 1)
+#define TIMINGWHEEL_LEVEL_MASK    (TIMINGWHEEL_LEVEL_SLOTS - 1)
+#define TIMINGWHEEL_LEVELS                   4
+#define TIMINGWHEEL_EXPIRED_LEVEL (TIMINGWHEEL_LEVELS + 1)
+
+#define TIMINGWHEEL_DEFAULT_TICK          1000   /* 1ms */
+
+
+struct TimingWheel
+{
+   unsigned long long          TickLength;
+   unsigned long long          CurrentTick;
+   size_t                      Timers;
+   size_t                      LevelTimers[TIMINGWHEEL_LEVELS + 1];
+
+   struct DoubleLinkedRingList Expired;
+   struct DoubleLinkedRingList RootSlot[TIMINGWHEEL_ROOT_SLOTS];
+   struct DoubleLinkedRingList LevelSlot[TIMINGWHEEL_LEVELS][TIMINGWHEEL_LEVEL_SLOTS];
+};
+
+
+/**
+  * Constructor.
+  *
+  * @param timingWheel TimingWheel.
+  * @param tickLength Length of a tick in microseconds.
+  * @param now Current time stamp.
+  */
+void timingWheelNew(struct TimingWheel*      timingWheel,
+                    const unsigned long long tickLength,
+                    const unsigned long long now);
+
+/**
+  * Destructor.
+  *
+  * @param timingWheel TimingWheel.
+  */
+void timingWheelDelete(struct TimingWheel* timingWheel);
+
+/**
+  * Check whether timing wheel is empty.
+  *
+  * @param timingWheel TimingWheel.
+  * @return true if empty; false otherwise.
+  */
+bool timingWheelIsEmpty(const struct TimingWheel* timingWheel);
+
+/**
+  * Insert timer. Its TimeStamp must already be set.
+  *
+  * @param timingWheel TimingWheel.
+  * @param timer Timer.
+  */
+void timingWheelInsert(struct TimingWheel* timingWheel,
+                       struct Timer*       timer);
+
+/**
+  * Remove timer.
+  *
+  * @param timingWheel TimingWheel.
+  * @param timer Timer.
+  */
+void timingWheelRemove(struct TimingWheel* timingWheel,
+                       struct Timer*       timer);
+
+/**
+  * Check whether timer is linked into a timing wheel.
+  *
+  * @param timer Timer.
+  * @return true if linked; false otherwise.
+  */
+bool timingWheelTimerIsLinked(const struct Timer* timer);
+
+/**
+  * Get time stamp of the next tick having expiring timers. The result
+  * may be earlier than the actual expiry, when timers of a higher level
+  * have to be cascaded first.
+  *
+  * @param timingWheel TimingWheel.
+  * @return Time stamp or ~0ULL if the timing wheel is empty.
+  */
+unsigned long long timingWheelGetNextTimeStamp(const struct TimingWheel* timingWheel);
+
+/**
+  * Advance the timing wheel up to the given time and remove the next
+  * expired timer. All timers of an expired tick are collected at once.
+  *
+  * @param timingWheel TimingWheel.
+  * @param now Current time stamp.
+  * @return Expired timer or NULL if there is none.
+  */
+struct Timer* timingWheelGetNextExpiredTimer(struct TimingWheel*      timingWheel,
+                                             const unsigned long long now);
+
+/**
+  * Get first timer in timing wheel (in arbitrary order), e.g. to move
+  * all timers into another storage.
+  *
+  * @param timingWheel TimingWheel.
+  * @return Timer or NULL if the timing wheel is empty.
+  */
+struct Timer* timingWheelGetAnyTimer(struct TimingWheel* timingWheel);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,274 @@
+/* --------------------------------------------------------------------------
+ *
+ *              //===//   //=====   //===//   //       //   //===//
+ *             //    //  //        //    //  //       //   //    //
+ *            //===//   //=====   //===//   //       //   //===<<
+ *           //   \\         //  //        //       //   //    //
+ *          //     \\  =====//  //        //=====  //   //===//   Version III
+ *
+ * ------------- An Efficient RSerPool Prototype Implementation -------------
+ *
+ * Copyright (C) 2002-2026 by Thomas Dreibholz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact: thomas.dreibholz@gmail.com
+ */
+
+#include "tdtypes.h"
+#include "poolhandlespacemanagement.h"
+#include "rserpool-policytypes.h"
+#include "timeutilities.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+   Reference: the round counter based WeightedRoundRobin implementation,
+   which has been replaced by stride scheduling. Its per-PE state is kept
+   in a wrapper around the PoolElementNode, which must be its first member.
+*/
+struct RoundCounterPoolElementNode
+{
+   struct ST_CLASS(PoolElementNode) Node;
+   PoolElementSeqNumberType         RoundCounter;
+   unsigned int                     VirtualCounter;
+};
+
+#define getRoundCounterPoolElementNode(poolElementNode) \
+   ((struct RoundCounterPoolElementNode*)(poolElementNode))
+
+
+/* ###### Sorting Order ################################################## */
+static int roundCounterComparison(
+   const struct ST_CLASS(PoolElementNode)* poolElementNode1,
+   const struct ST_CLASS(PoolElementNode)* poolElementNode2)
+{
+   const struct RoundCounterPoolElementNode* node1 =
+      (const struct RoundCounterPoolElementNode*)poolElementNode1;
+   const struct RoundCounterPoolElementNode* node2 =
+      (const struct RoundCounterPoolElementNode*)poolElementNode2;
+
+   if(node1->RoundCounter < node2->RoundCounter) {
+      return(-1);
+   }
+   else if(node1->RoundCounter > node2->RoundCounter) {
+      return(1);
+   }
+   if(node1->VirtualCounter < node2->VirtualCounter) {
+      return(-1);
+   }
+   else if(node1->VirtualCounter > node2->VirtualCounter) {
+      return(1);
+   }
+   if(poolElementNode1->SeqNumber < poolElementNode2->SeqNumber) {
+      return(-1);
+   }
+   else if(poolElementNode1->SeqNumber > poolElementNode2->SeqNumber) {
+      return(1);
+   }
+   return(0);
+}
+
+
+/* ###### Get current round counter ###################################### */
+static PoolElementSeqNumberType roundCounterGetCurrentRoundCounter(
+                                   struct ST_CLASS(PoolNode)* poolNode)
+{
+   struct ST_CLASS(PoolElementNode)* poolElementNode =
+      ST_CLASS(poolNodeGetFirstPoolElementNodeFromSelection)(poolNode);
+   if(poolElementNode) {
+      return(getRoundCounterPoolElementNode(poolElementNode)->RoundCounter);
+   }
+   return(SeqNumberStart);
+}
+
+
+/* ###### Initialize ##################################################### */
+static void roundCounterInitializePoolElementNode(
+               struct ST_CLASS(PoolElementNode)* poolElementNode)
+{
+   struct RoundCounterPoolElementNode* node =
+      getRoundCounterPoolElementNode(poolElementNode);
+
+   node->RoundCounter   = roundCounterGetCurrentRoundCounter(
+                             poolElementNode->OwnerPoolNode);
+   node->VirtualCounter = poolElementNode->PolicySettings.Weight;
+}
+
+
+/* ###### Update ######################################################### */
+static void roundCounterUpdatePoolElementNode(
+               struct ST_CLASS(PoolElementNode)* poolElementNode)
+{
+   struct RoundCounterPoolElementNode* node =
+      getRoundCounterPoolElementNode(poolElementNode);
+
+   if(node->VirtualCounter > 1) {
+      node->VirtualCounter--;
+   }
+   else {
+      node->RoundCounter++;
+      node->VirtualCounter = poolElementNode->PolicySettings.Weight;
+   }
+}
+
+
+/* ###### Prepare selection on pool ###################################### */
+static void roundCounterPrepareSelection(struct ST_CLASS(PoolNode)* poolNode)
+{
+   struct ST_CLASS(PoolElementNode)* poolElementNode;
+   const PoolElementSeqNumberType    currentRoundCounter =
+      roundCounterGetCurrentRoundCounter(poolNode);
+
+   /* Reset all round counters to lowest possible values */
+   if((PoolElementSeqNumberType)(currentRoundCounter + 2) < currentRoundCounter) {
+      poolElementNode = ST_CLASS(poolNodeGetFirstPoolElementNodeFromSelection)(poolNode);
+      while(poolElementNode != NULL) {
+         getRoundCounterPoolElementNode(poolElementNode)->RoundCounter -= currentRoundCounter;
+         poolElementNode = ST_CLASS(poolNodeGetNextPoolElementNodeFromSelection)(poolNode, poolElementNode);
+      }
+   }
+}
+
+
+static const struct ST_CLASS(PoolPolicy) RoundCounterPolicy = {
+   PPT_WEIGHTED_ROUNDROBIN, "WeightedRoundRobin",
+   0,
+   1,
+   &roundCounterComparison,
+   &ST_CLASS(poolPolicySelectPoolElementNodesBySortingOrder),
+   &roundCounterInitializePoolElementNode,
+   &roundCounterUpdatePoolElementNode,
+   &roundCounterPrepareSelection
+};
+
+
+/* ###### Run one benchmark ############################################## */
+static void runBenchmark(const struct ST_CLASS(PoolPolicy)* poolPolicy,
+                         const char*                        policyName,
+                         const size_t                       poolElements,
+                         const unsigned int                 selections)
+{
+   char                                 transportAddressBlockBuffer[transportAddressBlockGetSize(1)];
+   struct TransportAddressBlock*        transportAddressBlock = (struct TransportAddressBlock*)&transportAddressBlockBuffer;
+   union sockaddr_union                 address;
+   struct PoolHandle                    poolHandle;
+   struct PoolPolicySettings            poolPolicySettings;
+   struct ST_CLASS(PoolNode)            poolNode;
+   struct RoundCounterPoolElementNode*  poolElementNodeArray;
+   struct ST_CLASS(PoolElementNode)*    selectedPoolElementNode;
+   unsigned long long                   weightSum;
+   unsigned long long                   start;
+   unsigned long long                   now;
+   unsigned long long                   last;
+   unsigned long long                   maxDuration;
+   double                               deviation;
+   unsigned int                         errorCode;
+   unsigned int                         i;
+   size_t                               j;
+
+   poolElementNodeArray = (struct RoundCounterPoolElementNode*)calloc(
+                             poolElements, sizeof(struct RoundCounterPoolElementNode));
+   if(poolElementNodeArray == NULL) {
+      fputs("ERROR: Out of memory!\n", stderr);
+      exit(1);
+   }
+
+   memset(&address, 0, sizeof(address));
+   address.in.sin_family      = AF_INET;
+   address.in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   transportAddressBlockNew(transportAddressBlock, IPPROTO_SCTP, 1234, 0, &address, 1, 1);
+   poolHandleNew(&poolHandle, (const unsigned char*)"BenchmarkPool", 13);
+   ST_CLASS(poolNodeNew)(&poolNode, &poolHandle, poolPolicy, IPPROTO_SCTP, 0);
+
+   /* ====== Create pool with weights 1 to 16 ============================ */
+   srandom(1);
+   weightSum = 0;
+   for(j = 0;j < poolElements;j++) {
+      poolPolicySettingsNew(&poolPolicySettings);
+      poolPolicySettings.PolicyType = PPT_WEIGHTED_ROUNDROBIN;
+      poolPolicySettings.Weight     = 1 + (unsigned int)(random() % 16);
+      weightSum += poolPolicySettings.Weight;
+      ST_CLASS(poolElementNodeNew)(&poolElementNodeArray[j].Node,
+                                   (PoolElementIdentifierType)(j + 1),
+                                   UNDEFINED_REGISTRAR_IDENTIFIER, 60000,
+                                   &poolPolicySettings,
+                                   transportAddressBlock, NULL, -1, 0);
+      ST_CLASS(poolNodeAddPoolElementNode)(&poolNode, &poolElementNodeArray[j].Node, &errorCode);
+      CHECK(errorCode == RSPERR_OKAY);
+   }
+
+   /* ====== Select PEs ================================================== */
+   maxDuration = 0;
+   start       = getMicroTime();
+   last        = start;
+   for(i = 0;i < selections;i++) {
+      poolPolicy->SelectionFunction(&poolNode, &selectedPoolElementNode, 1, 1);
+      now = getMicroTime();
+      if(now - last > maxDuration) {
+         maxDuration = now - last;
+      }
+      last = now;
+   }
+
+   /* ====== Deviation of the selection shares from the weight shares ==== */
+   deviation = 0.0;
+   for(j = 0;j < poolElements;j++) {
+      deviation += fabs((double)poolElementNodeArray[j].Node.SelectionCounter / selections -
+                        (double)poolElementNodeArray[j].Node.PolicySettings.Weight / weightSum);
+   }
+
+   printf("policy=%-12s poolElements=%-7u  %8.1f ns/selection  max=%6llu us  deviation=%1.6f\n",
+          policyName, (unsigned int)poolElements,
+          (1000.0 * (last - start)) / selections, maxDuration, deviation / 2.0);
+
+   for(j = 0;j < poolElements;j++) {
+      ST_CLASS(poolNodeRemovePoolElementNode)(&poolNode, &poolElementNodeArray[j].Node);
+      ST_CLASS(poolElementNodeDelete)(&poolElementNodeArray[j].Node);
+   }
+   ST_CLASS(poolNodeDelete)(&poolNode);
+   free(poolElementNodeArray);
+}
+
+
+/* ###### Main program ################################################### */
+int main(int argc, char** argv)
+{
+   const size_t sizes[]    = { 10, 100, 1000, 10000, 100000 };
+   unsigned int selections = 1000000;
+   size_t       i;
+
+   for(i = 1;i < (size_t)argc;i++) {
+      if(!(strncmp(argv[i], "-selections=", 12))) {
+         selections = (unsigned int)atol((const char*)&argv[i][12]);
+         if(selections < 1) {
+            selections = 1;
+         }
+      }
+      else {
+         fprintf(stderr, "Usage: %s {-selections=Selections}\n", argv[0]);
+         exit(1);
+      }
+   }
+
+   for(i = 0;i < sizeof(sizes) / sizeof(sizes[0]);i++) {
+      runBenchmark(&RoundCounterPolicy,
+                   "RoundCounter", sizes[i], selections);
+      runBenchmark(ST_CLASS(poolPolicyGetPoolPolicyByType)(PPT_WEIGHTED_ROUNDROBIN),
+                   "Stride", sizes[i], selections);
+   }
+   return(0);
+}